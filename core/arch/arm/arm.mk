@@ -68,6 +68,16 @@ endif
 # 'y' to set the Alignment Check Enable bit in SCTLR/SCTLR_EL1, 'n' to clear it
 CFG_SCTLR_ALIGNMENT_CHECK ?= y
 
+# 'y' to use the assembly versions of memcpy(), memmove(), memset(),
+# memcmp() and strlen() in libutils, for the core and for user space. They
+# only use general purpose registers since the core doesn't save the
+# floating point registers, and only make aligned accesses. With KASan the
+# C versions are used so that the accesses are instrumented.
+CFG_ARM_STRING_ASM ?= y
+ifeq ($(CFG_CORE_SANITIZE_KADDRESS),y)
+$(call force,CFG_ARM_STRING_ASM,n,Not instrumented by CFG_CORE_SANITIZE_KADDRESS)
+endif
+
 ifeq ($(CFG_CORE_LARGE_PHYS_ADDR),y)
 $(call force,CFG_WITH_LPAE,y)
 endif
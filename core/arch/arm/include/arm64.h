@@ -25,6 +25,9 @@
 
 #define CSSELR_LEVEL_SHIFT	1
 
+#define DCZID_BS_MASK		0xf
+#define DCZID_DZP		BIT32(4)
+
 #define DAIFBIT_FIQ			BIT32(0)
 #define DAIFBIT_IRQ			BIT32(1)
 #define DAIFBIT_ABT			BIT32(2)
@@ -122,6 +125,18 @@
 /* Inner Shareable */
 #define TCR_SHX_ISH		0x3
 
+#define PMCR_E			BIT32(0)
+#define PMCR_N_SHIFT		11
+#define PMCR_N_MASK		0x1f
+
+#define PMEVTYPER_P		BIT32(31)
+#define PMEVTYPER_U		BIT32(30)
+#define PMEVTYPER_NSK		BIT32(29)
+#define PMEVTYPER_NSU		BIT32(28)
+#define PMEVTYPER_NSH		BIT32(27)
+#define PMEVTYPER_M		BIT32(26)
+#define PMEVTYPER_EVT_MASK	0xffff
+
 #define ESR_EC_SHIFT		26
 #define ESR_EC_MASK		0x3f
 
@@ -346,6 +361,20 @@ DEFINE_U64_REG_READ_FUNC(par_el1)
 
 DEFINE_U64_REG_WRITE_FUNC(mair_el1)
 
+DEFINE_U64_REG_READ_FUNC(elr_el1)
+DEFINE_U32_REG_READ_FUNC(spsr_el1)
+
+/* Performance Monitors registers */
+DEFINE_U32_REG_READWRITE_FUNCS(pmcr_el0)
+DEFINE_U32_REG_WRITE_FUNC(pmcntenset_el0)
+DEFINE_U32_REG_WRITE_FUNC(pmcntenclr_el0)
+DEFINE_U32_REG_WRITE_FUNC(pmintenset_el1)
+DEFINE_U32_REG_WRITE_FUNC(pmintenclr_el1)
+DEFINE_U32_REG_READWRITE_FUNCS(pmovsclr_el0)
+DEFINE_U32_REG_WRITE_FUNC(pmselr_el0)
+DEFINE_U32_REG_WRITE_FUNC(pmxevtyper_el0)
+DEFINE_U32_REG_WRITE_FUNC(pmxevcntr_el0)
+
 /* Register read/write functions for GICC registers by using system interface */
 DEFINE_REG_READ_FUNC_(icc_ctlr, uint32_t, S3_0_C12_C12_4)
 DEFINE_REG_WRITE_FUNC_(icc_ctlr, uint32_t, S3_0_C12_C12_4)
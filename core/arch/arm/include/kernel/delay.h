@@ -42,6 +42,14 @@ static inline uint64_t arm_cnt_us2cnt(uint32_t us)
 	return ((uint64_t)us * (uint64_t)read_cntfrq()) / 1000000ULL;
 }
 
+/* Convert counter ticks to microseconds without overflowing the product */
+static inline uint64_t arm_cnt_cnt2us(uint64_t cnt)
+{
+	uint32_t freq = read_cntfrq();
+
+	return cnt / freq * 1000000ULL + cnt % freq * 1000000ULL / freq;
+}
+
 static inline uint64_t timeout_init_us(uint32_t us)
 {
 	return read_cntpct() + arm_cnt_us2cnt(us);
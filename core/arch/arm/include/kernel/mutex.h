@@ -7,12 +7,16 @@
 
 #include <types_ext.h>
 #include <sys/queue.h>
+#include <kernel/lock_prof.h>
 #include <kernel/wait_queue.h>
 
 struct mutex {
 	unsigned spin_lock;	/* used when operating on this struct */
 	struct wait_queue wq;
 	short state;		/* -1: write, 0: unlocked, > 0: readers */
+#ifdef CFG_LOCK_PROF
+	struct lock_prof_hold prof;	/* write lock holder */
+#endif
 };
 #define MUTEX_INITIALIZER { .wq = WAIT_QUEUE_INITIALIZER }
 
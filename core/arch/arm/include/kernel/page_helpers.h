@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __KERNEL_PAGE_HELPERS_H
+#define __KERNEL_PAGE_HELPERS_H
+
+#include <mm/core_mmu.h>
+#include <string.h>
+#include <types_ext.h>
+
+/*
+ * clear_page() - zeroes the SMALL_PAGE_SIZE page at @va
+ * copy_page() - copies the SMALL_PAGE_SIZE page at @src to @dst
+ *
+ * The pages must be page aligned and mapped as normal cacheable memory.
+ * On AArch64 clear_page() uses DC ZVA, which zeroes a whole cache line
+ * without reading it first, and copy_page() reads the source with
+ * non-temporal loads since it's usually a backing store which isn't
+ * accessed again soon.
+ */
+#ifdef ARM64
+void clear_page(void *va);
+void copy_page(void *dst, const void *src);
+#else
+static inline void clear_page(void *va)
+{
+	memset(va, 0, SMALL_PAGE_SIZE);
+}
+
+static inline void copy_page(void *dst, const void *src)
+{
+	memcpy(dst, src, SMALL_PAGE_SIZE);
+}
+#endif
+
+#endif /*__KERNEL_PAGE_HELPERS_H*/
@@ -17,12 +17,21 @@
 				TA_FLAG_MULTI_SESSION | \
 				TA_FLAG_INSTANCE_KEEP_ALIVE)
 
+#define PTA_DEFAULT_FLAGS	PTA_MANDATORY_FLAGS
+
+/*
+ * Pseudo TA flag: the commands don't depend on the session nor on the
+ * calling context. The commands are invoked without a session context,
+ * without serializing them and without setting the current session.
+ * Such pseudo TAs can't have open and close session entry points.
+ */
+#define PTA_FLAG_STATELESS	BIT32(31)
+
 #define PTA_ALLOWED_FLAGS	(PTA_MANDATORY_FLAGS | \
 				 TA_FLAG_SECURE_DATA_PATH | \
 				 TA_FLAG_CONCURRENT | \
-				 TA_FLAG_DEVICE_ENUM)
-
-#define PTA_DEFAULT_FLAGS	PTA_MANDATORY_FLAGS
+				 TA_FLAG_DEVICE_ENUM | \
+				 PTA_FLAG_STATELESS)
 
 struct pseudo_ta_head {
 	TEE_UUID uuid;
@@ -38,6 +47,15 @@ struct pseudo_ta_head {
 	TEE_Result (*invoke_command_entry_point)(void *pSessionContext,
 			uint32_t nCommandID, uint32_t nParamTypes,
 			TEE_Param pParams[TEE_NUM_PARAMS]);
+	/*
+	 * Optional, stateless pseudo TAs only: invoked by normal world with
+	 * OPTEE_SMC_CALL_PTA_FAST. It runs in the fast call handler, with
+	 * all exceptions masked, and must not sleep. The parameters are
+	 * TEE_PARAM_TYPES(VALUE_INOUT, VALUE_INOUT, NONE, NONE).
+	 */
+	TEE_Result (*fast_invoke_entry_point)(uint32_t nCommandID,
+			uint32_t nParamTypes,
+			TEE_Param pParams[TEE_NUM_PARAMS]);
 };
 
 #define pseudo_ta_register(...)	\
@@ -57,8 +75,37 @@ static inline struct pseudo_ta_ctx *to_pseudo_ta_ctx(struct tee_ta_ctx *ctx)
 	return container_of(ctx, struct pseudo_ta_ctx, ctx);
 }
 
+static inline bool is_stateless_pseudo_ta_ctx(struct tee_ta_ctx *ctx)
+{
+	return is_pseudo_ta_ctx(ctx) &&
+	       (to_pseudo_ta_ctx(ctx)->pseudo_ta->flags & PTA_FLAG_STATELESS);
+}
+
 TEE_Result tee_ta_init_pseudo_ta_session(const TEE_UUID *uuid,
 			struct tee_ta_session *s);
 
+/*
+ * Invokes a command of a stateless pseudo TA, without the bookkeeping of
+ * tee_ta_invoke_command().
+ */
+TEE_Result pseudo_ta_invoke_stateless(struct tee_ta_session *s, uint32_t cmd,
+				      struct tee_ta_param *param,
+				      TEE_ErrorOrigin *eo);
+
+#ifdef CFG_PTA_FAST_INVOKE
+/*
+ * Returns in @handle the handle to pass to pseudo_ta_fast_invoke() for
+ * the pseudo TA @uuid. Returns TEE_ERROR_ITEM_NOT_FOUND if there's no
+ * such pseudo TA or if it has no fast invoke entry point.
+ */
+TEE_Result pseudo_ta_get_fast_handle(const TEE_UUID *uuid, uint32_t *handle);
+/*
+ * Invokes the fast invoke entry point of the pseudo TA @handle with two
+ * VALUE_INOUT parameters, @val[0] and @val[1] being the first one.
+ */
+TEE_Result pseudo_ta_fast_invoke(uint32_t handle, uint32_t cmd,
+				 uint32_t val[4]);
+#endif
+
 #endif /* KERNEL_PSEUDO_TA_H */
 
@@ -14,6 +14,7 @@
 #include <assert.h>
 #include <compiler.h>
 #include <stdbool.h>
+#include <kernel/lock_prof.h>
 #include <kernel/thread.h>
 
 #ifdef CFG_TEE_CORE_DEBUG
@@ -42,7 +43,7 @@ static inline void cpu_spin_lock_no_dldetect(unsigned int *lock)
 	spinlock_count_incr();
 }
 
-#ifdef CFG_TEE_CORE_DEBUG
+#if defined(CFG_TEE_CORE_DEBUG) || defined(CFG_LOCK_PROF)
 #define cpu_spin_lock(lock) \
 	cpu_spin_lock_dldetect(__func__, __LINE__, lock)
 
@@ -51,10 +52,13 @@ static inline void cpu_spin_lock_dldetect(const char *func, const int line,
 {
 	unsigned int retries = 0;
 	unsigned int reminder = 0;
+	uint64_t wait_begin = 0;
 
 	assert(thread_foreign_intr_disabled());
 
 	while (__cpu_spin_trylock(lock)) {
+		if (!wait_begin)
+			wait_begin = lock_prof_now();
 		retries++;
 		if (!retries) {
 			/* wrapped, time to report */
@@ -66,6 +70,9 @@ static inline void cpu_spin_lock_dldetect(const char *func, const int line,
 		}
 	}
 
+	if (wait_begin)
+		lock_prof_spin_contended(lock, func, line, wait_begin);
+
 	spinlock_count_incr();
 }
 #else
@@ -103,7 +110,7 @@ static inline uint32_t cpu_spin_lock_xsave_no_dldetect(unsigned int *lock)
 }
 
 
-#ifdef CFG_TEE_CORE_DEBUG
+#if defined(CFG_TEE_CORE_DEBUG) || defined(CFG_LOCK_PROF)
 #define cpu_spin_lock_xsave(lock) \
 	cpu_spin_lock_xsave_dldetect(__func__, __LINE__, lock)
 
@@ -435,6 +435,23 @@ static inline void thread_user_save_vfp(void)
 }
 #endif
 
+/*
+ * thread_user_restore_vfp() - Enables vfp again before returning to user mode
+ * @uvfp:	pointer to the vfp state of the user mode context
+ *
+ * Only done if the user vfp state saved by thread_user_save_vfp() is still
+ * in the registers, else vfp is enabled by the next vfp trap. Must be
+ * called with foreign interrupts masked.
+ */
+#ifdef CFG_WITH_VFP
+void thread_user_restore_vfp(struct thread_user_vfp_state *uvfp);
+#else
+static inline void thread_user_restore_vfp(
+			struct thread_user_vfp_state *uvfp __unused)
+{
+}
+#endif
+
 /*
  * thread_user_clear_vfp() - Clears the vfp state
  * @uvfp:	pointer to saved state to clear
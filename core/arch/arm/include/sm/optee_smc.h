@@ -256,7 +256,9 @@
  * Normal return register usage:
  * a0	OPTEE_SMC_RETURN_OK
  * a1	bitfield of secure world capabilities OPTEE_SMC_SEC_CAP_*
- * a2-7	Preserved
+ * a2	The maximum value of asynchronous notifications if
+ *	OPTEE_SMC_SEC_CAP_ASYNC_NOTIF is set, else preserved
+ * a3-7	Preserved
  *
  * Error return register usage:
  * a0	OPTEE_SMC_RETURN_ENOTAVAIL, can't use the capabilities from normal world
@@ -276,6 +278,16 @@
 #define OPTEE_SMC_SEC_CAP_DYNAMIC_SHM		(1 << 2)
 /* Secure world is built with virtualization support */
 #define OPTEE_SMC_SEC_CAP_VIRTUALIZATION	(1 << 3)
+/* Secure world supports asynchronous notifications to normal world */
+#define OPTEE_SMC_SEC_CAP_ASYNC_NOTIF		(1 << 5)
+/*
+ * Capabilities from bit 24 are specific to this implementation, upstream
+ * OP-TEE doesn't assign them.
+ */
+/* Secure world supports OPTEE_MSG_CMD_INVOKE_BATCH */
+#define OPTEE_SMC_SEC_CAP_INVOKE_BATCH		(1 << 24)
+/* Secure world supports OPTEE_SMC_GET_PTA_HANDLE and OPTEE_SMC_CALL_PTA_FAST */
+#define OPTEE_SMC_SEC_CAP_PTA_FAST_CALL		(1 << 25)
 
 
 #define OPTEE_SMC_FUNCID_EXCHANGE_CAPABILITIES	9
@@ -449,6 +461,130 @@
 #define OPTEE_SMC_GET_THREAD_COUNT \
 	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_GET_THREAD_COUNT)
 
+/*
+ * Enable asynchronous notifications
+ *
+ * Normal world issues this call once it's ready to handle the interrupt
+ * signalling asynchronous notifications. Until then, and for values above
+ * the maximum returned by OPTEE_SMC_EXCHANGE_CAPABILITIES, secure world
+ * sends notifications with OPTEE_RPC_CMD_WAIT_QUEUE wake-ups.
+ *
+ * Call requests usage:
+ * a0	SMC Function ID, OPTEE_SMC_ENABLE_ASYNC_NOTIF
+ * a1-6	Not used
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1-7	Preserved
+ *
+ * Not supported return register usage:
+ * a0	OPTEE_SMC_RETURN_ENOTAVAIL
+ * a1-7	Preserved
+ */
+#define OPTEE_SMC_FUNCID_ENABLE_ASYNC_NOTIF	16
+#define OPTEE_SMC_ENABLE_ASYNC_NOTIF \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_ENABLE_ASYNC_NOTIF)
+
+/*
+ * Retrieve a value of notifications pending since the last call of this
+ * function.
+ *
+ * Normal world issues this call when the interrupt signalling
+ * asynchronous notifications is raised, until no value is pending. A
+ * value is a wait queue key and is handled as an OPTEE_RPC_CMD_WAIT_QUEUE
+ * wake-up of that key, except for value 0 which asks normal world to
+ * issue OPTEE_MSG_CMD_DO_BOTTOM_HALF.
+ *
+ * Call requests usage:
+ * a0	SMC Function ID, OPTEE_SMC_GET_ASYNC_NOTIF_VALUE
+ * a1-6	Not used
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1	value
+ * a2	Bit[0]: OPTEE_SMC_ASYNC_NOTIF_VALUE_VALID if the value in a1 is
+ *		valid, else 0 if no values were pending
+ *	Bit[1]: OPTEE_SMC_ASYNC_NOTIF_VALUE_PENDING if another value is
+ *		pending, else 0
+ *	Bit[31:2]: MBZ
+ * a3-7	Preserved
+ *
+ * Not supported return register usage:
+ * a0	OPTEE_SMC_RETURN_ENOTAVAIL
+ * a1-7	Preserved
+ */
+#define OPTEE_SMC_ASYNC_NOTIF_VALUE_VALID	(1 << 0)
+#define OPTEE_SMC_ASYNC_NOTIF_VALUE_PENDING	(1 << 1)
+
+#define OPTEE_SMC_FUNCID_GET_ASYNC_NOTIF_VALUE	17
+#define OPTEE_SMC_GET_ASYNC_NOTIF_VALUE \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_GET_ASYNC_NOTIF_VALUE)
+
+/*
+ * Function IDs from 0x1000 are specific to this implementation, upstream
+ * OP-TEE doesn't assign them.
+ */
+
+/*
+ * Get the handle of a pseudo TA invoked with OPTEE_SMC_CALL_PTA_FAST
+ *
+ * Only stateless pseudo TAs with a fast invoke entry point have a
+ * handle. A handle remains valid until OP-TEE is restarted.
+ *
+ * Call requests usage:
+ * a0	SMC Function ID, OPTEE_SMC_GET_PTA_HANDLE
+ * a1-4	UUID of the pseudo TA, octets 0-3 in a1 down to octets 12-15 in a4,
+ *	the first octet in the most significant byte of the register
+ * a5-6	Not used
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1	Handle of the pseudo TA
+ * a2-7	Preserved
+ *
+ * Not supported return register usage:
+ * a0	OPTEE_SMC_RETURN_ENOTAVAIL, no such pseudo TA or it can't be invoked
+ *	with OPTEE_SMC_CALL_PTA_FAST
+ * a1-7	Preserved
+ */
+#define OPTEE_SMC_FUNCID_GET_PTA_HANDLE	0x1000
+#define OPTEE_SMC_GET_PTA_HANDLE \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_GET_PTA_HANDLE)
+
+/*
+ * Invoke a command of a pseudo TA without allocating a thread
+ *
+ * The command is invoked without a session, with the login
+ * TEE_LOGIN_PUBLIC, and with two parameters of type
+ * TEE_PARAM_TYPE_VALUE_INOUT. The command must not need to wait for
+ * anything, it's meant for counters and similar queries.
+ *
+ * Call requests usage:
+ * a0	SMC Function ID, OPTEE_SMC_CALL_PTA_FAST
+ * a1	Handle of the pseudo TA, from OPTEE_SMC_GET_PTA_HANDLE
+ * a2	Command ID
+ * a3-4	Value a and b of the first parameter
+ * a5-6	Value a and b of the second parameter
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1	TEE_Result of the command, origin TEE_ORIGIN_TRUSTED_APP
+ * a2-3	Updated value a and b of the first parameter
+ * a4-5	Updated value a and b of the second parameter
+ * a6-7	Preserved
+ *
+ * Error return register usage:
+ * a0	OPTEE_SMC_RETURN_EBADCMD, invalid handle
+ * a1-7	Preserved
+ */
+#define OPTEE_SMC_FUNCID_CALL_PTA_FAST	0x1001
+#define OPTEE_SMC_CALL_PTA_FAST \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_CALL_PTA_FAST)
+
 /*
  * Resume from RPC (for example after processing a foreign interrupt)
  *
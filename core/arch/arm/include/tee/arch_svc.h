@@ -5,7 +5,10 @@
 #ifndef TEE_ARCH_SVC_H
 #define TEE_ARCH_SVC_H
 
+#include <compiler.h>
+
 struct thread_svc_regs;
+struct tee_ta_session;
 
 /* Registered as .handle_svc in struct tee_ta_ops for user TAs. */
 bool user_ta_handle_svc(struct thread_svc_regs *regs);
@@ -20,4 +23,14 @@ uint32_t tee_svc_sys_return_helper(uint32_t ret, bool panic,
 				   uint32_t panic_code,
 				   struct thread_svc_regs *regs);
 
+#ifdef CFG_TA_SYSCALL_PROF
+/* Sends the syscall profile of a session to normal world, as ftrace does */
+void user_ta_dump_syscall_prof(struct tee_ta_session *s);
+#else
+static inline void
+user_ta_dump_syscall_prof(struct tee_ta_session *s __unused)
+{
+}
+#endif
+
 #endif /*TEE_ARCH_SVC_H*/
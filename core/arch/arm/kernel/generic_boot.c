@@ -12,6 +12,7 @@
 #include <inttypes.h>
 #include <keep.h>
 #include <kernel/asan.h>
+#include <kernel/boot_prof.h>
 #include <kernel/generic_boot.h>
 #include <kernel/linker.h>
 #include <kernel/misc.h>
@@ -398,6 +399,7 @@ static void init_runtime(unsigned long pageable_part)
 	struct fobj *fobj = NULL;
 	uint8_t *paged_store = NULL;
 	uint8_t *hashes = NULL;
+	uint64_t begin = 0;
 
 	assert(pageable_size % SMALL_PAGE_SIZE == 0);
 	assert(embdata->total_len >= embdata->hashes_offset +
@@ -408,8 +410,12 @@ static void init_runtime(unsigned long pageable_part)
 
 	init_asan();
 
+	begin = boot_prof_begin();
 	malloc_add_pool(__heap1_start, __heap1_end - __heap1_start);
 	malloc_add_pool(__heap2_start, __heap2_end - __heap2_start);
+	boot_prof_end("heap", BOOT_PROF_PHASE, begin);
+
+	begin = boot_prof_begin();
 
 	/*
 	 * This needs to be initialized early to support address lookup
@@ -529,13 +535,18 @@ static void init_runtime(unsigned long pageable_part)
 			true);
 
 	print_pager_pool_size();
+	boot_prof_end("pager", BOOT_PROF_PHASE, begin);
 }
 #else
 
 static void init_runtime(unsigned long pageable_part __unused)
 {
+	uint64_t begin = 0;
+
 	init_asan();
 
+	begin = boot_prof_begin();
+
 	/*
 	 * By default whole OP-TEE uses malloc, so we need to initialize
 	 * it early. But, when virtualization is enabled, malloc is used
@@ -549,6 +560,7 @@ static void init_runtime(unsigned long pageable_part __unused)
 #else
 	malloc_add_pool(__heap1_start, __heap1_end - __heap1_start);
 #endif
+	boot_prof_end("heap", BOOT_PROF_PHASE, begin);
 
 	IMSG_RAW("\n");
 }
@@ -1140,6 +1152,8 @@ void init_tee_runtime(void)
 static void init_primary_helper(unsigned long pageable_part,
 				unsigned long nsec_entry, unsigned long fdt)
 {
+	uint64_t begin = 0;
+
 	/*
 	 * Mask asynchronous exceptions before switch to the thread vector
 	 * as the thread handler requires those to be masked while
@@ -1152,16 +1166,21 @@ static void init_primary_helper(unsigned long pageable_part,
 	init_vfp_sec();
 	init_runtime(pageable_part);
 
+	begin = boot_prof_begin();
 #ifndef CFG_VIRTUALIZATION
 	thread_init_boot_thread();
 #endif
 	thread_init_primary(generic_boot_get_handlers());
 	thread_init_per_cpu();
 	init_sec_mon(nsec_entry);
+	boot_prof_end("threads", BOOT_PROF_PHASE, begin);
+
+	begin = boot_prof_begin();
 	init_external_dt(fdt);
 	discover_nsec_memory();
 	update_external_dt();
 	configure_console_from_dt();
+	boot_prof_end("dt", BOOT_PROF_PHASE, begin);
 
 	IMSG("OP-TEE version: %s", core_v_str);
 #ifdef CFG_CORE_ASLR
@@ -1169,16 +1188,21 @@ static void init_primary_helper(unsigned long pageable_part,
 	     (unsigned long)boot_mmu_config.load_offset, VCORE_START_VA);
 #endif
 
+	begin = boot_prof_begin();
 	main_init_gic();
+	boot_prof_end("gic", BOOT_PROF_PHASE, begin);
 	init_vfp_nsec();
 #ifndef CFG_VIRTUALIZATION
+	begin = boot_prof_begin();
 	init_tee_runtime();
+	boot_prof_end("tee runtime", BOOT_PROF_PHASE, begin);
 #endif
 	release_external_dt();
 #ifdef CFG_VIRTUALIZATION
 	IMSG("Initializing virtualization support");
 	core_mmu_init_virtualization();
 #endif
+	boot_prof_print();
 	DMSG("Primary CPU switching to normal world boot");
 }
 
@@ -16,8 +16,39 @@ void mutex_init(struct mutex *m)
 	*m = (struct mutex)MUTEX_INITIALIZER;
 }
 
+#ifdef CFG_LOCK_PROF
+static void mutex_prof_acquired(struct mutex *m, bool read, const char *fname,
+				int lineno, uint64_t wait_begin)
+{
+	if (read)
+		lock_prof_acquired(NULL, m, LOCK_PROF_MUTEX_READ, fname, lineno,
+				   wait_begin);
+	else
+		lock_prof_acquired(&m->prof, m, LOCK_PROF_MUTEX, fname, lineno,
+				   wait_begin);
+}
+
+static void mutex_prof_released(struct mutex *m)
+{
+	lock_prof_released(&m->prof);
+}
+#else
+static void mutex_prof_acquired(struct mutex *m __unused, bool read __unused,
+				const char *fname __unused,
+				int lineno __unused,
+				uint64_t wait_begin __unused)
+{
+}
+
+static void mutex_prof_released(struct mutex *m __unused)
+{
+}
+#endif
+
 static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 {
+	uint64_t wait_begin = 0;
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != -1);
 	assert(thread_is_in_normal_mode());
@@ -54,9 +85,13 @@ static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 			 * Someone else is holding the lock, wait in normal
 			 * world for the lock to become available.
 			 */
+			if (!wait_begin)
+				wait_begin = lock_prof_now();
 			wq_wait_final(&m->wq, &wqe, m, fname, lineno);
-		} else
+		} else {
+			mutex_prof_acquired(m, false, fname, lineno, wait_begin);
 			return;
+		}
 	}
 }
 
@@ -68,6 +103,7 @@ static void __mutex_unlock(struct mutex *m, const char *fname, int lineno)
 	assert(thread_get_id_may_fail() != -1);
 
 	mutex_unlock_check(m);
+	mutex_prof_released(m);
 
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
@@ -81,8 +117,8 @@ static void __mutex_unlock(struct mutex *m, const char *fname, int lineno)
 	wq_wake_next(&m->wq, m, fname, lineno);
 }
 
-static bool __mutex_trylock(struct mutex *m, const char *fname __unused,
-			int lineno __unused)
+static bool __mutex_trylock(struct mutex *m, const char *fname __maybe_unused,
+			    int lineno __maybe_unused)
 {
 	uint32_t old_itr_status;
 	bool can_lock_write;
@@ -98,8 +134,10 @@ static bool __mutex_trylock(struct mutex *m, const char *fname __unused,
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-	if (can_lock_write)
+	if (can_lock_write) {
 		mutex_trylock_check(m);
+		mutex_prof_acquired(m, false, fname, lineno, 0);
+	}
 
 	return can_lock_write;
 }
@@ -128,6 +166,8 @@ static void __mutex_read_unlock(struct mutex *m, const char *fname, int lineno)
 
 static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 {
+	uint64_t wait_begin = 0;
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != -1);
 	assert(thread_is_in_normal_mode());
@@ -162,14 +202,19 @@ static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 			 * Someone else is holding the lock, wait in normal
 			 * world for the lock to become available.
 			 */
+			if (!wait_begin)
+				wait_begin = lock_prof_now();
 			wq_wait_final(&m->wq, &wqe, m, fname, lineno);
-		} else
+		} else {
+			mutex_prof_acquired(m, true, fname, lineno, wait_begin);
 			return;
+		}
 	}
 }
 
-static bool __mutex_read_trylock(struct mutex *m, const char *fname __unused,
-				 int lineno __unused)
+static bool __mutex_read_trylock(struct mutex *m,
+				 const char *fname __maybe_unused,
+				 int lineno __maybe_unused)
 {
 	uint32_t old_itr_status;
 	bool can_lock;
@@ -186,6 +231,9 @@ static bool __mutex_read_trylock(struct mutex *m, const char *fname __unused,
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
+	if (can_lock)
+		mutex_prof_acquired(m, true, fname, lineno, 0);
+
 	return can_lock;
 }
 
@@ -324,6 +372,7 @@ static void __condvar_wait(struct condvar *cv, struct mutex *m,
 	short new_state;
 
 	mutex_unlock_check(m);
+	mutex_prof_released(m);
 
 	/* Link this condvar to this mutex until reinitialized */
 	old_itr_status = cpu_spin_lock_xsave(&cv->spin_lock);
@@ -359,9 +408,9 @@ static void __condvar_wait(struct condvar *cv, struct mutex *m,
 	wq_wait_final(&m->wq, &wqe, m, fname, lineno);
 
 	if (old_state > 0)
-		mutex_read_lock(m);
+		__mutex_read_lock(m, fname, lineno);
 	else
-		mutex_lock(m);
+		__mutex_lock(m, fname, lineno);
 }
 
 #ifdef CFG_MUTEX_DEBUG
@@ -178,21 +178,19 @@ out:
 	return res;
 }
 
-static TEE_Result pseudo_ta_enter_invoke_cmd(struct tee_ta_session *s,
-			uint32_t cmd, struct tee_ta_param *param,
-			TEE_ErrorOrigin *eo)
+static TEE_Result invoke_cmd(struct tee_ta_session *s, uint32_t cmd,
+			     struct tee_ta_param *param, TEE_ErrorOrigin *eo)
 {
 	TEE_Result res;
 	struct pseudo_ta_ctx *stc = to_pseudo_ta_ctx(s->ctx);
 	TEE_Param tee_param[TEE_NUM_PARAMS];
 	bool did_map[TEE_NUM_PARAMS] = { false };
 
-	tee_ta_push_current_session(s);
 	res = copy_in_param(s, param, tee_param, did_map);
 	if (res != TEE_SUCCESS) {
 		unmap_mapped_param(param, did_map);
 		*eo = TEE_ORIGIN_TEE;
-		goto out;
+		return res;
 	}
 
 	*eo = TEE_ORIGIN_TRUSTED_APP;
@@ -201,11 +199,32 @@ static TEE_Result pseudo_ta_enter_invoke_cmd(struct tee_ta_session *s,
 							 tee_param);
 	update_out_param(tee_param, param);
 	unmap_mapped_param(param, did_map);
-out:
+
+	return res;
+}
+
+static TEE_Result pseudo_ta_enter_invoke_cmd(struct tee_ta_session *s,
+			uint32_t cmd, struct tee_ta_param *param,
+			TEE_ErrorOrigin *eo)
+{
+	TEE_Result res;
+
+	tee_ta_push_current_session(s);
+	res = invoke_cmd(s, cmd, param, eo);
 	tee_ta_pop_current_session();
+
 	return res;
 }
 
+TEE_Result pseudo_ta_invoke_stateless(struct tee_ta_session *s, uint32_t cmd,
+				      struct tee_ta_param *param,
+				      TEE_ErrorOrigin *eo)
+{
+	assert(is_stateless_pseudo_ta_ctx(s->ctx));
+
+	return invoke_cmd(s, cmd, param, eo);
+}
+
 static void pseudo_ta_enter_close_session(struct tee_ta_session *s)
 {
 	struct pseudo_ta_ctx *stc = to_pseudo_ta_ctx(s->ctx);
@@ -261,6 +280,15 @@ static TEE_Result verify_pseudo_tas_conformance(void)
 		    pta->flags & ~PTA_ALLOWED_FLAGS ||
 		    !pta->invoke_command_entry_point)
 			goto err;
+
+		if ((pta->flags & PTA_FLAG_STATELESS) &&
+		    (pta->open_session_entry_point ||
+		     pta->close_session_entry_point))
+			goto err;
+
+		if (pta->fast_invoke_entry_point &&
+		    !(pta->flags & PTA_FLAG_STATELESS))
+			goto err;
 	}
 	return TEE_SUCCESS;
 err:
@@ -270,6 +298,68 @@ err:
 
 service_init(verify_pseudo_tas_conformance);
 
+#ifdef CFG_PTA_FAST_INVOKE
+/*
+ * The handle of a pseudo TA is its index in the pseudo_tas array, which
+ * is used without locking since it's read only.
+ */
+TEE_Result pseudo_ta_get_fast_handle(const TEE_UUID *uuid, uint32_t *handle)
+{
+	const struct pseudo_ta_head *start =
+		SCATTERED_ARRAY_BEGIN(pseudo_tas, struct pseudo_ta_head);
+	const struct pseudo_ta_head *end =
+		SCATTERED_ARRAY_END(pseudo_tas, struct pseudo_ta_head);
+	const struct pseudo_ta_head *pta = NULL;
+
+	for (pta = start; pta < end; pta++) {
+		if (!memcmp(&pta->uuid, uuid, sizeof(TEE_UUID))) {
+			if (!pta->fast_invoke_entry_point)
+				break;
+			*handle = pta - start;
+			return TEE_SUCCESS;
+		}
+	}
+
+	return TEE_ERROR_ITEM_NOT_FOUND;
+}
+
+TEE_Result pseudo_ta_fast_invoke(uint32_t handle, uint32_t cmd,
+				 uint32_t val[4])
+{
+	const struct pseudo_ta_head *start =
+		SCATTERED_ARRAY_BEGIN(pseudo_tas, struct pseudo_ta_head);
+	const struct pseudo_ta_head *end =
+		SCATTERED_ARRAY_END(pseudo_tas, struct pseudo_ta_head);
+	uint32_t types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INOUT,
+					 TEE_PARAM_TYPE_VALUE_INOUT,
+					 TEE_PARAM_TYPE_NONE,
+					 TEE_PARAM_TYPE_NONE);
+	TEE_Param tee_param[TEE_NUM_PARAMS] = { };
+	const struct pseudo_ta_head *pta = NULL;
+	TEE_Result res = TEE_SUCCESS;
+
+	if (handle >= (size_t)(end - start))
+		return TEE_ERROR_ITEM_NOT_FOUND;
+	pta = start + handle;
+	if (!pta->fast_invoke_entry_point)
+		return TEE_ERROR_ITEM_NOT_FOUND;
+
+	tee_param[0].value.a = val[0];
+	tee_param[0].value.b = val[1];
+	tee_param[1].value.a = val[2];
+	tee_param[1].value.b = val[3];
+
+	res = pta->fast_invoke_entry_point(cmd, types, tee_param);
+
+	val[0] = tee_param[0].value.a;
+	val[1] = tee_param[0].value.b;
+	val[2] = tee_param[1].value.a;
+	val[3] = tee_param[1].value.b;
+
+	return res;
+}
+#endif /* CFG_PTA_FAST_INVOKE */
+
 /*-----------------------------------------------------------------------------
  * Initialises a session based on the UUID or ptr to the ta
  * Returns ptr to the session (ta_session) and a TEE_Result
@@ -20,6 +20,7 @@ srcs-$(CFG_ARM32_core) += tlb_helpers_a32.S
 srcs-$(CFG_ARM64_core) += tlb_helpers_a64.S
 srcs-$(CFG_ARM64_core) += cache_helpers_a64.S
 srcs-$(CFG_ARM32_core) += cache_helpers_a32.S
+srcs-$(CFG_ARM64_core) += page_helpers_a64.S
 srcs-$(CFG_PL310) += tz_ssvce_pl310_a32.S
 srcs-$(CFG_PL310) += tee_l2cc_mutex.c
 
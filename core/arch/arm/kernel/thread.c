@@ -19,6 +19,8 @@
 #include <kernel/tee_ta_manager.h>
 #include <kernel/thread_defs.h>
 #include <kernel/thread.h>
+#include <kernel/tracepoint.h>
+#include <kernel/user_mode_ctx.h>
 #include <kernel/virtualization.h>
 #include <mm/core_memprot.h>
 #include <mm/mobj.h>
@@ -427,6 +429,7 @@ void thread_alloc_and_run(uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
 		return;
 
 	l->curr_thread = n;
+	trace_thread_alloc(n, a0);
 
 	threads[n].flags = 0;
 	init_regs(threads + n, a0, a1, a2, a3);
@@ -645,6 +648,7 @@ void thread_state_free(void)
 
 	assert(ct != -1);
 
+	trace_thread_free(ct, 0);
 	thread_lazy_restore_ns_vfp();
 	tee_pager_release_phys(
 		(void *)(threads[ct].stack_va_end - STACK_THREAD_SIZE),
@@ -1191,6 +1195,26 @@ void thread_user_save_vfp(void)
 	tuv->lazy_saved = true;
 }
 
+void thread_user_restore_vfp(struct thread_user_vfp_state *uvfp)
+{
+	struct thread_ctx *thr = threads + thread_get_id();
+
+	assert(thread_get_exceptions() & THREAD_EXCP_FOREIGN_INTR);
+	assert(!vfp_is_enabled());
+
+	/*
+	 * If nothing has used VFP since thread_user_save_vfp() the
+	 * registers still hold the user state, it's enough to enable VFP
+	 * again. Otherwise the state has been saved and is restored when
+	 * user mode traps on the next VFP instruction.
+	 */
+	if (uvfp != thr->vfp_state.uvfp || !uvfp->lazy_saved || uvfp->saved)
+		return;
+
+	vfp_lazy_restore_state(&uvfp->vfp, false /*!full_state*/);
+	uvfp->lazy_saved = false;
+}
+
 void thread_user_clear_vfp(struct thread_user_vfp_state *uvfp)
 {
 	struct thread_ctx *thr = threads + thread_get_id();
@@ -1351,6 +1375,13 @@ static void setup_unwind_user_mode(struct thread_svc_regs *regs)
 #endif
 }
 
+static void restore_user_vfp(struct tee_ta_session *sess __maybe_unused)
+{
+#ifdef CFG_WITH_VFP
+	thread_user_restore_vfp(&to_user_mode_ctx(sess->ctx)->vfp);
+#endif
+}
+
 /*
  * Note: this function is weak just to make it possible to exclude it from
  * the unpaged area.
@@ -1377,6 +1408,13 @@ void __weak thread_svc_handler(struct thread_svc_regs *regs)
 	if (sess->ctx->ops->handle_svc(regs)) {
 		/* We're about to switch back to user mode */
 		tee_ta_update_session_utime_resume();
+		/*
+		 * Foreign interrupts are masked again when returning to
+		 * user mode, mask them already so the VFP state can't be
+		 * saved behind our back once it's enabled again.
+		 */
+		thread_mask_exceptions(THREAD_EXCP_FOREIGN_INTR);
+		restore_user_vfp(sess);
 	} else {
 		/* We're returning from __thread_enter_user_mode() */
 		setup_unwind_user_mode(regs);
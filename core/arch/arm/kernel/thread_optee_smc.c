@@ -8,7 +8,9 @@
 #include <io.h>
 #include <kernel/misc.h>
 #include <kernel/msg_param.h>
+#include <kernel/rpc_stats.h>
 #include <kernel/thread.h>
+#include <kernel/tracepoint.h>
 #include <kernel/virtualization.h>
 #include <mm/core_mmu.h>
 #include <optee_msg.h>
@@ -210,6 +212,7 @@ uint32_t __weak __thread_std_smc_entry(uint32_t a0, uint32_t a1, uint32_t a2,
 #ifdef CFG_VIRTUALIZATION
 	virt_on_stdcall();
 #endif
+	trace_smc_entry(a0, reg_pair_to_64(a1, a2));
 	rv = std_smc_entry(a0, a1, a2, a3);
 
 	if (rv == OPTEE_SMC_RETURN_OK) {
@@ -224,6 +227,8 @@ uint32_t __weak __thread_std_smc_entry(uint32_t a0, uint32_t a1, uint32_t a2,
 		}
 	}
 
+	trace_smc_exit(a0, rv);
+
 	return rv;
 }
 
@@ -476,6 +481,7 @@ uint32_t thread_rpc_cmd(uint32_t cmd, size_t num_params,
 	uint32_t rpc_args[THREAD_RPC_NUM_ARGS] = { OPTEE_SMC_RETURN_RPC_CMD };
 	void *arg = NULL;
 	uint64_t carg = 0;
+	uint64_t begin = 0;
 	uint32_t ret = 0;
 
 	/* The source CRYPTO_RNG_SRC_JITTER_RPC is safe to use here */
@@ -487,9 +493,14 @@ uint32_t thread_rpc_cmd(uint32_t cmd, size_t num_params,
 		return ret;
 
 	reg_pair_from_64(carg, rpc_args + 1, rpc_args + 2);
+	trace_rpc_out(cmd, num_params);
+	begin = rpc_stats_begin();
 	thread_rpc(rpc_args);
+	ret = get_rpc_arg_res(arg, num_params, params);
+	rpc_stats_add(cmd, begin, num_params, params);
+	trace_rpc_in(cmd, ret);
 
-	return get_rpc_arg_res(arg, num_params, params);
+	return ret;
 }
 
 /**
@@ -509,12 +520,15 @@ static void thread_rpc_free(unsigned int bt, uint64_t cookie, struct mobj *mobj)
 	struct thread_param param = THREAD_PARAM_VALUE(IN, bt, cookie, 0);
 	uint32_t ret = get_rpc_arg(OPTEE_RPC_CMD_SHM_FREE, 1, &param,
 				   &arg, &carg);
+	uint64_t begin = 0;
 
 	mobj_put(mobj);
 
 	if (!ret) {
 		reg_pair_from_64(carg, rpc_args + 1, rpc_args + 2);
+		begin = rpc_stats_begin();
 		thread_rpc(rpc_args);
+		rpc_stats_add(OPTEE_RPC_CMD_SHM_FREE, begin, 1, &param);
 	}
 }
 
@@ -570,12 +584,15 @@ static struct mobj *thread_rpc_alloc(size_t size, size_t align, unsigned int bt)
 	struct thread_param param = THREAD_PARAM_VALUE(IN, bt, size, align);
 	uint32_t ret = get_rpc_arg(OPTEE_RPC_CMD_SHM_ALLOC, 1, &param,
 				   &arg, &carg);
+	uint64_t begin = 0;
 
 	if (ret)
 		return NULL;
 
 	reg_pair_from_64(carg, rpc_args + 1, rpc_args + 2);
+	begin = rpc_stats_begin();
 	thread_rpc(rpc_args);
+	rpc_stats_add(OPTEE_RPC_CMD_SHM_ALLOC, begin, 1, &param);
 
 	return get_rpc_alloc_res(arg, bt);
 }
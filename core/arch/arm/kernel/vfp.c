@@ -29,7 +29,8 @@ void vfp_lazy_save_state_init(struct vfp_state *state)
 	uint32_t fpexc = vfp_read_fpexc();
 
 	state->fpexc = fpexc;
-	vfp_write_fpexc(fpexc & ~FPEXC_EN);
+	if (fpexc & FPEXC_EN)
+		vfp_write_fpexc(fpexc & ~FPEXC_EN);
 }
 
 void vfp_lazy_save_state_final(struct vfp_state *state, bool force_save)
@@ -59,6 +60,8 @@ void vfp_lazy_restore_state(struct vfp_state *state, bool full_state)
 
 		vfp_write_fpscr(state->fpscr);
 		vfp_restore_extension_regs(state->reg);
+	} else if (vfp_read_fpexc() == state->fpexc) {
+		return;
 	}
 	vfp_write_fpexc(state->fpexc);
 }
@@ -91,7 +94,8 @@ void vfp_disable(void)
 void vfp_lazy_save_state_init(struct vfp_state *state)
 {
 	state->cpacr_el1 = read_cpacr_el1();
-	vfp_disable();
+	if (vfp_is_enabled())
+		vfp_disable();
 }
 
 void vfp_lazy_save_state_final(struct vfp_state *state, bool force_save)
@@ -120,6 +124,9 @@ void vfp_lazy_restore_state(struct vfp_state *state, bool full_state)
 		write_fpcr(state->fpcr);
 		write_fpsr(state->fpsr);
 		vfp_restore_extension_regs(state->reg);
+	} else if (read_cpacr_el1() == state->cpacr_el1) {
+		/* Nothing changed, skip the write and the isb */
+		return;
 	}
 	write_cpacr_el1(state->cpacr_el1);
 	isb();
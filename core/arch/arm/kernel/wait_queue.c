@@ -3,8 +3,10 @@
  * Copyright (c) 2015-2016, Linaro Limited
  */
 #include <compiler.h>
+#include <kernel/notif.h>
 #include <kernel/spinlock.h>
 #include <kernel/thread.h>
+#include <kernel/tracepoint.h>
 #include <kernel/wait_queue.h>
 #include <optee_rpc_cmd.h>
 #include <string.h>
@@ -37,9 +39,13 @@ void __weak __wq_rpc(uint32_t func, int id, const void *sync_obj __maybe_unused,
 	else
 		DMSG("%s thread %u %p", cmd_str, id, sync_obj);
 
-	struct thread_param params = THREAD_PARAM_VALUE(IN, func, id, 0);
-
-	ret = thread_rpc_cmd(OPTEE_RPC_CMD_WAIT_QUEUE, 1, &params);
+	if (func == OPTEE_RPC_WAIT_QUEUE_SLEEP) {
+		trace_mutex_sleep((vaddr_t)sync_obj, id);
+		ret = notif_wait(id);
+	} else {
+		trace_mutex_wake((vaddr_t)sync_obj, id);
+		ret = notif_send(id);
+	}
 	if (ret != TEE_SUCCESS)
 		DMSG("%s thread %u ret 0x%x", cmd_str, id, ret);
 }
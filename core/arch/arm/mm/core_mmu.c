@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <bitstring.h>
 #include <config.h>
+#include <kernel/boot_prof.h>
 #include <kernel/cache_helpers.h>
 #include <kernel/generic_boot.h>
 #include <kernel/linker.h>
@@ -1215,6 +1216,7 @@ void core_init_mmu_map(unsigned long seed, struct core_mmu_config *cfg)
 #endif
 	vaddr_t len = ROUNDUP((vaddr_t)__nozi_end, SMALL_PAGE_SIZE) - start;
 	struct tee_mmap_region *tmp_mmap = get_tmp_mmap();
+	uint64_t begin = boot_prof_begin();
 	unsigned long offs = 0;
 
 	check_sec_nsec_mem_config();
@@ -1241,6 +1243,7 @@ void core_init_mmu_map(unsigned long seed, struct core_mmu_config *cfg)
 	core_init_mmu_regs(cfg);
 	cfg->load_offset = offs;
 	memcpy(static_memory_map, tmp_mmap, sizeof(static_memory_map));
+	boot_prof_mmu_setup(begin, boot_prof_begin());
 }
 
 bool core_mmu_mattr_is_ok(uint32_t mattr)
@@ -1528,6 +1531,36 @@ static void set_region(struct core_mmu_table_info *tbl_info,
 	}
 }
 
+/*
+ * Tells if the part of @region at @va, which is at a pgdir boundary, can be
+ * mapped with a single block entry in the directory, that is, if it spans
+ * the entire pgdir with physically contiguous memory aligned on a pgdir.
+ */
+static bool region_fits_pgdir_block(struct vm_region *region, vaddr_t va,
+				    paddr_t *pa)
+{
+	size_t offset = va - region->va + region->offset;
+	paddr_t p = 0;
+	size_t n = 0;
+
+	if (!(region->flags & VM_FLAG_SHAREABLE) ||
+	    mobj_is_paged(region->mobj))
+		return false;
+	if (region->va + region->size - va < CORE_MMU_PGDIR_SIZE)
+		return false;
+	if (mobj_get_pa(region->mobj, offset, SMALL_PAGE_SIZE, pa) ||
+	    (*pa & CORE_MMU_PGDIR_MASK))
+		return false;
+
+	for (n = SMALL_PAGE_SIZE; n < CORE_MMU_PGDIR_SIZE;
+	     n += SMALL_PAGE_SIZE)
+		if (mobj_get_pa(region->mobj, offset + n, SMALL_PAGE_SIZE,
+				&p) || p != *pa + n)
+			return false;
+
+	return true;
+}
+
 static void set_pg_region(struct core_mmu_table_info *dir_info,
 			struct vm_region *region, struct pgt **pgt,
 			struct core_mmu_table_info *pg_info)
@@ -1539,8 +1572,21 @@ static void set_pg_region(struct core_mmu_table_info *dir_info,
 	};
 	vaddr_t end = r.va + r.size;
 	uint32_t pgt_attr = (r.attr & TEE_MATTR_SECURE) | TEE_MATTR_TABLE;
+	paddr_t block_pa = 0;
 
 	while (r.va < end) {
+		if (!(r.va & CORE_MMU_PGDIR_MASK) &&
+		    region_fits_pgdir_block(region, r.va, &block_pa)) {
+			unsigned int idx = core_mmu_va2idx(dir_info, r.va);
+
+			/* The page table allocated for this pgdir is unused */
+			pg_info->table = NULL;
+			pg_info->va_base = r.va;
+			core_mmu_set_entry(dir_info, idx, block_pa, r.attr);
+			r.va += CORE_MMU_PGDIR_SIZE;
+			continue;
+		}
+
 		if (!pg_info->table ||
 		     r.va >= (pg_info->va_base + CORE_MMU_PGDIR_SIZE)) {
 			/*
@@ -1677,6 +1723,27 @@ void core_mmu_map_region(struct mmu_partition *prtn, struct tee_mmap_region *mm)
 	}
 }
 
+/*
+ * Tells if the first pages of @pages are a physically contiguous run which
+ * can be mapped at @vaddr with a single block entry at pgdir level.
+ */
+static bool pages_fit_pgdir_block(vaddr_t vaddr, paddr_t *pages,
+				  size_t num_pages)
+{
+	const size_t num_block_pages = CORE_MMU_PGDIR_SIZE / SMALL_PAGE_SIZE;
+	size_t n = 0;
+
+	if (num_pages < num_block_pages)
+		return false;
+	if ((vaddr | pages[0]) & CORE_MMU_PGDIR_MASK)
+		return false;
+	for (n = 1; n < num_block_pages; n++)
+		if (pages[n] != pages[0] + n * SMALL_PAGE_SIZE)
+			return false;
+
+	return true;
+}
+
 TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 			      enum teecore_memtypes memtype)
 {
@@ -1687,7 +1754,7 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 	uint32_t old_attr;
 	uint32_t exceptions;
 	vaddr_t vaddr = vstart;
-	size_t i;
+	size_t i = 0;
 	bool secure;
 
 	assert(!(core_mmu_type_to_attr(memtype) & TEE_MATTR_PX));
@@ -1706,7 +1773,7 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 	if (!core_mmu_is_dynamic_vaspace(mm))
 		panic("Trying to map into static region");
 
-	for (i = 0; i < num_pages; i++) {
+	while (i < num_pages) {
 		if (pages[i] & SMALL_PAGE_MASK) {
 			ret = TEE_ERROR_BAD_PARAMETERS;
 			goto err;
@@ -1721,6 +1788,20 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 			if (tbl_info.shift == SMALL_PAGE_SHIFT)
 				break;
 
+			/*
+			 * Large physically contiguous buffers are mapped
+			 * with block entries where the pgdir entry is still
+			 * unused, saving TLB entries.
+			 */
+			if (tbl_info.shift == CORE_MMU_PGDIR_SHIFT &&
+			    pages_fit_pgdir_block(vaddr, pages + i,
+						  num_pages - i)) {
+				core_mmu_get_entry(&tbl_info, idx, NULL,
+						   &old_attr);
+				if (!old_attr)
+					break;
+			}
+
 			/* This is supertable. Need to divide it. */
 			if (!core_mmu_entry_to_finer_grained(&tbl_info, idx,
 							     secure))
@@ -1733,7 +1814,8 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 
 		core_mmu_set_entry(&tbl_info, idx, pages[i],
 				   core_mmu_type_to_attr(memtype));
-		vaddr += SMALL_PAGE_SIZE;
+		i += BIT(tbl_info.shift - SMALL_PAGE_SHIFT);
+		vaddr += BIT(tbl_info.shift);
 	}
 
 	/*
@@ -1828,6 +1910,7 @@ void core_mmu_unmap_pages(vaddr_t vstart, size_t num_pages)
 	size_t i;
 	unsigned int idx;
 	uint32_t exceptions;
+	uint32_t attr = 0;
 
 	exceptions = mmu_lock();
 
@@ -1838,15 +1921,26 @@ void core_mmu_unmap_pages(vaddr_t vstart, size_t num_pages)
 	if (!core_mmu_is_dynamic_vaspace(mm))
 		panic("Trying to unmap static region");
 
-	for (i = 0; i < num_pages; i++, vstart += SMALL_PAGE_SIZE) {
+	i = 0;
+	while (i < num_pages) {
 		if (!core_mmu_find_table(NULL, vstart, UINT_MAX, &tbl_info))
 			panic("Can't find pagetable");
 
-		if (tbl_info.shift != SMALL_PAGE_SHIFT)
+		idx = core_mmu_va2idx(&tbl_info, vstart);
+		if (tbl_info.shift == CORE_MMU_PGDIR_SHIFT) {
+			/* Block entry added by core_mmu_map_pages() */
+			core_mmu_get_entry(&tbl_info, idx, NULL, &attr);
+			if (!attr || (vstart & CORE_MMU_PGDIR_MASK) ||
+			    num_pages - i <
+			    CORE_MMU_PGDIR_SIZE / SMALL_PAGE_SIZE)
+				panic("Invalid block unmap");
+		} else if (tbl_info.shift != SMALL_PAGE_SHIFT) {
 			panic("Invalid pagetable level");
+		}
 
-		idx = core_mmu_va2idx(&tbl_info, vstart);
 		core_mmu_set_entry(&tbl_info, idx, 0, 0);
+		i += BIT(tbl_info.shift - SMALL_PAGE_SHIFT);
+		vstart += BIT(tbl_info.shift);
 	}
 	tlbi_all();
 
@@ -36,6 +36,7 @@ struct mobj_reg_shm {
 	SLIST_ENTRY(mobj_reg_shm) next;
 	uint64_t cookie;
 	tee_mm_entry_t *mm;
+	size_t mm_offs;
 	paddr_t page_offset;
 	struct refcount mapcount;
 	bool guarded;
@@ -108,14 +109,21 @@ static void *mobj_reg_shm_get_va(struct mobj *mobj, size_t offst)
 	if (!mrs->mm || offst >= mobj->size)
 		return NULL;
 
-	return (void *)(vaddr_t)(tee_mm_get_smem(mrs->mm) + offst +
-				 mrs->page_offset);
+	return (void *)(vaddr_t)(tee_mm_get_smem(mrs->mm) + mrs->mm_offs +
+				 offst + mrs->page_offset);
+}
+
+static size_t reg_shm_num_pages(struct mobj_reg_shm *r)
+{
+	return ROUNDUP(r->mobj.size + r->page_offset, SMALL_PAGE_SIZE) /
+	       SMALL_PAGE_SIZE;
 }
 
 static void reg_shm_unmap_helper(struct mobj_reg_shm *r)
 {
 	assert(r->mm->pool->shift == SMALL_PAGE_SHIFT);
-	core_mmu_unmap_pages(tee_mm_get_smem(r->mm), r->mm->size);
+	core_mmu_unmap_pages(tee_mm_get_smem(r->mm) + r->mm_offs,
+			     reg_shm_num_pages(r));
 	tee_mm_free(r->mm);
 	r->mm = NULL;
 }
@@ -215,11 +223,45 @@ static struct mobj_reg_shm *to_mobj_reg_shm_may_fail(struct mobj *mobj)
 	return container_of(mobj, struct mobj_reg_shm, mobj);
 }
 
+/*
+ * Checks that the pages are page aligned and in non-secure memory, runs of
+ * physically contiguous pages are checked at once.
+ */
+static bool pages_are_nsec(const paddr_t *pages, size_t num_pages)
+{
+	paddr_t next = 0;
+	size_t run = 0;
+	size_t n = 0;
+	size_t m = 0;
+
+	for (n = 0; n < num_pages; n += run) {
+		if (pages[n] & SMALL_PAGE_MASK)
+			return false;
+
+		for (run = 1; n + run < num_pages; run++)
+			if (ADD_OVERFLOW(pages[n + run - 1], SMALL_PAGE_SIZE,
+					 &next) || pages[n + run] != next)
+				break;
+
+		/* Only Non-secure memory can be mapped there */
+		if (core_pbuf_is(CORE_MEM_NON_SEC, pages[n],
+				 run * SMALL_PAGE_SIZE))
+			continue;
+
+		/* The run may span adjacent memory banks */
+		for (m = n; m < n + run; m++)
+			if (!core_pbuf_is(CORE_MEM_NON_SEC, pages[m],
+					  SMALL_PAGE_SIZE))
+				return false;
+	}
+
+	return true;
+}
+
 struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 				paddr_t page_offset, uint64_t cookie)
 {
 	struct mobj_reg_shm *mobj_reg_shm = NULL;
-	size_t i = 0;
 	uint32_t exceptions = 0;
 	size_t s = 0;
 
@@ -243,15 +285,8 @@ struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 	memcpy(mobj_reg_shm->pages, pages, sizeof(*pages) * num_pages);
 
 	/* Ensure loaded references match format and security constraints */
-	for (i = 0; i < num_pages; i++) {
-		if (mobj_reg_shm->pages[i] & SMALL_PAGE_MASK)
-			goto err;
-
-		/* Only Non-secure memory can be mapped there */
-		if (!core_pbuf_is(CORE_MEM_NON_SEC, mobj_reg_shm->pages[i],
-				  SMALL_PAGE_SIZE))
-			goto err;
-	}
+	if (!pages_are_nsec(mobj_reg_shm->pages, num_pages))
+		goto err;
 
 	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
 	SLIST_INSERT_HEAD(&reg_shm_list, mobj_reg_shm, next);
@@ -352,10 +387,39 @@ TEE_Result mobj_reg_shm_release_by_cookie(uint64_t cookie)
 	return TEE_SUCCESS;
 }
 
+/*
+ * Returns true if the pages of @r hold a physically contiguous run
+ * covering a whole pgdir aligned block, which can then be mapped with a
+ * block entry.
+ */
+static bool reg_shm_has_block(struct mobj_reg_shm *r)
+{
+	size_t num_pages = reg_shm_num_pages(r);
+	paddr_t block = 0;
+	size_t start = 0;
+	size_t n = 0;
+
+	for (n = 1; n <= num_pages; n++) {
+		if (n < num_pages &&
+		    r->pages[n] == r->pages[n - 1] + SMALL_PAGE_SIZE)
+			continue;
+
+		/* Pages [start, n) are contiguous */
+		block = ROUNDUP(r->pages[start], CORE_MMU_PGDIR_SIZE);
+		if (block + CORE_MMU_PGDIR_SIZE <=
+		    r->pages[n - 1] + SMALL_PAGE_SIZE)
+			return true;
+		start = n;
+	}
+
+	return false;
+}
+
 TEE_Result mobj_inc_map(struct mobj *mobj)
 {
 	TEE_Result res = TEE_SUCCESS;
 	struct mobj_reg_shm *r = to_mobj_reg_shm_may_fail(mobj);
+	size_t pad = 0;
 	size_t sz = 0;
 
 	if (!r)
@@ -369,15 +433,36 @@ TEE_Result mobj_inc_map(struct mobj *mobj)
 	if (refcount_val(&r->mapcount))
 		goto out;
 
-	sz = ROUNDUP(mobj->size + r->page_offset, SMALL_PAGE_SIZE);
-	r->mm = tee_mm_alloc(&tee_mm_shm, sz);
+	/*
+	 * Buffers with a physically contiguous run covering a pgdir aligned
+	 * block get virtual memory with the same offset from a pgdir
+	 * boundary as their first physical page, so the run can be mapped
+	 * with block entries. This costs up to CORE_MMU_PGDIR_SIZE -
+	 * SMALL_PAGE_SIZE of extra virtual memory from tee_mm_shm, so it's
+	 * only done if the pool has room for it, else the buffer is mapped
+	 * with small pages only.
+	 */
+	sz = reg_shm_num_pages(r) * SMALL_PAGE_SIZE;
+	if (reg_shm_has_block(r)) {
+		pad = CORE_MMU_PGDIR_SIZE - SMALL_PAGE_SIZE;
+		r->mm = tee_mm_alloc(&tee_mm_shm, sz + pad);
+		if (!r->mm)
+			pad = 0;
+	}
+	if (!r->mm)
+		r->mm = tee_mm_alloc(&tee_mm_shm, sz);
 	if (!r->mm) {
 		res = TEE_ERROR_OUT_OF_MEMORY;
 		goto out;
 	}
-
-	res = core_mmu_map_pages(tee_mm_get_smem(r->mm), r->pages,
-				 sz / SMALL_PAGE_SIZE, MEM_AREA_NSEC_SHM);
+	r->mm_offs = 0;
+	if (pad)
+		r->mm_offs = (r->pages[0] - tee_mm_get_smem(r->mm)) &
+			     CORE_MMU_PGDIR_MASK;
+
+	res = core_mmu_map_pages(tee_mm_get_smem(r->mm) + r->mm_offs,
+				 r->pages, sz / SMALL_PAGE_SIZE,
+				 MEM_AREA_NSEC_SHM);
 	if (res) {
 		tee_mm_free(r->mm);
 		r->mm = NULL;
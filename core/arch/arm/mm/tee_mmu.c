@@ -44,6 +44,26 @@
 #define TEE_MMU_UCACHE_DEFAULT_ATTR	(TEE_MATTR_CACHE_CACHED << \
 					 TEE_MATTR_CACHE_SHIFT)
 
+/*
+ * Large shareable mappings, such as parameters, get the same offset from a
+ * pgdir boundary as their physical memory so physically contiguous parts
+ * can be mapped with block entries, see set_pg_region().
+ */
+static bool get_pgdir_block_offs(const struct vm_region *reg,
+				 vaddr_t *offs)
+{
+	paddr_t pa = 0;
+
+	if (!(reg->flags & VM_FLAG_SHAREABLE) ||
+	    reg->size < CORE_MMU_PGDIR_SIZE || mobj_is_paged(reg->mobj))
+		return false;
+	if (mobj_get_pa(reg->mobj, reg->offset, SMALL_PAGE_SIZE, &pa))
+		return false;
+
+	*offs = pa & CORE_MMU_PGDIR_MASK;
+	return true;
+}
+
 static vaddr_t select_va_in_range(const struct vm_region *prev_reg,
 				  const struct vm_region *next_reg,
 				  const struct vm_region *reg,
@@ -51,6 +71,7 @@ static vaddr_t select_va_in_range(const struct vm_region *prev_reg,
 {
 	const uint32_t f = VM_FLAG_EPHEMERAL | VM_FLAG_PERMANENT |
 			    VM_FLAG_SHAREABLE;
+	vaddr_t block_offs = 0;
 	vaddr_t begin_va = 0;
 	vaddr_t end_va = 0;
 	size_t granul = 0;
@@ -78,6 +99,8 @@ static vaddr_t select_va_in_range(const struct vm_region *prev_reg,
 		if (reg->va < begin_va)
 			return 0;
 		begin_va = reg->va;
+	} else if (get_pgdir_block_offs(reg, &block_offs)) {
+		begin_va += (block_offs - begin_va) & CORE_MMU_PGDIR_MASK;
 	}
 
 	if (next_reg->flags && (next_reg->flags & f) != (reg->flags & f))
@@ -182,6 +205,32 @@ static void maybe_free_pgt(struct user_mode_ctx *uctx, struct vm_region *r)
 	pgt_flush_ctx_range(pgt_cache, &uctx->ctx, r->va, r->va + r->size);
 }
 
+#ifdef CFG_WITH_STATS
+/* Accounts secure memory mapped in user space, parameters excluded */
+static void stats_account_region(struct vm_info *vmi, struct vm_region *reg,
+				 bool add)
+{
+	struct tee_ta_ctx_stats *stats = NULL;
+
+	if (!(reg->attr & TEE_MATTR_SECURE) || (reg->flags & VM_FLAG_EPHEMERAL))
+		return;
+
+	stats = &container_of(vmi, struct user_mode_ctx, vm_info)->ctx.stats;
+	if (add) {
+		stats->ram += reg->size;
+		stats->ram_peak = MAX(stats->ram_peak, stats->ram);
+	} else {
+		stats->ram -= reg->size;
+	}
+}
+#else
+static void stats_account_region(struct vm_info *vmi __unused,
+				 struct vm_region *reg __unused,
+				 bool add __unused)
+{
+}
+#endif
+
 static TEE_Result umap_add_region(struct vm_info *vmi, struct vm_region *reg,
 				  size_t pad_begin, size_t pad_end)
 {
@@ -295,6 +344,7 @@ TEE_Result vm_map_pad(struct user_mode_ctx *uctx, vaddr_t *va, size_t len,
 	if (thread_get_tsd()->ctx == &uctx->ctx)
 		tee_mmu_set_ctx(&uctx->ctx);
 
+	stats_account_region(&uctx->vm_info, reg, true);
 	*va = reg->va;
 
 	return TEE_SUCCESS;
@@ -683,6 +733,7 @@ TEE_Result vm_set_prot(struct user_mode_ctx *uctx, vaddr_t va, size_t len,
 
 static void umap_remove_region(struct vm_info *vmi, struct vm_region *reg)
 {
+	stats_account_region(vmi, reg, false);
 	TAILQ_REMOVE(&vmi->regions, reg, link);
 	mobj_put(reg->mobj);
 	free(reg);
@@ -963,6 +1014,7 @@ TEE_Result tee_mmu_add_rwmem(struct user_mode_ctx *uctx, struct mobj *mobj,
 		free(reg);
 		return res;
 	}
+	stats_account_region(&uctx->vm_info, reg, true);
 
 	res = alloc_pgt(uctx);
 	if (res)
@@ -12,12 +12,14 @@
 #include <kernel/asan.h>
 #include <kernel/cache_helpers.h>
 #include <kernel/linker.h>
+#include <kernel/lock_prof.h>
 #include <kernel/panic.h>
 #include <kernel/spinlock.h>
 #include <kernel/tee_misc.h>
 #include <kernel/tee_ta_manager.h>
 #include <kernel/thread.h>
 #include <kernel/tlb_helpers.h>
+#include <kernel/tracepoint.h>
 #include <kernel/user_mode_ctx.h>
 #include <mm/core_memprot.h>
 #include <mm/fobj.h>
@@ -154,7 +156,10 @@ static tee_mm_entry_t *pager_alias_area;
  */
 static uintptr_t pager_alias_next_free;
 
-#ifdef CFG_TEE_CORE_DEBUG
+/* Holder of @pager_spinlock, only accounted with CFG_LOCK_PROF=y */
+static struct lock_prof_hold pager_lock_hold;
+
+#if defined(CFG_TEE_CORE_DEBUG) || defined(CFG_LOCK_PROF)
 #define pager_lock(ai) pager_lock_dldetect(__func__, __LINE__, ai)
 
 static uint32_t pager_lock_dldetect(const char *func, const int line,
@@ -163,8 +168,11 @@ static uint32_t pager_lock_dldetect(const char *func, const int line,
 	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
 	unsigned int retries = 0;
 	unsigned int reminder = 0;
+	uint64_t wait_begin = 0;
 
 	while (!cpu_spin_trylock(&pager_spinlock)) {
+		if (!wait_begin)
+			wait_begin = lock_prof_now();
 		retries++;
 		if (!retries) {
 			/* wrapped, time to report */
@@ -178,6 +186,9 @@ static uint32_t pager_lock_dldetect(const char *func, const int line,
 		}
 	}
 
+	lock_prof_acquired(&pager_lock_hold, &pager_spinlock,
+			   LOCK_PROF_SPINLOCK, func, line, wait_begin);
+
 	return exceptions;
 }
 #else
@@ -211,6 +222,7 @@ static uint32_t pager_lock_check_stack(size_t stack_size)
 
 static void pager_unlock(uint32_t exceptions)
 {
+	lock_prof_released(&pager_lock_hold);
 	cpu_spin_unlock_xrestore(&pager_spinlock, exceptions);
 }
 
@@ -1431,6 +1443,17 @@ static void stat_handle_fault(void)
 }
 #endif
 
+#ifdef CFG_WITH_STATS
+static void stat_handle_uta_fault(void)
+{
+	thread_get_tsd()->ctx->stats.pager_faults++;
+}
+#else
+static void stat_handle_uta_fault(void)
+{
+}
+#endif
+
 bool tee_pager_handle_fault(struct abort_info *ai)
 {
 	struct tee_pager_area *area;
@@ -1458,6 +1481,7 @@ bool tee_pager_handle_fault(struct abort_info *ai)
 	exceptions = pager_lock(ai);
 
 	stat_handle_fault();
+	trace_pager_fault(ai->va, ai->abort_type);
 
 	/* check if the access is valid */
 	if (abort_is_user_exception(ai)) {
@@ -1474,6 +1498,8 @@ bool tee_pager_handle_fault(struct abort_info *ai)
 		ret = false;
 		goto out;
 	}
+	if (clean_user_cache)
+		stat_handle_uta_fault();
 
 	if (!tee_pager_unhide_page(area, area_va2idx(area, page_va))) {
 		struct tee_pager_pmem *pmem = NULL;
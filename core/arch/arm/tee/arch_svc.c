@@ -6,13 +6,18 @@
 #include <arm.h>
 #include <assert.h>
 #include <kernel/abort.h>
+#include <kernel/delay.h>
 #include <kernel/misc.h>
 #include <kernel/panic.h>
 #include <kernel/tee_ta_manager.h>
 #include <kernel/thread.h>
 #include <kernel/trace_ta.h>
 #include <kernel/user_ta.h>
+#include <mm/mobj.h>
 #include <mm/tee_mmu.h>
+#include <optee_rpc_cmd.h>
+#include <printk.h>
+#include <stdlib.h>
 #include <string.h>
 #include <tee/tee_svc.h>
 #include <tee/arch_svc.h>
@@ -29,14 +34,18 @@
 #define TRACE_SYSCALLS
 #endif
 
+#if defined(TRACE_SYSCALLS) || defined(CFG_TA_SYSCALL_PROF)
+#define SYSCALL_NAMES
+#endif
+
 struct syscall_entry {
 	syscall_t fn;
-#ifdef TRACE_SYSCALLS
+#ifdef SYSCALL_NAMES
 	const char *name;
 #endif
 };
 
-#ifdef TRACE_SYSCALLS
+#ifdef SYSCALL_NAMES
 #define SYSCALL_ENTRY(_fn) { .fn = (syscall_t)_fn, .name = #_fn }
 #else
 #define SYSCALL_ENTRY(_fn) { .fn = (syscall_t)_fn }
@@ -175,6 +184,162 @@ static void __noprof ftrace_syscall_leave(void)
 }
 #endif
 
+struct syscall_stats {
+	struct tee_ta_ctx *ctx;
+	uint64_t begin;
+	uint64_t rpc_time;
+};
+
+#ifdef CFG_WITH_STATS
+static void stats_syscall_enter(struct syscall_stats *st, size_t scn)
+{
+	struct tee_ta_session *s = NULL;
+
+	if (tee_ta_get_current_session(&s) != TEE_SUCCESS)
+		return;
+
+	st->ctx = s->ctx;
+	if (scn <= TEE_SCN_MAX)
+		st->ctx->stats.syscalls[scn]++;
+	st->rpc_time = st->ctx->stats.rpc_time;
+	st->begin = read_cntpct();
+}
+
+static void stats_syscall_leave(struct syscall_stats *st)
+{
+	uint64_t ticks = 0;
+	uint64_t rpc_ticks = 0;
+
+	if (!st->ctx)
+		return;
+
+	/* Time spent in normal world serving RPCs isn't kernel time */
+	ticks = read_cntpct() - st->begin;
+	rpc_ticks = st->ctx->stats.rpc_time - st->rpc_time;
+	if (ticks > rpc_ticks)
+		st->ctx->stats.ktime += ticks - rpc_ticks;
+}
+#else
+static void stats_syscall_enter(struct syscall_stats *st __unused,
+				size_t scn __unused)
+{
+}
+
+static void stats_syscall_leave(struct syscall_stats *st __unused)
+{
+}
+#endif
+
+struct syscall_prof_ctx {
+	struct syscall_prof *prof;
+	uint64_t begin;
+};
+
+#ifdef CFG_TA_SYSCALL_PROF
+static void prof_syscall_enter(struct syscall_prof_ctx *pc, size_t scn)
+{
+	struct tee_ta_session *s = NULL;
+
+	if (scn > TEE_SCN_MAX || tee_ta_get_current_session(&s))
+		return;
+
+	if (!s->sprof) {
+		s->sprof = calloc(TEE_SCN_MAX + 1, sizeof(*s->sprof));
+		if (!s->sprof)
+			return;
+	}
+
+	/*
+	 * Counted on entry since _utee_return() and _utee_panic() don't come
+	 * back to prof_syscall_leave()
+	 */
+	pc->prof = s->sprof + scn;
+	pc->prof->count++;
+	pc->begin = read_cntpct();
+}
+
+static void prof_syscall_leave(struct syscall_prof_ctx *pc)
+{
+	struct syscall_prof *prof = pc->prof;
+	uint64_t ticks = 0;
+
+	if (!prof)
+		return;
+
+	ticks = read_cntpct() - pc->begin;
+	prof->total += ticks;
+	if (ticks > prof->max)
+		prof->max = ticks;
+}
+
+/* Length of a line of the syscall profile, see user_ta_dump_syscall_prof() */
+#define SYSCALL_PROF_LINE_LEN	96
+
+void user_ta_dump_syscall_prof(struct tee_ta_session *s)
+{
+	struct thread_param params[3] = { };
+	struct syscall_prof *prof = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	struct mobj *mobj = NULL;
+	size_t pl_sz = 0;
+	size_t len = 0;
+	char *buf = NULL;
+	size_t n = 0;
+
+	if (!s->sprof || !s->ctx)
+		return;
+
+	/* The UUID followed by a header line and a line per syscall */
+	pl_sz = ROUNDUP(sizeof(TEE_UUID) +
+			(TEE_SCN_MAX + 2) * SYSCALL_PROF_LINE_LEN,
+			SMALL_PAGE_SIZE);
+	mobj = thread_rpc_alloc_payload(pl_sz);
+	if (!mobj) {
+		EMSG("Syscall profile thread_rpc_alloc_payload failed");
+		return;
+	}
+
+	buf = mobj_get_va(mobj, 0);
+	if (!buf)
+		goto out;
+
+	memcpy(buf, &s->ctx->uuid, sizeof(TEE_UUID));
+	buf += sizeof(TEE_UUID);
+
+	len = snprintk(buf, SYSCALL_PROF_LINE_LEN, "%-36s %10s %12s %12s\n",
+		       "syscall", "count", "total us", "max us");
+	for (n = 0; n <= TEE_SCN_MAX; n++) {
+		prof = s->sprof + n;
+		if (!prof->count)
+			continue;
+		len += snprintk(buf + len, SYSCALL_PROF_LINE_LEN,
+				"%-36s %10"PRIu32" %12"PRIu64" %12"PRIu64"\n",
+				tee_svc_syscall_table[n].name, prof->count,
+				arm_cnt_cnt2us(prof->total),
+				arm_cnt_cnt2us(prof->max));
+	}
+
+	params[0] = THREAD_PARAM_VALUE(INOUT, 0, 0, 0);
+	params[1] = THREAD_PARAM_MEMREF(IN, mobj, 0, sizeof(TEE_UUID));
+	params[2] = THREAD_PARAM_MEMREF(IN, mobj, sizeof(TEE_UUID), len);
+
+	res = thread_rpc_cmd(OPTEE_RPC_CMD_FTRACE, 3, params);
+	if (res)
+		EMSG("Syscall profile thread_rpc_cmd res: %#"PRIx32, res);
+out:
+	thread_rpc_free_payload(mobj);
+}
+#else
+static void prof_syscall_enter(struct syscall_prof_ctx *pc __unused,
+			       size_t scn __unused)
+{
+}
+
+static void prof_syscall_leave(struct syscall_prof_ctx *pc __unused)
+{
+}
+#endif /*CFG_TA_SYSCALL_PROF*/
+
 #ifdef ARM32
 static void get_scn_max_args(struct thread_svc_regs *regs, size_t *scn,
 		size_t *max_args)
@@ -215,6 +380,8 @@ static void set_svc_retval(struct thread_svc_regs *regs, uint64_t ret_val)
 
 bool user_ta_handle_svc(struct thread_svc_regs *regs)
 {
+	struct syscall_stats stats = { };
+	struct syscall_prof_ctx prof = { };
 	size_t scn;
 	size_t max_args;
 	syscall_t scf;
@@ -238,9 +405,13 @@ bool user_ta_handle_svc(struct thread_svc_regs *regs)
 		scf = tee_svc_syscall_table[scn].fn;
 
 	ftrace_syscall_enter(scn);
+	stats_syscall_enter(&stats, scn);
+	prof_syscall_enter(&prof, scn);
 
 	set_svc_retval(regs, tee_svc_do_call(regs, scf));
 
+	prof_syscall_leave(&prof);
+	stats_syscall_leave(&stats);
 	ftrace_syscall_leave();
 
 	/*
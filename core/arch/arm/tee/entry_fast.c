@@ -8,10 +8,13 @@
 #include <optee_msg.h>
 #include <sm/optee_smc.h>
 #include <kernel/generic_boot.h>
+#include <kernel/pseudo_ta.h>
 #include <kernel/tee_l2cc_mutex.h>
 #include <kernel/virtualization.h>
 #include <kernel/misc.h>
+#include <kernel/notif.h>
 #include <mm/core_mmu.h>
+#include <tee/uuid.h>
 
 #ifdef CFG_CORE_RESERVED_SHM
 static void tee_entry_get_shm_config(struct thread_smc_args *args)
@@ -91,6 +94,16 @@ static void tee_entry_exchange_capabilities(struct thread_smc_args *args)
 #ifdef CFG_VIRTUALIZATION
 	args->a1 |= OPTEE_SMC_SEC_CAP_VIRTUALIZATION;
 #endif
+#ifdef CFG_CORE_INVOKE_BATCH
+	args->a1 |= OPTEE_SMC_SEC_CAP_INVOKE_BATCH;
+#endif
+#ifdef CFG_PTA_FAST_INVOKE
+	args->a1 |= OPTEE_SMC_SEC_CAP_PTA_FAST_CALL;
+#endif
+#ifdef CFG_CORE_ASYNC_NOTIF
+	args->a1 |= OPTEE_SMC_SEC_CAP_ASYNC_NOTIF;
+	args->a2 = NOTIF_ASYNC_VALUE_MAX;
+#endif
 
 #if defined(CFG_CORE_DYN_SHM)
 	dyn_shm_en = core_mmu_nsec_ddr_is_defined();
@@ -146,6 +159,73 @@ static void tee_entry_get_thread_count(struct thread_smc_args *args)
 	args->a1 = CFG_NUM_THREADS;
 }
 
+#ifdef CFG_PTA_FAST_INVOKE
+static void tee_entry_get_pta_handle(struct thread_smc_args *args)
+{
+	uint32_t words[4] = { args->a1, args->a2, args->a3, args->a4 };
+	uint8_t octets[sizeof(TEE_UUID)] = { };
+	uint32_t handle = 0;
+	TEE_UUID uuid = { };
+	size_t n = 0;
+
+	for (n = 0; n < sizeof(octets); n++)
+		octets[n] = words[n / 4] >> (24 - (n % 4) * 8);
+	tee_uuid_from_octets(&uuid, octets);
+
+	if (pseudo_ta_get_fast_handle(&uuid, &handle)) {
+		args->a0 = OPTEE_SMC_RETURN_ENOTAVAIL;
+		return;
+	}
+
+	args->a0 = OPTEE_SMC_RETURN_OK;
+	args->a1 = handle;
+}
+
+static void tee_entry_call_pta_fast(struct thread_smc_args *args)
+{
+	uint32_t val[4] = { args->a3, args->a4, args->a5, args->a6 };
+	TEE_Result res = TEE_SUCCESS;
+
+	res = pseudo_ta_fast_invoke(args->a1, args->a2, val);
+	if (res == TEE_ERROR_ITEM_NOT_FOUND) {
+		args->a0 = OPTEE_SMC_RETURN_EBADCMD;
+		return;
+	}
+
+	args->a0 = OPTEE_SMC_RETURN_OK;
+	args->a1 = res;
+	args->a2 = val[0];
+	args->a3 = val[1];
+	args->a4 = val[2];
+	args->a5 = val[3];
+}
+#endif
+
+#ifdef CFG_CORE_ASYNC_NOTIF
+static void tee_entry_enable_async_notif(struct thread_smc_args *args)
+{
+	notif_async_enable();
+	args->a0 = OPTEE_SMC_RETURN_OK;
+}
+
+static void tee_entry_get_async_notif_value(struct thread_smc_args *args)
+{
+	bool value_valid = false;
+	bool value_pending = false;
+	uint32_t value = 0;
+
+	notif_async_get_value(&value, &value_valid, &value_pending);
+
+	args->a0 = OPTEE_SMC_RETURN_OK;
+	args->a1 = value;
+	args->a2 = 0;
+	if (value_valid)
+		args->a2 |= OPTEE_SMC_ASYNC_NOTIF_VALUE_VALID;
+	if (value_pending)
+		args->a2 |= OPTEE_SMC_ASYNC_NOTIF_VALUE_PENDING;
+}
+#endif
+
 #if defined(CFG_VIRTUALIZATION)
 static void tee_entry_vm_created(struct thread_smc_args *args)
 {
@@ -229,6 +309,22 @@ void __tee_entry_fast(struct thread_smc_args *args)
 	case OPTEE_SMC_GET_THREAD_COUNT:
 		tee_entry_get_thread_count(args);
 		break;
+#ifdef CFG_PTA_FAST_INVOKE
+	case OPTEE_SMC_GET_PTA_HANDLE:
+		tee_entry_get_pta_handle(args);
+		break;
+	case OPTEE_SMC_CALL_PTA_FAST:
+		tee_entry_call_pta_fast(args);
+		break;
+#endif
+#ifdef CFG_CORE_ASYNC_NOTIF
+	case OPTEE_SMC_ENABLE_ASYNC_NOTIF:
+		tee_entry_enable_async_notif(args);
+		break;
+	case OPTEE_SMC_GET_ASYNC_NOTIF_VALUE:
+		tee_entry_get_async_notif_value(args);
+		break;
+#endif
 
 #if defined(CFG_VIRTUALIZATION)
 	case OPTEE_SMC_VM_CREATED:
@@ -257,6 +353,12 @@ size_t tee_entry_generic_get_api_call_count(void)
 #if defined(CFG_VIRTUALIZATION)
 	ret += 2;
 #endif
+#if defined(CFG_PTA_FAST_INVOKE)
+	ret += 2;
+#endif
+#if defined(CFG_CORE_ASYNC_NOTIF)
+	ret += 2;
+#endif
 
 	return ret;
 }
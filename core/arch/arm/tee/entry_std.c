@@ -9,6 +9,7 @@
 #include <compiler.h>
 #include <initcall.h>
 #include <io.h>
+#include <kernel/interrupt.h>
 #include <kernel/linker.h>
 #include <kernel/msg_param.h>
 #include <kernel/panic.h>
@@ -378,7 +379,7 @@ static void entry_invoke_command(struct optee_msg_arg *arg, uint32_t num_params)
 	if (res != TEE_SUCCESS)
 		goto out;
 
-	s = tee_ta_get_session(arg->session, true, &tee_open_sessions);
+	s = tee_ta_get_invoke_session(arg->session, &tee_open_sessions);
 	if (!s) {
 		res = TEE_ERROR_BAD_PARAMETERS;
 		goto out;
@@ -400,6 +401,103 @@ out:
 	arg->ret_origin = err_orig;
 }
 
+#ifdef CFG_CORE_INVOKE_BATCH
+static bool is_batch_hdr(const struct optee_msg_param *param)
+{
+	return READ_ONCE(param->attr) ==
+	       (OPTEE_MSG_ATTR_META | OPTEE_MSG_ATTR_TYPE_VALUE_INOUT);
+}
+
+/* Checks that the entries of the batch cover exactly @num_params */
+static TEE_Result check_batch(struct optee_msg_param *params,
+			      uint32_t num_params)
+{
+	uint32_t n = 0;
+	uint64_t num = 0;
+
+	while (n < num_params) {
+		if (!is_batch_hdr(params + n))
+			return TEE_ERROR_BAD_PARAMETERS;
+		num = READ_ONCE(params[n].u.value.c);
+		if (num > TEE_NUM_PARAMS || num > num_params - n - 1)
+			return TEE_ERROR_BAD_PARAMETERS;
+		n += num + 1;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Invokes the commands of the batch back to back. A session is kept
+ * between consecutive entries of the same session instead of being
+ * looked up and released for each command.
+ */
+static void entry_invoke_batch(struct optee_msg_arg *arg, uint32_t num_params)
+{
+	struct optee_msg_param *params = arg->params;
+	struct tee_ta_session *s = NULL;
+	struct tee_ta_param param = { 0 };
+	uint64_t saved_attr[TEE_NUM_PARAMS] = { 0 };
+	TEE_ErrorOrigin err_orig = TEE_ORIGIN_TEE;
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t session = 0;
+	uint32_t func = 0;
+	uint32_t num = 0;
+	uint32_t n = 0;
+
+	res = check_batch(params, num_params);
+	if (res)
+		goto out;
+
+	while (n < num_params) {
+		/*
+		 * The entries were checked above but they're in non-secure
+		 * memory and may have changed since, the number of
+		 * parameters is bounded again.
+		 */
+		session = READ_ONCE(params[n].u.value.a);
+		func = READ_ONCE(params[n].u.value.b);
+		num = MIN(READ_ONCE(params[n].u.value.c),
+			  (uint64_t)MIN(num_params - n - 1, TEE_NUM_PARAMS));
+		err_orig = TEE_ORIGIN_TEE;
+
+		if (s && s->id != session) {
+			tee_ta_put_session(s);
+			s = NULL;
+		}
+
+		memset(saved_attr, 0, sizeof(saved_attr));
+		res = copy_in_params(params + n + 1, num, &param, saved_attr);
+		if (res)
+			goto next;
+
+		if (!s)
+			s = tee_ta_get_invoke_session(session,
+						      &tee_open_sessions);
+		if (!s) {
+			res = TEE_ERROR_BAD_PARAMETERS;
+			goto next;
+		}
+
+		res = tee_ta_invoke_command(&err_orig, s, NSAPP_IDENTITY,
+					    TEE_TIMEOUT_INFINITE, func, &param);
+		copy_out_param(&param, num, params + n + 1, saved_attr);
+next:
+		cleanup_shm_refs(saved_attr, &param, num);
+		params[n].u.value.a = res;
+		params[n].u.value.b = err_orig;
+		n += num + 1;
+	}
+
+	if (s)
+		tee_ta_put_session(s);
+	res = TEE_SUCCESS;
+out:
+	arg->ret = res;
+	arg->ret_origin = TEE_ORIGIN_TEE;
+}
+#endif /*CFG_CORE_INVOKE_BATCH*/
+
 static void entry_cancel(struct optee_msg_arg *arg, uint32_t num_params)
 {
 	TEE_Result res;
@@ -484,6 +582,10 @@ uint32_t __tee_entry_std(struct optee_msg_arg *arg, uint32_t num_params)
 
 	/* Enable foreign interrupts for STD calls */
 	thread_set_foreign_intr(true);
+
+	/* Deferred work of interrupt handlers is run by any STD call */
+	itr_run_work();
+
 	switch (arg->cmd) {
 	case OPTEE_MSG_CMD_OPEN_SESSION:
 		entry_open_session(arg, num_params);
@@ -497,6 +599,14 @@ uint32_t __tee_entry_std(struct optee_msg_arg *arg, uint32_t num_params)
 	case OPTEE_MSG_CMD_CANCEL:
 		entry_cancel(arg, num_params);
 		break;
+#ifdef CFG_CORE_INVOKE_BATCH
+	case OPTEE_MSG_CMD_INVOKE_BATCH:
+		entry_invoke_batch(arg, num_params);
+		break;
+#endif
+	case OPTEE_MSG_CMD_DO_BOTTOM_HALF:
+		arg->ret = TEE_SUCCESS;
+		break;
 #ifdef CFG_CORE_DYN_SHM
 	case OPTEE_MSG_CMD_REGISTER_SHM:
 		register_shm(arg, num_params);
@@ -4,6 +4,7 @@
  */
 
 #include <initcall.h>
+#include <kernel/boot_prof.h>
 #include <kernel/linker.h>
 #include <kernel/tee_misc.h>
 #include <kernel/time_source.h>
@@ -21,17 +22,31 @@
 
 #define TEE_MON_MAX_NUM_ARGS    8
 
+#ifdef CFG_BOOT_PROF
+static void boot_prof_initcall(const struct initcall *call, uint64_t begin)
+{
+	boot_prof_end(call->func_name, call->level, begin);
+}
+#else
+static void boot_prof_initcall(const struct initcall *call __unused,
+			       uint64_t begin __unused)
+{
+}
+#endif
+
 static void call_initcalls(void)
 {
-	const initcall_t *call;
+	const struct initcall *call;
 
 	for (call = initcall_begin; call < initcall_end; call++) {
+		uint64_t begin = boot_prof_begin();
 		TEE_Result ret;
-		ret = (*call)();
+		ret = call->func();
 		if (ret != TEE_SUCCESS) {
 			EMSG("Initial call 0x%08" PRIxVA " failed",
 			     (vaddr_t)call);
 		}
+		boot_prof_initcall(call, begin);
 	}
 }
 
@@ -42,6 +57,7 @@ static void call_initcalls(void)
 TEE_Result __weak init_teecore(void)
 {
 	static int is_first = 1;
+	uint64_t begin = 0;
 
 	/* (DEBUG) for inits at 1st TEE service: when UART is setup */
 	if (!is_first)
@@ -58,7 +74,9 @@ TEE_Result __weak init_teecore(void)
 #endif
 
 	/* time initialization */
+	begin = boot_prof_begin();
 	time_source_init();
+	boot_prof_end("time source", BOOT_PROF_PHASE, begin);
 
 	/* call pre-define initcall routines */
 	call_initcalls();
@@ -67,7 +85,9 @@ TEE_Result __weak init_teecore(void)
 	 * Now that RNG is initialized generate the key needed for r/w
 	 * paging.
 	 */
+	begin = boot_prof_begin();
 	fobj_generate_authenc_key();
+	boot_prof_end("fobj key", BOOT_PROF_PHASE, begin);
 
 	IMSG("Initialized");
 	return TEE_SUCCESS;
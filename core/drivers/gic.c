@@ -304,10 +304,17 @@ static void gic_it_set_pending(struct gic_data *gd, size_t it)
 	size_t idx = it / NUM_INTS_PER_REG;
 	uint32_t mask = BIT32(it % NUM_INTS_PER_REG);
 
-	/* Should be Peripheral Interrupt */
+	/*
+	 * Should be Peripheral Interrupt, assigned to group0 unless it's
+	 * used to signal normal world
+	 */
 	assert(it >= NUM_SGI);
-	/* Assigned to group0 */
+#ifdef CFG_CORE_ASYNC_NOTIF
+	assert(it == CFG_CORE_ASYNC_NOTIF_GIC_INTID ||
+	       !(io_read32(gd->gicd_base + GICD_IGROUPR(idx)) & mask));
+#else
 	assert(!(io_read32(gd->gicd_base + GICD_IGROUPR(idx)) & mask));
+#endif
 
 	/* Raise the interrupt */
 	io_write32(gd->gicd_base + GICD_ISPENDR(idx), mask);
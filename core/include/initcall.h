@@ -11,12 +11,28 @@
 
 typedef TEE_Result (*initcall_t)(void);
 
-#define __define_initcall(level, fn) \
-	SCATTERED_ARRAY_DEFINE_PG_ITEM_ORDERED(initcall, level, initcall_t) = \
-		(fn)
+struct initcall {
+	initcall_t func;
+#ifdef CFG_BOOT_PROF
+	int level;
+	const char *func_name;
+#endif
+};
+
+#ifdef CFG_BOOT_PROF
+#define __define_initcall(lvl, fn) \
+	SCATTERED_ARRAY_DEFINE_PG_ITEM_ORDERED(initcall, lvl, \
+					       struct initcall) = \
+		{ .func = (fn), .level = (lvl), .func_name = #fn, }
+#else
+#define __define_initcall(lvl, fn) \
+	SCATTERED_ARRAY_DEFINE_PG_ITEM_ORDERED(initcall, lvl, \
+					       struct initcall) = \
+		{ .func = (fn), }
+#endif
 
-#define initcall_begin	SCATTERED_ARRAY_BEGIN(initcall, initcall_t)
-#define initcall_end	SCATTERED_ARRAY_END(initcall, initcall_t)
+#define initcall_begin	SCATTERED_ARRAY_BEGIN(initcall, struct initcall)
+#define initcall_end	SCATTERED_ARRAY_END(initcall, struct initcall)
 
 #define service_init(fn)	__define_initcall(1, fn)
 #define service_init_late(fn)	__define_initcall(2, fn)
@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __KERNEL_BOOT_PROF_H
+#define __KERNEL_BOOT_PROF_H
+
+#include <compiler.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <tee_api_types.h>
+
+/* Level of the boot phases, initcalls use their initcall level */
+#define BOOT_PROF_PHASE		0
+
+#define BOOT_PROF_NAME_LEN	32
+
+/*
+ * struct boot_prof_entry - one timed step of the boot
+ * @name:		name of the boot phase or of the initcall function
+ * @level:		BOOT_PROF_PHASE or the initcall level
+ * @begin_us:		start of the step, in microseconds since the system
+ *			counter started counting
+ * @duration_us:	duration of the step
+ */
+struct boot_prof_entry {
+	char name[BOOT_PROF_NAME_LEN];
+	uint32_t level;
+	uint32_t reserved;
+	uint64_t begin_us;
+	uint64_t duration_us;
+};
+
+#ifdef CFG_BOOT_PROF
+/* Returns the timestamp to pass to boot_prof_end() */
+uint64_t boot_prof_begin(void);
+/* Records a step which started at @begin and ends now */
+void boot_prof_end(const char *name, uint32_t level, uint64_t begin);
+/*
+ * Records the MMU setup, which runs before the MMU is enabled when
+ * pointers to the name of the step can't be used yet.
+ */
+void boot_prof_mmu_setup(uint64_t begin, uint64_t end);
+/* Prints the recorded steps with CFG_BOOT_PROF_PRINT=y */
+void boot_prof_print(void);
+/*
+ * Copies the recorded steps, in the order they ended, into @entries
+ * which can hold @*count elements. @*count is updated with the number of
+ * elements needed. Returns TEE_ERROR_SHORT_BUFFER if @entries is too
+ * small.
+ */
+TEE_Result boot_prof_get(struct boot_prof_entry *entries, size_t *count);
+#else
+static inline uint64_t boot_prof_begin(void)
+{
+	return 0;
+}
+
+static inline void boot_prof_end(const char *name __unused,
+				 uint32_t level __unused,
+				 uint64_t begin __unused)
+{
+}
+
+static inline void boot_prof_mmu_setup(uint64_t begin __unused,
+				       uint64_t end __unused)
+{
+}
+
+static inline void boot_prof_print(void)
+{
+}
+
+static inline TEE_Result boot_prof_get(struct boot_prof_entry *e __unused,
+				       size_t *count __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#endif /* __KERNEL_BOOT_PROF_H */
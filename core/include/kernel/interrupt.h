@@ -5,6 +5,7 @@
 #ifndef __KERNEL_INTERRUPT_H
 #define __KERNEL_INTERRUPT_H
 
+#include <stdbool.h>
 #include <types_ext.h>
 #include <sys/queue.h>
 #include <util.h>
@@ -40,6 +41,17 @@ struct itr_handler {
 	SLIST_ENTRY(itr_handler) link;
 };
 
+/*
+ * Deferred work of an interrupt handler, the bottom half which can't run
+ * with interrupts masked. @func is called in a thread with foreign
+ * interrupts enabled.
+ */
+struct itr_work {
+	void (*func)(struct itr_work *work);
+	unsigned int queued;
+	SLIST_ENTRY(itr_work) link;
+};
+
 void itr_init(struct itr_chip *data);
 void itr_handle(size_t it);
 
@@ -59,6 +71,16 @@ void itr_raise_sgi(size_t it, uint8_t cpu_mask);
  */
 void itr_set_affinity(size_t it, uint8_t cpu_mask);
 
+/*
+ * Queues @work on the queue of the current core, to be run in a thread.
+ * Normal world is asked to do a OPTEE_MSG_CMD_DO_BOTTOM_HALF call if it
+ * has enabled asynchronous notifications, else the work is run at the
+ * next standard call. Returns false if @work is already queued.
+ */
+bool itr_queue_work(struct itr_work *work);
+/* Runs the work queued on all the cores, in thread context */
+void itr_run_work(void);
+
 /*
  * __weak overridable function which is called when a secure interrupt is
  * received. The default function calls panic() immediately, platforms which
@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __KERNEL_LOCK_PROF_H
+#define __KERNEL_LOCK_PROF_H
+
+#include <compiler.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <tee_api_types.h>
+
+#define LOCK_PROF_MUTEX		0
+#define LOCK_PROF_MUTEX_READ	1
+#define LOCK_PROF_SPINLOCK	2
+
+#define LOCK_PROF_SITE_LEN	40
+
+/*
+ * struct lock_prof_stats - contention statistics of one lock call site
+ * @lock:		address of the lock
+ * @type:		LOCK_PROF_*
+ * @line:		line of the call site
+ * @site:		file (mutexes) or function (spinlocks) of the call site,
+ *			truncated from the start if needed
+ * @acquisitions:	number of times the lock was taken, not accounted for
+ *			spinlocks other than the pager lock
+ * @contended:		number of times the lock had to be waited for
+ * @wait_us:		total time spent spinning or sleeping in normal world
+ *			waiting for the lock
+ * @max_wait_us:	longest wait
+ * @hold_us:		total time the lock was held, only accounted for
+ *			write locked mutexes and the pager lock
+ * @max_hold_us:	longest hold
+ */
+struct lock_prof_stats {
+	uint64_t lock;
+	uint32_t type;
+	uint32_t line;
+	char site[LOCK_PROF_SITE_LEN];
+	uint32_t acquisitions;
+	uint32_t contended;
+	uint64_t wait_us;
+	uint64_t max_wait_us;
+	uint64_t hold_us;
+	uint64_t max_hold_us;
+};
+
+struct lock_prof_site;
+
+/* Holder of a lock, used to account the hold time */
+struct lock_prof_hold {
+	struct lock_prof_site *site;
+	uint64_t begin;
+};
+
+#ifdef CFG_LOCK_PROF
+/* Returns the timestamp to pass as @wait_begin below */
+uint64_t lock_prof_now(void);
+/*
+ * Accounts an acquisition of @lock at @site:@line. @wait_begin is 0 if
+ * the lock was taken without waiting. If @hold isn't NULL it records the
+ * holder until lock_prof_released() is called.
+ */
+void lock_prof_acquired(struct lock_prof_hold *hold, const void *lock,
+			uint32_t type, const char *site, int line,
+			uint64_t wait_begin);
+void lock_prof_released(struct lock_prof_hold *hold);
+/* Accounts a spinlock which was taken after spinning since @wait_begin */
+void lock_prof_spin_contended(const void *lock, const char *func, int line,
+			      uint64_t wait_begin);
+/*
+ * Copies the statistics of the @*count call sites which waited the
+ * longest into @stats, sorted by decreasing wait time. @*count is updated
+ * with the number of elements copied.
+ */
+TEE_Result lock_prof_get(struct lock_prof_stats *stats, size_t *count,
+			 bool reset);
+#else
+static inline uint64_t lock_prof_now(void)
+{
+	return 0;
+}
+
+static inline void lock_prof_acquired(struct lock_prof_hold *hold __unused,
+				      const void *lock __unused,
+				      uint32_t type __unused,
+				      const char *site __unused,
+				      int line __unused,
+				      uint64_t wait_begin __unused)
+{
+}
+
+static inline void lock_prof_released(struct lock_prof_hold *hold __unused)
+{
+}
+
+static inline void lock_prof_spin_contended(const void *lock __unused,
+					    const char *func __unused,
+					    int line __unused,
+					    uint64_t wait_begin __unused)
+{
+}
+
+static inline TEE_Result lock_prof_get(struct lock_prof_stats *stats __unused,
+				       size_t *count __unused,
+				       bool reset __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#endif /* __KERNEL_LOCK_PROF_H */
@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __KERNEL_NOTIF_H
+#define __KERNEL_NOTIF_H
+
+#include <compiler.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <tee_api_types.h>
+
+/*
+ * Notifications are keys shared with normal world, the keys of the wait
+ * queues. A thread waits for a key in normal world and is woken up when
+ * the key is sent.
+ *
+ * Sending a key is normally done with an RPC, which needs a thread to
+ * return to normal world and back. Once normal world has enabled
+ * asynchronous notifications the key is instead recorded as pending and
+ * an interrupt is raised to normal world, which fetches the pending keys
+ * with OPTEE_SMC_GET_ASYNC_NOTIF_VALUE.
+ *
+ * NOTIF_VALUE_DO_BOTTOM_HALF and keys above NOTIF_ASYNC_VALUE_MAX are
+ * always sent with an RPC. As an asynchronous notification
+ * NOTIF_VALUE_DO_BOTTOM_HALF asks normal world to do an
+ * OPTEE_MSG_CMD_DO_BOTTOM_HALF call.
+ */
+#define NOTIF_ASYNC_VALUE_MAX		63
+#define NOTIF_VALUE_DO_BOTTOM_HALF	0
+
+/* Waits in normal world until @value is sent */
+TEE_Result notif_wait(uint32_t value);
+/* Wakes up the thread waiting for @value, or the next one to wait for it */
+TEE_Result notif_send(uint32_t value);
+/*
+ * Sends @value as an asynchronous notification, may be called with
+ * interrupts masked. Returns TEE_ERROR_NOT_SUPPORTED if normal world
+ * hasn't enabled them.
+ */
+TEE_Result notif_send_async(uint32_t value);
+
+#ifdef CFG_CORE_ASYNC_NOTIF
+/* Called when normal world is ready to receive asynchronous notifications */
+void notif_async_enable(void);
+/*
+ * Returns the next pending value in @value, @value_valid is false if
+ * there's none. @value_pending is true if there are more values pending.
+ */
+void notif_async_get_value(uint32_t *value, bool *value_valid,
+			   bool *value_pending);
+#else
+static inline void notif_async_enable(void)
+{
+}
+
+static inline void notif_async_get_value(uint32_t *value __unused,
+					 bool *value_valid,
+					 bool *value_pending)
+{
+	*value_valid = false;
+	*value_pending = false;
+}
+#endif
+
+#endif /* __KERNEL_NOTIF_H */
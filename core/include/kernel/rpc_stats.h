@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __KERNEL_RPC_STATS_H
+#define __KERNEL_RPC_STATS_H
+
+#include <kernel/thread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <types_ext.h>
+
+/* RPC commands with an ID above this are not accounted */
+#define RPC_STATS_MAX_CMD	32
+#define RPC_STATS_NUM_BUCKETS	32
+
+/*
+ * struct rpc_cmd_stats - statistics of one RPC command
+ * @cmd:		OPTEE_RPC_CMD_*
+ * @count:		number of RPCs
+ * @total_us:		total time spent in normal world
+ * @max_us:		longest time spent in normal world
+ * @bytes_to_ree:	sum of the sizes of IN and INOUT memrefs
+ * @bytes_from_ree:	sum of the sizes of OUT and INOUT memrefs
+ * @hist:		latency histogram, @hist[n] counts the RPCs which
+ *			took [2^n, 2^(n+1)) microseconds, @hist[0] also
+ *			includes those which took less than a microsecond
+ */
+struct rpc_cmd_stats {
+	uint32_t cmd;
+	uint32_t count;
+	uint64_t total_us;
+	uint64_t max_us;
+	uint64_t bytes_to_ree;
+	uint64_t bytes_from_ree;
+	uint32_t hist[RPC_STATS_NUM_BUCKETS];
+};
+
+#ifdef CFG_WITH_STATS
+/* Returns the timestamp to pass to rpc_stats_add() */
+uint64_t rpc_stats_begin(void);
+/* Accounts an RPC which returned from normal world */
+void rpc_stats_add(uint32_t cmd, uint64_t begin, size_t num_params,
+		   const struct thread_param *params);
+/*
+ * Copies the statistics of the RPC commands used so far into @stats
+ * which can hold @*count elements, @*count is updated with the number of
+ * elements needed. Returns TEE_ERROR_SHORT_BUFFER if @stats is too small.
+ */
+TEE_Result rpc_stats_get(struct rpc_cmd_stats *stats, size_t *count,
+			 bool reset);
+#else
+static inline uint64_t rpc_stats_begin(void)
+{
+	return 0;
+}
+
+static inline void rpc_stats_add(uint32_t cmd __unused,
+				 uint64_t begin __unused,
+				 size_t num_params __unused,
+				 const struct thread_param *params __unused)
+{
+}
+#endif
+
+#endif /* __KERNEL_RPC_STATS_H */
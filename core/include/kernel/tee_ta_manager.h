@@ -13,6 +13,7 @@
 #include <sys/queue.h>
 #include <tee_api_types.h>
 #include <tee_api_types.h>
+#include <tee_syscall_numbers.h>
 #include <types_ext.h>
 #include <user_ta_header.h>
 #include <utee_types.h>
@@ -78,6 +79,41 @@ struct sample_buf {
 };
 #endif
 
+#if defined(CFG_TA_SYSCALL_PROF)
+/* Profile of one syscall in a session, times are in CNTPCT ticks */
+struct syscall_prof {
+	uint32_t count;		/* Number of calls */
+	uint64_t total;		/* Total time spent in the syscall */
+	uint64_t max;		/* Longest call */
+};
+#endif
+
+#if defined(CFG_WITH_STATS)
+/*
+ * Resources used by a TA context, times are in CNTPCT ticks
+ * @utime:		time spent in user mode
+ * @ktime:		time spent in syscalls, not counting RPCs
+ * @rpc_time:		time spent in normal world serving RPCs
+ * @user_entered:	when user mode was last entered, 0 if not in user mode
+ * @rpcs:		number of RPCs
+ * @pager_faults:	number of page faults in user mappings
+ * @ram:		secure memory currently mapped in user space
+ * @ram_peak:		high-water mark of @ram
+ * @syscalls:		number of calls of each syscall
+ */
+struct tee_ta_ctx_stats {
+	uint64_t utime;
+	uint64_t ktime;
+	uint64_t rpc_time;
+	uint64_t user_entered;
+	uint32_t rpcs;
+	uint32_t pager_faults;
+	size_t ram;
+	size_t ram_peak;
+	uint32_t syscalls[TEE_SCN_MAX + 1];
+};
+#endif
+
 /* Context of a loaded TA */
 struct tee_ta_ctx {
 	TEE_UUID uuid;
@@ -90,6 +126,9 @@ struct tee_ta_ctx {
 	bool busy;		/* Context is busy and cannot be entered */
 	bool initializing;	/* Context is initializing */
 	struct condvar busy_cv;	/* CV used when context is busy */
+#if defined(CFG_WITH_STATS)
+	struct tee_ta_ctx_stats stats; /* Resource accounting */
+#endif
 };
 
 struct tee_ta_session {
@@ -113,6 +152,9 @@ struct tee_ta_session {
 #if defined(CFG_FTRACE_SUPPORT)
 	struct ftrace_buf *fbuf; /* ftrace buffer */
 #endif
+#if defined(CFG_TA_SYSCALL_PROF)
+	struct syscall_prof *sprof; /* Indexed by syscall number */
+#endif
 };
 
 /* Registered contexts */
@@ -164,17 +206,33 @@ struct tee_ta_session *tee_ta_find_session(uint32_t id,
 struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
 			struct tee_ta_session_head *open_sessions);
 
+/*
+ * Same as tee_ta_get_session() with @exclusive true, except that sessions
+ * of stateless pseudo TAs are not locked, their commands can be invoked
+ * concurrently.
+ */
+struct tee_ta_session *tee_ta_get_invoke_session(uint32_t id,
+			struct tee_ta_session_head *open_sessions);
+
 void tee_ta_put_session(struct tee_ta_session *sess);
 
-#if defined(CFG_TA_GPROF_SUPPORT)
+#if defined(CFG_TA_GPROF_SUPPORT) || defined(CFG_WITH_STATS)
 void tee_ta_update_session_utime_suspend(void);
 void tee_ta_update_session_utime_resume(void);
-void tee_ta_gprof_sample_pc(vaddr_t pc);
 #else
 static inline void tee_ta_update_session_utime_suspend(void) {}
 static inline void tee_ta_update_session_utime_resume(void) {}
+#endif
+#if defined(CFG_TA_GPROF_SUPPORT)
+void tee_ta_gprof_sample_pc(vaddr_t pc);
+#else
 static inline void tee_ta_gprof_sample_pc(vaddr_t pc __unused) {}
 #endif
+#if defined(CFG_WITH_STATS)
+void tee_ta_stats_add_rpc(uint64_t ticks);
+#else
+static inline void tee_ta_stats_add_rpc(uint64_t ticks __unused) {}
+#endif
 #if defined(CFG_FTRACE_SUPPORT)
 void tee_ta_ftrace_update_times_suspend(void);
 void tee_ta_ftrace_update_times_resume(void);
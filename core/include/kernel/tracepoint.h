@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __KERNEL_TRACEPOINT_H
+#define __KERNEL_TRACEPOINT_H
+
+#include <compiler.h>
+#include <pta_tracepoint.h>
+#include <stdint.h>
+#include <types_ext.h>
+#include <util.h>
+
+/*
+ * Static tracepoints. Each event is declared below with a fixed ID (see
+ * <pta_tracepoint.h>) and typed arguments, which gives a trace_<name>()
+ * function. When CFG_CORE_TRACEPOINTS=n the functions are empty, else
+ * they record an event in the per-core ring of the current core if the
+ * event is enabled by the tracepoint pseudo-TA.
+ */
+
+#ifdef CFG_CORE_TRACEPOINTS
+extern uint32_t tp_event_mask;
+
+void __tp_record(uint32_t id, uint64_t arg0, uint64_t arg1);
+
+#define DEFINE_TRACEPOINT(name, id, type0, type1)			\
+	static inline void trace_##name(type0 arg0, type1 arg1)		\
+	{								\
+		if (tp_event_mask & BIT32(id))				\
+			__tp_record((id), arg0, arg1);			\
+	}
+#else
+#define DEFINE_TRACEPOINT(name, id, type0, type1)			\
+	static inline void trace_##name(type0 arg0 __unused,		\
+					type1 arg1 __unused)		\
+	{								\
+	}
+#endif
+
+DEFINE_TRACEPOINT(smc_entry, TP_SMC_ENTRY, uint32_t, paddr_t)
+DEFINE_TRACEPOINT(smc_exit, TP_SMC_EXIT, uint32_t, uint32_t)
+DEFINE_TRACEPOINT(rpc_out, TP_RPC_OUT, uint32_t, size_t)
+DEFINE_TRACEPOINT(rpc_in, TP_RPC_IN, uint32_t, uint32_t)
+DEFINE_TRACEPOINT(thread_alloc, TP_THREAD_ALLOC, size_t, uint32_t)
+DEFINE_TRACEPOINT(thread_free, TP_THREAD_FREE, size_t, uint32_t)
+DEFINE_TRACEPOINT(pager_fault, TP_PAGER_FAULT, vaddr_t, uint32_t)
+DEFINE_TRACEPOINT(mutex_sleep, TP_MUTEX_SLEEP, vaddr_t, int)
+DEFINE_TRACEPOINT(mutex_wake, TP_MUTEX_WAKE, vaddr_t, int)
+DEFINE_TRACEPOINT(storage_rpc, TP_STORAGE_RPC, uint32_t, uint32_t)
+DEFINE_TRACEPOINT(storage_rpc_done, TP_STORAGE_RPC_DONE, uint32_t, uint32_t)
+
+#endif /* __KERNEL_TRACEPOINT_H */
@@ -299,6 +299,29 @@ struct optee_msg_arg {
  * [in] param[0].u.rmem.shm_ref		holds shared memory reference
  * [in] param[0].u.rmem.offs		0
  * [in] param[0].u.rmem.size		0
+ *
+ * OPTEE_MSG_CMD_INVOKE_BATCH invokes several commands of previously opened
+ * sessions, one after the other, in a single call. struct
+ * optee_msg_arg::func and ::session are not used. The parameters hold a
+ * sequence of entries, each entry starts with a parameter tagged as meta
+ * followed by the parameters of the command:
+ * [in] param[n].attr			OPTEE_MSG_ATTR_TYPE_VALUE_INOUT |
+ *					OPTEE_MSG_ATTR_META
+ * [in] param[n].u.value.a		session
+ * [in] param[n].u.value.b		Trusted Application function
+ * [in] param[n].u.value.c		number of parameters of the command,
+ *					0 to 4, in param[n + 1] and onwards
+ * [out] param[n].u.value.a		return value of the command
+ * [out] param[n].u.value.b		origin of the return value
+ * The commands are all invoked even if some of them fail. struct
+ * optee_msg_arg::ret is TEE_SUCCESS unless the sequence of entries is
+ * malformed, in which case no command is invoked. Only supported if
+ * OPTEE_SMC_SEC_CAP_INVOKE_BATCH is reported.
+ *
+ * OPTEE_MSG_CMD_DO_BOTTOM_HALF lets secure world run the deferred work of
+ * its interrupt handlers. It's issued when the asynchronous notification
+ * of value 0 is received, see OPTEE_SMC_GET_ASYNC_NOTIF_VALUE.
+ * No parameters are used.
  */
 #define OPTEE_MSG_CMD_OPEN_SESSION	0
 #define OPTEE_MSG_CMD_INVOKE_COMMAND	1
@@ -306,6 +329,13 @@ struct optee_msg_arg {
 #define OPTEE_MSG_CMD_CANCEL		3
 #define OPTEE_MSG_CMD_REGISTER_SHM	4
 #define OPTEE_MSG_CMD_UNREGISTER_SHM	5
+#define OPTEE_MSG_CMD_DO_BOTTOM_HALF	6
+
+/*
+ * Commands from 0x1000 are specific to this implementation, upstream
+ * OP-TEE doesn't assign them.
+ */
+#define OPTEE_MSG_CMD_INVOKE_BATCH	0x1000
 #define OPTEE_MSG_FUNCID_CALL_WITH_ARG	0x0004
 
 #endif /* _OPTEE_MSG_H */
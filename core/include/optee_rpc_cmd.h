@@ -325,6 +325,92 @@
  */
 #define OPTEE_RPC_SOCKET_IOCTL	5
 
+/*
+ * Set up streaming on a socket
+ *
+ * A streaming socket has a pair of rings in shared memory, the TX ring
+ * followed by the RX ring. Each ring is a header of two 32-bit little
+ * endian counters, head at offset 0 and tail at offset 4, followed at
+ * offset 8 by value[1].a bytes of data. head is the total number of bytes
+ * written by the producer and tail the total number of bytes read by the
+ * consumer, the counters wrap at 2^32. Data is at offset head or tail
+ * modulo the size of the data, which is a power of two.
+ *
+ * Secure world produces into the TX ring and normal world into the RX
+ * ring. Each side only updates its own counter, the data is written
+ * before the counter is updated and read after the counter is read.
+ *
+ * Normal world may fill the RX ring as data is received on the socket.
+ * Data in the TX ring is sent when requested with
+ * OPTEE_RPC_SOCKET_STREAM_SYNC and before the socket is closed.
+ *
+ * [in]     value[0].a	    OPTEE_RPC_SOCKET_SET_STREAM
+ * [in]     value[0].b	    TA instance id
+ * [in]     value[0].c	    Socket handle
+ * [in]     value[1].a	    Size of the data of each ring
+ * [in]     memref[2]	    The TX ring followed by the RX ring
+ */
+#define OPTEE_RPC_SOCKET_SET_STREAM	6
+
+/*
+ * Synchronize the rings of a streaming socket
+ *
+ * Sends all data in the TX ring. Then, if OPTEE_RPC_SOCKET_SYNC_RECV is
+ * set and the RX ring is empty, waits for data to receive into the RX
+ * ring.
+ *
+ * [in]     value[0].a	    OPTEE_RPC_SOCKET_STREAM_SYNC
+ * [in]     value[0].b	    TA instance id
+ * [in]     value[0].c	    Socket handle
+ * [in]     value[1].a	    Timeout ms or OPTEE_RPC_SOCKET_TIMEOUT_*
+ * [in]     value[1].b	    Flags, OPTEE_RPC_SOCKET_SYNC_*
+ */
+#define OPTEE_RPC_SOCKET_STREAM_SYNC	7
+
+#define OPTEE_RPC_SOCKET_SYNC_RECV	(1 << 0)
+
+/*
+ * Send several messages on a socket
+ *
+ * Each message is sent with one send operation, one datagram each on an
+ * UDP socket. Sending stops at the first message that isn't completely
+ * transmitted.
+ *
+ * [in]     value[0].a	    OPTEE_RPC_SOCKET_SENDMMSG
+ * [in]     value[0].b	    TA instance id
+ * [in]     value[0].c	    Socket handle
+ * [in]     memref[1]	    The messages to transmit, back to back
+ * [in/out] memref[2]	    Array of uint32_t, length of each message, on
+ *			    return the number of transmitted bytes of each
+ *			    message sent
+ * [in]     value[3].a	    Timeout ms or OPTEE_RPC_SOCKET_TIMEOUT_*
+ * [out]    value[3].b	    Number of messages sent, the last one may be
+ *			    partly transmitted, also valid when an error
+ *			    is returned
+ */
+#define OPTEE_RPC_SOCKET_SENDMMSG	8
+
+/*
+ * Receive several messages on a socket
+ *
+ * Each message is received with one receive operation, one datagram
+ * each on an UDP socket. The timeout only applies to the first message,
+ * receiving stops when no more messages can be received without waiting.
+ *
+ * [in]     value[0].a	    OPTEE_RPC_SOCKET_RECVMMSG
+ * [in]     value[0].b	    TA instance id
+ * [in]     value[0].c	    Socket handle
+ * [out]    memref[1]	    Buffer to receive, split in consecutive slots
+ *			    with the sizes in memref[2]
+ * [in/out] memref[2]	    Array of uint32_t, size of each slot, on return
+ *			    the number of received bytes of each message
+ *			    received
+ * [in]     value[3].a	    Timeout ms or OPTEE_RPC_SOCKET_TIMEOUT_*
+ * [out]    value[3].b	    Number of messages received, also valid when
+ *			    an error is returned
+ */
+#define OPTEE_RPC_SOCKET_RECVMMSG	9
+
 /* End of definition of protocol for command OPTEE_RPC_CMD_SOCKET */
 
 #endif /*__OPTEE_RPC_CMD_H*/
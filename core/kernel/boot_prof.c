@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#include <arm.h>
+#include <compiler.h>
+#include <config.h>
+#include <keep.h>
+#include <kernel/boot_prof.h>
+#include <kernel/delay.h>
+#include <kernel/spinlock.h>
+#include <string.h>
+#include <string_ext.h>
+#include <trace.h>
+#include <util.h>
+
+#define BOOT_PROF_MAX_ENTRIES	64
+
+struct boot_prof_step {
+	const char *name;
+	uint32_t level;
+	uint64_t begin;
+	uint64_t end;
+};
+
+/*
+ * Steps are recorded from the very start of the boot, before the pager
+ * is initialized, hence the functions kept in the unpaged area.
+ */
+static unsigned int boot_prof_lock __nex_bss = SPINLOCK_UNLOCK;
+static struct boot_prof_step steps[BOOT_PROF_MAX_ENTRIES] __nex_bss;
+static size_t num_steps __nex_bss;
+static size_t num_dropped __nex_bss;
+static uint64_t mmu_begin __nex_bss;
+static uint64_t mmu_end __nex_bss;
+
+uint64_t boot_prof_begin(void)
+{
+	return read_cntpct();
+}
+KEEP_PAGER(boot_prof_begin);
+
+void boot_prof_end(const char *name, uint32_t level, uint64_t begin)
+{
+	uint64_t end = read_cntpct();
+	uint32_t exceptions = cpu_spin_lock_xsave(&boot_prof_lock);
+
+	if (num_steps < BOOT_PROF_MAX_ENTRIES) {
+		steps[num_steps] = (struct boot_prof_step){
+			.name = name, .level = level,
+			.begin = begin, .end = end,
+		};
+		num_steps++;
+	} else {
+		num_dropped++;
+	}
+
+	cpu_spin_unlock_xrestore(&boot_prof_lock, exceptions);
+}
+KEEP_PAGER(boot_prof_end);
+
+void boot_prof_mmu_setup(uint64_t begin, uint64_t end)
+{
+	mmu_begin = begin;
+	mmu_end = end;
+}
+KEEP_PAGER(boot_prof_mmu_setup);
+
+static void fill_entry(struct boot_prof_entry *e, const char *name,
+		       uint32_t level, uint64_t begin, uint64_t end)
+{
+	memset(e, 0, sizeof(*e));
+	strlcpy(e->name, name, sizeof(e->name));
+	e->level = level;
+	e->begin_us = arm_cnt_cnt2us(begin);
+	e->duration_us = arm_cnt_cnt2us(end - begin);
+}
+
+/*
+ * The MMU setup is reported as the first step if it was recorded. Steps
+ * recorded after boot, such as the RPMB setup, are only appended so the
+ * entries below the returned number don't change.
+ */
+static size_t get_num_entries(void)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&boot_prof_lock);
+	size_t num = num_steps + !!mmu_end;
+
+	cpu_spin_unlock_xrestore(&boot_prof_lock, exceptions);
+
+	return num;
+}
+
+static void get_entry(size_t idx, struct boot_prof_entry *e)
+{
+	if (mmu_end) {
+		if (!idx) {
+			fill_entry(e, "mmu", BOOT_PROF_PHASE, mmu_begin,
+				   mmu_end);
+			return;
+		}
+		idx--;
+	}
+	fill_entry(e, steps[idx].name, steps[idx].level, steps[idx].begin,
+		   steps[idx].end);
+}
+
+void boot_prof_print(void)
+{
+	struct boot_prof_entry e = { };
+	size_t num = 0;
+	size_t n = 0;
+
+	if (!IS_ENABLED(CFG_BOOT_PROF_PRINT))
+		return;
+
+	num = get_num_entries();
+	for (n = 0; n < num; n++) {
+		get_entry(n, &e);
+		if (e.level == BOOT_PROF_PHASE)
+			IMSG("boot: %10"PRIu64" us %8"PRIu64" us %s",
+			     e.begin_us, e.duration_us, e.name);
+		else
+			IMSG("boot: %10"PRIu64" us %8"PRIu64" us   initcall%"
+			     PRIu32" %s", e.begin_us, e.duration_us, e.level,
+			     e.name);
+	}
+	if (num_dropped)
+		IMSG("boot: %zu steps not recorded", num_dropped);
+}
+
+TEE_Result boot_prof_get(struct boot_prof_entry *entries, size_t *count)
+{
+	size_t num = get_num_entries();
+	size_t n = 0;
+
+	if (*count < num) {
+		*count = num;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	for (n = 0; n < num; n++)
+		get_entry(n, entries + n);
+	*count = num;
+
+	return TEE_SUCCESS;
+}
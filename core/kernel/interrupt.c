@@ -3,8 +3,13 @@
  * Copyright (c) 2016-2019, Linaro Limited
  */
 
+#include <atomic.h>
 #include <kernel/interrupt.h>
+#include <kernel/misc.h>
+#include <kernel/notif.h>
 #include <kernel/panic.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
 #include <trace.h>
 #include <assert.h>
 
@@ -16,8 +21,31 @@
  * we begin to modify settings after boot initialization.
  */
 
+/*
+ * Handlers of the interrupts below this number are found with a table
+ * lookup, those of the other interrupts with a walk of a list.
+ */
+#define ITR_TABLE_SIZE		256
+
+SLIST_HEAD(itr_handler_head, itr_handler);
+
+struct itr_work_queue {
+	unsigned int lock;
+	SLIST_HEAD(, itr_work) head;
+};
+
 static struct itr_chip *itr_chip;
-static SLIST_HEAD(, itr_handler) handlers = SLIST_HEAD_INITIALIZER(handlers);
+static struct itr_handler_head itr_table[ITR_TABLE_SIZE];
+static struct itr_handler_head handlers = SLIST_HEAD_INITIALIZER(handlers);
+static struct itr_work_queue work_queues[CFG_TEE_CORE_NB_CORE];
+
+static struct itr_handler_head *get_handlers(size_t it)
+{
+	if (it < ITR_TABLE_SIZE)
+		return itr_table + it;
+
+	return &handlers;
+}
 
 void itr_init(struct itr_chip *chip)
 {
@@ -29,7 +57,7 @@ void itr_handle(size_t it)
 	struct itr_handler *h = NULL;
 	bool was_handled = false;
 
-	SLIST_FOREACH(h, &handlers, link) {
+	SLIST_FOREACH(h, get_handlers(it), link) {
 		if (h->it == it) {
 			if (h->handler(h) == ITRR_HANDLED)
 				was_handled = true;
@@ -48,13 +76,70 @@ void itr_add(struct itr_handler *h)
 {
 	struct itr_handler __maybe_unused *hdl = NULL;
 
-	SLIST_FOREACH(hdl, &handlers, link)
+	SLIST_FOREACH(hdl, get_handlers(h->it), link)
 		if (hdl->it == h->it)
 			assert((hdl->flags & ITRF_SHARED) &&
 			       (h->flags & ITRF_SHARED));
 
 	itr_chip->ops->add(itr_chip, h->it, h->flags);
-	SLIST_INSERT_HEAD(&handlers, h, link);
+	SLIST_INSERT_HEAD(get_handlers(h->it), h, link);
+}
+
+bool itr_queue_work(struct itr_work *work)
+{
+	struct itr_work_queue *q = NULL;
+	unsigned int queued = 0;
+	uint32_t exceptions = 0;
+
+	if (!atomic_cas_uint(&work->queued, &queued, 1))
+		return false;
+
+	exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	q = work_queues + get_core_pos();
+	cpu_spin_lock(&q->lock);
+	SLIST_INSERT_HEAD(&q->head, work, link);
+	cpu_spin_unlock(&q->lock);
+	thread_unmask_exceptions(exceptions);
+
+	/* Without asynchronous notifications it's run by the next std call */
+	notif_send_async(NOTIF_VALUE_DO_BOTTOM_HALF);
+
+	return true;
+}
+
+void itr_run_work(void)
+{
+	struct itr_work_queue *q = NULL;
+	struct itr_work *work = NULL;
+	struct itr_work *next = NULL;
+	struct itr_work *list = NULL;
+	uint32_t exceptions = 0;
+
+	for (q = work_queues; q < work_queues + CFG_TEE_CORE_NB_CORE; q++) {
+		if (!SLIST_FIRST(&q->head))
+			continue;
+
+		exceptions = cpu_spin_lock_xsave(&q->lock);
+		work = SLIST_FIRST(&q->head);
+		SLIST_INIT(&q->head);
+		cpu_spin_unlock_xrestore(&q->lock, exceptions);
+
+		/* The queue is in reverse order */
+		list = NULL;
+		while (work) {
+			next = SLIST_NEXT(work, link);
+			SLIST_NEXT(work, link) = list;
+			list = work;
+			work = next;
+		}
+
+		/* The work may be queued again as soon as it's started */
+		for (work = list; work; work = next) {
+			next = SLIST_NEXT(work, link);
+			atomic_store_uint(&work->queued, 0);
+			work->func(work);
+		}
+	}
 }
 
 void itr_enable(size_t it)
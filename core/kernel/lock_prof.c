@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#include <arm.h>
+#include <keep.h>
+#include <kernel/delay.h>
+#include <kernel/lock_prof.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <stdio.h>
+#include <string.h>
+#include <trace.h>
+#include <util.h>
+
+/* Must be a power of 2 */
+#define LOCK_PROF_NUM_SITES	256
+
+struct lock_prof_site {
+	vaddr_t lock;
+	const char *site;
+	int line;
+	uint32_t type;
+	uint32_t acquisitions;
+	uint32_t contended;
+	uint64_t wait;
+	uint64_t max_wait;
+	uint64_t hold;
+	uint64_t max_hold;
+};
+
+/*
+ * Call sites are never removed so the pointers kept in struct
+ * lock_prof_hold remain valid, a reset only clears the counters.
+ *
+ * @sites_lock is taken without going through cpu_spin_lock() since that
+ * would recurse into the profiler when the lock is contended.
+ */
+static unsigned int sites_lock = SPINLOCK_UNLOCK;
+static struct lock_prof_site sites[LOCK_PROF_NUM_SITES];
+static size_t num_dropped;
+
+static uint32_t lock_sites(void)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+
+	__cpu_spin_lock(&sites_lock);
+	return exceptions;
+}
+KEEP_PAGER(lock_sites);
+
+static void unlock_sites(uint32_t exceptions)
+{
+	__cpu_spin_unlock(&sites_lock);
+	thread_unmask_exceptions(exceptions);
+}
+KEEP_PAGER(unlock_sites);
+
+/* Returns the entry of a call site, adding it if needed. */
+static struct lock_prof_site *get_site(vaddr_t lock, uint32_t type,
+				       const char *site, int line)
+{
+	size_t h = (lock ^ (vaddr_t)site ^ line) * 0x9e3779b1;
+	struct lock_prof_site *s = NULL;
+	size_t n = 0;
+
+	for (n = 0; n < LOCK_PROF_NUM_SITES; n++) {
+		s = sites + ((h + n) & (LOCK_PROF_NUM_SITES - 1));
+		if (!s->lock) {
+			s->lock = lock;
+			s->type = type;
+			s->site = site;
+			s->line = line;
+			return s;
+		}
+		if (s->lock == lock && s->site == site && s->line == line &&
+		    s->type == type)
+			return s;
+	}
+
+	num_dropped++;
+	return NULL;
+}
+KEEP_PAGER(get_site);
+
+uint64_t lock_prof_now(void)
+{
+	return read_cntpct();
+}
+KEEP_PAGER(lock_prof_now);
+
+void lock_prof_acquired(struct lock_prof_hold *hold, const void *lock,
+			uint32_t type, const char *site, int line,
+			uint64_t wait_begin)
+{
+	uint64_t now = read_cntpct();
+	struct lock_prof_site *s = NULL;
+	uint32_t exceptions = 0;
+
+	exceptions = lock_sites();
+
+	s = get_site((vaddr_t)lock, type, site, line);
+	if (s) {
+		s->acquisitions++;
+		if (wait_begin) {
+			s->contended++;
+			s->wait += now - wait_begin;
+			s->max_wait = MAX(s->max_wait, now - wait_begin);
+		}
+	}
+
+	unlock_sites(exceptions);
+
+	if (hold) {
+		hold->site = s;
+		hold->begin = now;
+	}
+}
+KEEP_PAGER(lock_prof_acquired);
+
+void lock_prof_released(struct lock_prof_hold *hold)
+{
+	struct lock_prof_site *s = hold->site;
+	uint32_t exceptions = 0;
+	uint64_t t = 0;
+
+	if (!s)
+		return;
+
+	t = read_cntpct() - hold->begin;
+	hold->site = NULL;
+
+	exceptions = lock_sites();
+	s->hold += t;
+	s->max_hold = MAX(s->max_hold, t);
+	unlock_sites(exceptions);
+}
+KEEP_PAGER(lock_prof_released);
+
+void lock_prof_spin_contended(const void *lock, const char *func, int line,
+			      uint64_t wait_begin)
+{
+	uint64_t t = read_cntpct() - wait_begin;
+	struct lock_prof_site *s = NULL;
+	uint32_t exceptions = 0;
+
+	exceptions = lock_sites();
+
+	s = get_site((vaddr_t)lock, LOCK_PROF_SPINLOCK, func, line);
+	if (s) {
+		s->contended++;
+		s->wait += t;
+		s->max_wait = MAX(s->max_wait, t);
+	}
+
+	unlock_sites(exceptions);
+}
+KEEP_PAGER(lock_prof_spin_contended);
+
+static void copy_site(struct lock_prof_stats *st,
+		      const struct lock_prof_site *s)
+{
+	const char *name = s->site ? s->site : "?";
+	size_t len = strlen(name);
+
+	/* Keep the end of long file names */
+	if (len >= sizeof(st->site))
+		name += len - sizeof(st->site) + 1;
+
+	memset(st, 0, sizeof(*st));
+	st->lock = s->lock;
+	st->type = s->type;
+	st->line = s->line;
+	snprintf(st->site, sizeof(st->site), "%s", name);
+	st->acquisitions = s->acquisitions;
+	st->contended = s->contended;
+	st->wait_us = arm_cnt_cnt2us(s->wait);
+	st->max_wait_us = arm_cnt_cnt2us(s->max_wait);
+	st->hold_us = arm_cnt_cnt2us(s->hold);
+	st->max_hold_us = arm_cnt_cnt2us(s->max_hold);
+}
+
+TEE_Result lock_prof_get(struct lock_prof_stats *stats, size_t *count,
+			 bool reset)
+{
+	uint8_t taken[LOCK_PROF_NUM_SITES / 8] = { };
+	struct lock_prof_site worst = { };
+	uint32_t exceptions = 0;
+	size_t dropped = 0;
+	size_t idx = 0;
+	size_t n = 0;
+	size_t m = 0;
+
+	/*
+	 * Selection of the sites with the longest total wait. The output
+	 * buffer and the names of the sites may be paged, they're only
+	 * accessed with @sites_lock released.
+	 */
+	for (n = 0; n < *count; n++) {
+		idx = LOCK_PROF_NUM_SITES;
+		exceptions = lock_sites();
+		for (m = 0; m < LOCK_PROF_NUM_SITES; m++) {
+			if (taken[m / 8] & BIT(m % 8))
+				continue;
+			if (!sites[m].acquisitions && !sites[m].contended)
+				continue;
+			if (idx == LOCK_PROF_NUM_SITES ||
+			    sites[m].wait > sites[idx].wait)
+				idx = m;
+		}
+		if (idx != LOCK_PROF_NUM_SITES)
+			worst = sites[idx];
+		unlock_sites(exceptions);
+
+		if (idx == LOCK_PROF_NUM_SITES)
+			break;
+		taken[idx / 8] |= BIT(idx % 8);
+		copy_site(stats + n, &worst);
+	}
+	*count = n;
+
+	exceptions = lock_sites();
+	dropped = num_dropped;
+	if (reset) {
+		for (m = 0; m < LOCK_PROF_NUM_SITES; m++) {
+			sites[m].acquisitions = 0;
+			sites[m].contended = 0;
+			sites[m].wait = 0;
+			sites[m].max_wait = 0;
+			sites[m].hold = 0;
+			sites[m].max_hold = 0;
+		}
+		num_dropped = 0;
+	}
+	unlock_sites(exceptions);
+
+	if (dropped)
+		DMSG("%zu acquisitions of unaccounted call sites", dropped);
+
+	return TEE_SUCCESS;
+}
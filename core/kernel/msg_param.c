@@ -26,13 +26,20 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <io.h>
 #include <kernel/msg_param.h>
+#include <mm/core_memprot.h>
+#include <mm/core_mmu.h>
 #include <mm/mobj.h>
+#include <mm/tee_mm.h>
 #include <optee_msg.h>
 #include <stdio.h>
 #include <types_ext.h>
 #include <util.h>
 
+/* Number of entries in one page of the list, the last links to the next */
+#define PAGE_LIST_ENTRIES	(OPTEE_MSG_NONCONTIG_PAGE_SIZE / sizeof(uint64_t))
+
 /**
  * msg_param_extract_pages() - extract list of pages from
  * OPTEE_MSG_ATTR_NONCONTIG buffer.
@@ -56,59 +63,61 @@
  *
  * This function extracts data from arrays into one array pointed by @pages
  *
+ * The pages of the list are mapped one after the other in a single page
+ * of virtual memory reserved for the duration of the call, the addresses
+ * of the pages are checked by the caller when the mobj is created.
+ *
  * @buffer points to data shared with normal world, so some precautions
  * should be taken.
  */
 static bool msg_param_extract_pages(paddr_t buffer, paddr_t *pages,
 				       size_t num_pages)
 {
-	size_t cnt;
-	struct mobj *mobj;
-	paddr_t page;
-	uint64_t *va;
+	tee_mm_entry_t *mm = NULL;
+	paddr_t page = buffer;
+	paddr_t page_bits = 0;
+	uint64_t *list = NULL;
+	vaddr_t window = 0;
+	bool mapped = false;
 	bool ret = false;
+	size_t cnt = 0;
+	size_t n = 0;
+	size_t m = 0;
 
-	if (buffer & SMALL_PAGE_MASK)
+	mm = tee_mm_alloc(&tee_mm_shm, SMALL_PAGE_SIZE);
+	if (!mm)
 		return false;
+	window = tee_mm_get_smem(mm);
+	list = (uint64_t *)window;
 
-	/*
-	 * There we map first page of array.
-	 * mobj_mapped_shm_alloc() will check if page resides in nonsec ddr
-	 */
-	mobj = mobj_mapped_shm_alloc(&buffer, 1, 0, 0);
-	if (!mobj)
-		return false;
-
-	va = mobj_get_va(mobj, 0);
-	assert(va);
-
-	for (cnt = 0; cnt < num_pages; cnt++, va++) {
-		/*
-		 * If we about to roll over page boundary, then last entry holds
-		 * address of next page of array. Unmap current page and map
-		 * next one
-		 */
-		if (!((vaddr_t)(va + 1) & SMALL_PAGE_MASK)) {
-			page = *va;
-			if (page & SMALL_PAGE_MASK)
-				goto out;
-
-			mobj_put(mobj);
-			mobj = mobj_mapped_shm_alloc(&page, 1, 0, 0);
-			if (!mobj)
-				goto out;
+	while (true) {
+		if ((page & SMALL_PAGE_MASK) ||
+		    !core_pbuf_is(CORE_MEM_NON_SEC, page, SMALL_PAGE_SIZE))
+			goto out;
+		if (core_mmu_map_pages(window, &page, 1, MEM_AREA_NSEC_SHM))
+			goto out;
+		mapped = true;
 
-			va = mobj_get_va(mobj, 0);
-			assert(va);
+		n = MIN(num_pages - cnt, PAGE_LIST_ENTRIES - 1);
+		for (m = 0; m < n; m++) {
+			pages[cnt + m] = READ_ONCE(list[m]);
+			page_bits |= pages[cnt + m];
 		}
-		pages[cnt] = *va;
-		if (pages[cnt] & SMALL_PAGE_MASK)
-			goto out;
+		cnt += n;
+		if (cnt == num_pages)
+			break;
+
+		/* Last entry holds the address of the next page of the list */
+		page = READ_ONCE(list[PAGE_LIST_ENTRIES - 1]);
+		core_mmu_unmap_pages(window, 1);
+		mapped = false;
 	}
 
-	ret = true;
+	ret = !(page_bits & SMALL_PAGE_MASK);
 out:
-	mobj_put(mobj);
+	if (mapped)
+		core_mmu_unmap_pages(window, 1);
+	tee_mm_free(mm);
 	return ret;
 }
 
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#include <kernel/interrupt.h>
+#include <kernel/misc.h>
+#include <kernel/notif.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <optee_rpc_cmd.h>
+#include <types_ext.h>
+#include <util.h>
+
+/* Interrupt IDs below this are raised as non-secure SGIs */
+#define NOTIF_NUM_NS_SGI	8
+
+#ifdef CFG_CORE_ASYNC_NOTIF
+static unsigned int notif_lock = SPINLOCK_UNLOCK;
+static bool notif_async_enabled;
+static uint64_t notif_pending;
+
+static void raise_notif_itr(void)
+{
+	size_t it = CFG_CORE_ASYNC_NOTIF_GIC_INTID;
+
+	/* Called with exceptions masked, get_core_pos() is stable */
+	if (it < NOTIF_NUM_NS_SGI)
+		itr_raise_sgi(it, BIT(get_core_pos()));
+	else
+		itr_raise_pi(it);
+}
+
+TEE_Result notif_send_async(uint32_t value)
+{
+	TEE_Result res = TEE_ERROR_NOT_SUPPORTED;
+	uint32_t exceptions = 0;
+
+	if (value > NOTIF_ASYNC_VALUE_MAX)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	exceptions = cpu_spin_lock_xsave(&notif_lock);
+	if (notif_async_enabled) {
+		notif_pending |= BIT64(value);
+		raise_notif_itr();
+		res = TEE_SUCCESS;
+	}
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+
+	return res;
+}
+
+void notif_async_enable(void)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&notif_lock);
+
+	notif_async_enabled = true;
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+}
+
+void notif_async_get_value(uint32_t *value, bool *value_valid,
+			   bool *value_pending)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&notif_lock);
+
+	*value_valid = notif_pending;
+	if (notif_pending) {
+		*value = __builtin_ctzll(notif_pending);
+		notif_pending &= ~BIT64(*value);
+	}
+	*value_pending = notif_pending;
+
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+}
+#else
+TEE_Result notif_send_async(uint32_t value __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+static TEE_Result notif_rpc(uint32_t func, uint32_t value)
+{
+	struct thread_param params = THREAD_PARAM_VALUE(IN, func, value, 0);
+
+	return thread_rpc_cmd(OPTEE_RPC_CMD_WAIT_QUEUE, 1, &params);
+}
+
+TEE_Result notif_wait(uint32_t value)
+{
+	return notif_rpc(OPTEE_RPC_WAIT_QUEUE_SLEEP, value);
+}
+
+TEE_Result notif_send(uint32_t value)
+{
+	if (value != NOTIF_VALUE_DO_BOTTOM_HALF &&
+	    value <= NOTIF_ASYNC_VALUE_MAX && !notif_send_async(value))
+		return TEE_SUCCESS;
+
+	return notif_rpc(OPTEE_RPC_WAIT_QUEUE_WAKEUP, value);
+}
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#include <arm.h>
+#include <kernel/delay.h>
+#include <kernel/rpc_stats.h>
+#include <kernel/spinlock.h>
+#include <kernel/tee_ta_manager.h>
+#include <string.h>
+#include <tee_api_types.h>
+#include <util.h>
+
+static unsigned int rpc_stats_lock = SPINLOCK_UNLOCK;
+static struct rpc_cmd_stats rpc_stats[RPC_STATS_MAX_CMD];
+
+static size_t us_to_bucket(uint64_t us)
+{
+	size_t n = 0;
+
+	if (!us)
+		return 0;
+
+	n = sizeof(us) * 8 - 1 - __builtin_clzll(us);
+
+	return MIN(n, (size_t)RPC_STATS_NUM_BUCKETS - 1);
+}
+
+uint64_t rpc_stats_begin(void)
+{
+	return read_cntpct();
+}
+
+void rpc_stats_add(uint32_t cmd, uint64_t begin, size_t num_params,
+		   const struct thread_param *params)
+{
+	uint64_t ticks = read_cntpct() - begin;
+	uint64_t us = arm_cnt_cnt2us(ticks);
+	uint64_t bytes_from_ree = 0;
+	uint64_t bytes_to_ree = 0;
+	struct rpc_cmd_stats *s = NULL;
+	uint32_t exceptions = 0;
+	size_t n = 0;
+
+	tee_ta_stats_add_rpc(ticks);
+
+	if (cmd >= RPC_STATS_MAX_CMD)
+		return;
+
+	for (n = 0; n < num_params; n++) {
+		switch (params[n].attr) {
+		case THREAD_PARAM_ATTR_MEMREF_IN:
+			bytes_to_ree += params[n].u.memref.size;
+			break;
+		case THREAD_PARAM_ATTR_MEMREF_OUT:
+			bytes_from_ree += params[n].u.memref.size;
+			break;
+		case THREAD_PARAM_ATTR_MEMREF_INOUT:
+			bytes_to_ree += params[n].u.memref.size;
+			bytes_from_ree += params[n].u.memref.size;
+			break;
+		default:
+			break;
+		}
+	}
+
+	exceptions = cpu_spin_lock_xsave(&rpc_stats_lock);
+
+	s = rpc_stats + cmd;
+	s->count++;
+	s->total_us += us;
+	s->max_us = MAX(s->max_us, us);
+	s->bytes_to_ree += bytes_to_ree;
+	s->bytes_from_ree += bytes_from_ree;
+	s->hist[us_to_bucket(us)]++;
+
+	cpu_spin_unlock_xrestore(&rpc_stats_lock, exceptions);
+}
+
+TEE_Result rpc_stats_get(struct rpc_cmd_stats *stats, size_t *count,
+			 bool reset)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t exceptions = 0;
+	size_t cmd = 0;
+	size_t n = 0;
+
+	exceptions = cpu_spin_lock_xsave(&rpc_stats_lock);
+
+	for (cmd = 0; cmd < RPC_STATS_MAX_CMD; cmd++)
+		if (rpc_stats[cmd].count)
+			n++;
+
+	if (n > *count) {
+		res = TEE_ERROR_SHORT_BUFFER;
+		goto out;
+	}
+
+	n = 0;
+	for (cmd = 0; cmd < RPC_STATS_MAX_CMD; cmd++) {
+		if (!rpc_stats[cmd].count)
+			continue;
+		stats[n] = rpc_stats[cmd];
+		stats[n].cmd = cmd;
+		n++;
+	}
+
+	if (reset)
+		memset(rpc_stats, 0, sizeof(rpc_stats));
+out:
+	cpu_spin_unlock_xrestore(&rpc_stats_lock, exceptions);
+	*count = n;
+
+	return res;
+}
@@ -1,15 +1,19 @@
 srcs-$(CFG_CORE_SANITIZE_KADDRESS) += asan.c
 cflags-remove-asan.c-y += $(cflags_kasan)
 srcs-y += assert.c
+srcs-$(CFG_BOOT_PROF) += boot_prof.c
 srcs-y += console.c
 srcs-$(CFG_DT) += dt.c
 srcs-y += pm.c
 srcs-y += handle.c
 srcs-y += interrupt.c
 srcs-$(CFG_LOCKDEP) += lockdep.c
+srcs-$(CFG_LOCK_PROF) += lock_prof.c
 srcs-$(CFG_CORE_DYN_SHM) += msg_param.c
+srcs-y += notif.c
 srcs-y += panic.c
 srcs-y += refcount.c
+srcs-$(CFG_WITH_STATS) += rpc_stats.c
 srcs-y += tee_misc.c
 srcs-y += tee_ta_manager.c
 srcs-$(CFG_CORE_SANITIZE_UNDEFINED) += ubsan.c
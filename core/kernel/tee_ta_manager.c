@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <tee_api_types.h>
+#include <tee/arch_svc.h>
 #include <tee/entry_std.h>
 #include <tee/tee_obj.h>
 #include <tee/tee_svc_cryp.h>
@@ -216,8 +217,9 @@ struct tee_ta_session *tee_ta_find_session(uint32_t id,
 	return s;
 }
 
-struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
-			struct tee_ta_session_head *open_sessions)
+static struct tee_ta_session *get_session(uint32_t id, bool exclusive,
+					  bool share_stateless,
+					  struct tee_ta_session_head *open_sessions)
 {
 	struct tee_ta_session *s;
 
@@ -234,6 +236,9 @@ struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
 		s->ref_count++;
 		if (!exclusive)
 			break;
+		if (share_stateless && s->ctx &&
+		    is_stateless_pseudo_ta_ctx(s->ctx))
+			break;
 
 		assert(s->lock_thread != thread_get_id());
 
@@ -254,6 +259,18 @@ struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
 	return s;
 }
 
+struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
+			struct tee_ta_session_head *open_sessions)
+{
+	return get_session(id, exclusive, false, open_sessions);
+}
+
+struct tee_ta_session *tee_ta_get_invoke_session(uint32_t id,
+			struct tee_ta_session_head *open_sessions)
+{
+	return get_session(id, true, true, open_sessions);
+}
+
 static void tee_ta_unlink_session(struct tee_ta_session *s,
 			struct tee_ta_session_head *open_sessions)
 {
@@ -286,9 +303,14 @@ static void destroy_session(struct tee_ta_session *s,
 	}
 #endif
 
+	user_ta_dump_syscall_prof(s);
+
 	tee_ta_unlink_session(s, open_sessions);
 #if defined(CFG_TA_GPROF_SUPPORT)
 	free(s->sbuf);
+#endif
+#if defined(CFG_TA_SYSCALL_PROF)
+	free(s->sprof);
 #endif
 	free(s);
 }
@@ -755,6 +777,9 @@ TEE_Result tee_ta_invoke_command(TEE_ErrorOrigin *err,
 		return TEE_ERROR_TARGET_DEAD;
 	}
 
+	if (is_stateless_pseudo_ta_ctx(sess->ctx))
+		return pseudo_ta_invoke_stateless(sess, cmd, param, err);
+
 	tee_ta_set_busy(sess->ctx);
 
 	set_invoke_timeout(sess, cancel_req_to);
@@ -927,7 +952,52 @@ static void gprof_update_session_utime(bool suspend, struct tee_ta_session *s,
 		sbuf->usr_entered = now;
 	}
 }
+#else
+static void __maybe_unused
+gprof_update_session_utime(bool suspend __unused,
+			   struct tee_ta_session *s __unused,
+			   uint64_t now __unused)
+{
+}
+#endif /*CFG_TA_GPROF_SUPPORT*/
+
+#if defined(CFG_WITH_STATS)
+static void stats_update_ctx_utime(bool suspend, struct tee_ta_ctx *ctx,
+				   uint64_t now)
+{
+	struct tee_ta_ctx_stats *stats = &ctx->stats;
+
+	if (suspend) {
+		if (stats->user_entered)
+			stats->utime += now - stats->user_entered;
+		stats->user_entered = 0;
+	} else {
+		if (!now)
+			now++; /* 0 is reserved */
+		stats->user_entered = now;
+	}
+}
+
+/* Accounts an RPC issued on behalf of the current session */
+void tee_ta_stats_add_rpc(uint64_t ticks)
+{
+	struct tee_ta_session *s = NULL;
+
+	if (tee_ta_get_current_session(&s) != TEE_SUCCESS)
+		return;
+
+	s->ctx->stats.rpcs++;
+	s->ctx->stats.rpc_time += ticks;
+}
+#else
+static void __maybe_unused
+stats_update_ctx_utime(bool suspend __unused,
+		       struct tee_ta_ctx *ctx __unused, uint64_t now __unused)
+{
+}
+#endif /*CFG_WITH_STATS*/
 
+#if defined(CFG_TA_GPROF_SUPPORT) || defined(CFG_WITH_STATS)
 /*
  * Update user-mode CPU time for the current session
  * @suspend: true if session is being suspended (leaving user mode), false if
@@ -944,6 +1014,7 @@ static void tee_ta_update_session_utime(bool suspend)
 	now = read_cntpct();
 
 	gprof_update_session_utime(suspend, s, now);
+	stats_update_ctx_utime(suspend, s->ctx, now);
 }
 
 void tee_ta_update_session_utime_suspend(void)
@@ -979,6 +1050,7 @@ static void ftrace_update_times(bool suspend)
 	} else {
 		for (i = 0; i <= fbuf->ret_idx; i++)
 			fbuf->begin_time[i] += now - fbuf->suspend_time;
+		fbuf->last_time += now - fbuf->suspend_time;
 	}
 }
 
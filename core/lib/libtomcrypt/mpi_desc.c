@@ -29,11 +29,6 @@
 #include <trace.h>
 #include <kernel/delay.h>
 
-static unsigned int arm_cnt_cnt2us(uint64_t cnt)
-{
-	return (cnt * 1000000ULL) / read_cntfrq();
-}
-
 #if defined(_CFG_CORE_LTC_PAGER)
 /* allocate pageable_zi vmem for mp scratch memory pool */
 static struct mempool *get_mp_scratch_memory_pool(void)
@@ -601,7 +596,8 @@ static int exptmod(void *a, void *b, void *c, void *d)
 		res = mbedtls_mpi_exp_mod(d, a, b, c, NULL);
 	}
 	// end = read_cntpct();
-	// EMSG("time spent in microseconds: %u", arm_cnt_cnt2us(end - start));
+	// EMSG("time spent in microseconds: %"PRIu64,
+	//      arm_cnt_cnt2us(end - start));
 
 	if (res)
 		return CRYPT_MEM;
@@ -16,12 +16,6 @@
 
 #include <kernel/delay.h>
 
-static unsigned int arm_cnt_cnt2us(uint64_t cnt)
-{
-	return (cnt * 1000000ULL) / read_cntfrq();
-}
-
-
 /*
  * Compute the LibTomCrypt "hashindex" given a TEE Algorithm "algo"
  * Return
@@ -518,7 +512,8 @@ TEE_Result crypto_acipher_rsassa_sign(uint32_t algo, struct rsa_keypair *key,
 				   ltc_rsa_algo, NULL, find_prng("prng_crypto"),
 				   ltc_hashindex, salt_len, &ltc_key);
 	// end = read_cntpct();
-	// EMSG("time spent in microseconds: %u", arm_cnt_cnt2us(end - start));
+	// EMSG("time spent in microseconds: %"PRIu64,
+	//      arm_cnt_cnt2us(end - start));
 
 	*sig_len = ltc_sig_len;
 
@@ -12,11 +12,6 @@
 #include <trace.h>
 #include <kernel/delay.h>
 
-static unsigned int arm_cnt_cnt2us(uint64_t cnt)
-{
-	return (cnt * 1000000ULL) / read_cntfrq();
-}
-
 /**
   @file rsa_exptmod.c
   RSA PKCS exptmod, Tom St Denis
@@ -187,7 +182,8 @@ error:
 #endif /* LTC_RSA_BLINDING */
                              tmpb, tmpa, tmp, NULL);
    // end = read_cntpct();
-	// EMSG("time spent in microseconds: %u", arm_cnt_cnt2us(end - start));
+	// EMSG("time spent in microseconds: %"PRIu64,
+	//      arm_cnt_cnt2us(end - start));
    return err;
 }
 
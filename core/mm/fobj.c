@@ -6,6 +6,7 @@
 #include <crypto/crypto.h>
 #include <crypto/internal_aes-gcm.h>
 #include <kernel/generic_boot.h>
+#include <kernel/page_helpers.h>
 #include <kernel/panic.h>
 #include <mm/core_memprot.h>
 #include <mm/core_mmu.h>
@@ -141,7 +142,7 @@ static TEE_Result rwp_load_page(struct fobj *fobj, unsigned int page_idx,
 		 * iv still zero which means that this is previously unused
 		 * page.
 		 */
-		memset(va, 0, SMALL_PAGE_SIZE);
+		clear_page(va);
 		return TEE_SUCCESS;
 	}
 
@@ -260,7 +261,7 @@ static TEE_Result rop_load_page_helper(struct fobj_rop *rop,
 
 	assert(refcount_val(&rop->fobj.refc));
 	assert(page_idx < rop->fobj.num_pages);
-	memcpy(va, src, SMALL_PAGE_SIZE);
+	copy_page(va, src);
 
 	return hash_sha256_check(hash, va, SMALL_PAGE_SIZE);
 }
@@ -491,7 +492,7 @@ static TEE_Result lop_load_page(struct fobj *fobj __maybe_unused,
 	assert(refcount_val(&fobj->refc));
 	assert(page_idx < fobj->num_pages);
 
-	memset(va, 0, SMALL_PAGE_SIZE);
+	clear_page(va);
 
 	return TEE_SUCCESS;
 }
@@ -524,8 +525,9 @@ static struct fobj_ops ops_sec_mem;
 struct fobj *fobj_sec_mem_alloc(unsigned int num_pages)
 {
 	struct fobj_sec_mem *f = calloc(1, sizeof(*f));
+	unsigned int n = 0;
 	size_t size = 0;
-	void *va = NULL;
+	uint8_t *va = NULL;
 
 	if (!f)
 		return NULL;
@@ -541,7 +543,8 @@ struct fobj *fobj_sec_mem_alloc(unsigned int num_pages)
 	if (!va)
 		goto err;
 
-	memset(va, 0, size);
+	for (n = 0; n < num_pages; n++)
+		clear_page(va + n * SMALL_PAGE_SIZE);
 	f->fobj.ops = &ops_sec_mem;
 	f->fobj.num_pages = num_pages;
 	refcount_set(&f->fobj.refc, 1);
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+#include <kernel/mutex.h>
+#include <kernel/spinlock.h>
+#include <kernel/tee_ta_manager.h>
+#include <kernel/thread.h>
+#include <malloc.h>
+#include <mm/tee_mm.h>
+#include <mm/tee_pager.h>
+#include <optee_rpc_cmd.h>
+#include <string.h>
+#include <tee/tee_fs.h>
+#include <tee/tee_pobj.h>
+#include <tee/tee_svc_storage.h>
+#include <trace.h>
+#include <util.h>
+
+#include "microbench.h"
+
+static const size_t mb_alloc_sizes[] = { 32, 256, 4096 };
+
+TEE_Result mb_mem(struct mb_ctx *ctx)
+{
+	tee_mm_entry_t *mm = NULL;
+	struct mb_timer t = { };
+	void *p = NULL;
+	size_t n = 0;
+	size_t m = 0;
+
+	for (m = 0; m < ARRAY_SIZE(mb_alloc_sizes); m++) {
+		memset(&t, 0, sizeof(t));
+		for (n = 0; n < ctx->iterations; n++) {
+			mb_timer_start(&t);
+			p = malloc(mb_alloc_sizes[m]);
+			free(p);
+			mb_timer_stop(&t);
+			if (!p)
+				return TEE_ERROR_OUT_OF_MEMORY;
+		}
+		mb_record(ctx, MICROBENCH_GROUP_MEM, "malloc/free",
+			  mb_alloc_sizes[m], n, &t);
+	}
+
+	memset(&t, 0, sizeof(t));
+	for (n = 0; n < ctx->iterations; n++) {
+		mb_timer_start(&t);
+		mm = tee_mm_alloc(&tee_mm_sec_ddr, SMALL_PAGE_SIZE);
+		tee_mm_free(mm);
+		mb_timer_stop(&t);
+		if (!mm)
+			return TEE_ERROR_OUT_OF_MEMORY;
+	}
+	mb_record(ctx, MICROBENCH_GROUP_MEM, "tee_mm_alloc/free",
+		  SMALL_PAGE_SIZE, n, &t);
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Mutex/condvar hand-off: the benchmark and its peer take turns on
+ * @ho_count, odd values are the peer's turn.
+ */
+static struct mutex ho_mu = MUTEX_INITIALIZER;
+static struct condvar ho_cv = CONDVAR_INITIALIZER;
+static bool ho_peer;
+static uint32_t ho_count;
+
+TEE_Result mb_handoff_peer(void)
+{
+	mutex_lock(&ho_mu);
+
+	if (ho_peer) {
+		mutex_unlock(&ho_mu);
+		return TEE_ERROR_BUSY;
+	}
+
+	ho_peer = true;
+	while (true) {
+		while (ho_peer && !(ho_count & 1))
+			condvar_wait(&ho_cv, &ho_mu);
+		if (!ho_peer)
+			break;
+		ho_count--;
+		condvar_signal(&ho_cv);
+	}
+
+	mutex_unlock(&ho_mu);
+
+	return TEE_SUCCESS;
+}
+
+static void mb_handoff(struct mb_ctx *ctx)
+{
+	struct mb_timer t = { };
+
+	mutex_lock(&ho_mu);
+
+	if (!ho_peer) {
+		mutex_unlock(&ho_mu);
+		DMSG("No hand-off peer");
+		return;
+	}
+
+	ho_count = 2 * ctx->iterations;
+	mb_timer_start(&t);
+	while (ho_count) {
+		ho_count--;
+		condvar_signal(&ho_cv);
+		while (ho_count & 1)
+			condvar_wait(&ho_cv, &ho_mu);
+	}
+	mb_timer_stop(&t);
+
+	/* Release the peer */
+	ho_peer = false;
+	condvar_signal(&ho_cv);
+
+	mutex_unlock(&ho_mu);
+
+	mb_record(ctx, MICROBENCH_GROUP_SYNC, "mutex/condvar hand-off", 0,
+		  ctx->iterations, &t);
+}
+
+TEE_Result mb_sync(struct mb_ctx *ctx)
+{
+	struct mutex m = MUTEX_INITIALIZER;
+	struct condvar cv = CONDVAR_INITIALIZER;
+	unsigned int lock = SPINLOCK_UNLOCK;
+	uint32_t exceptions = 0;
+	struct mb_timer t = { };
+	size_t n = 0;
+
+	for (n = 0; n < ctx->iterations; n++) {
+		mb_timer_start(&t);
+		exceptions = cpu_spin_lock_xsave(&lock);
+		cpu_spin_unlock_xrestore(&lock, exceptions);
+		mb_timer_stop(&t);
+	}
+	mb_record(ctx, MICROBENCH_GROUP_SYNC, "spinlock lock/unlock", 0, n,
+		  &t);
+
+	memset(&t, 0, sizeof(t));
+	for (n = 0; n < ctx->iterations; n++) {
+		mb_timer_start(&t);
+		mutex_lock(&m);
+		mutex_unlock(&m);
+		mb_timer_stop(&t);
+	}
+	mb_record(ctx, MICROBENCH_GROUP_SYNC, "mutex lock/unlock", 0, n, &t);
+
+	memset(&t, 0, sizeof(t));
+	for (n = 0; n < ctx->iterations; n++) {
+		mb_timer_start(&t);
+		condvar_signal(&cv);
+		mb_timer_stop(&t);
+	}
+	mb_record(ctx, MICROBENCH_GROUP_SYNC, "condvar signal", 0, n, &t);
+
+	mb_handoff(ctx);
+
+	condvar_destroy(&cv);
+	mutex_destroy(&m);
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result mb_rpc(struct mb_ctx *ctx)
+{
+	struct thread_param params = { };
+	struct mb_timer t = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	/* Getting the REE time is the cheapest round trip to the supplicant */
+	for (n = 0; n < ctx->iterations; n++) {
+		params = THREAD_PARAM_VALUE(OUT, 0, 0, 0);
+		mb_timer_start(&t);
+		res = thread_rpc_cmd(OPTEE_RPC_CMD_GET_TIME, 1, &params);
+		mb_timer_stop(&t);
+		if (res)
+			return res;
+	}
+	mb_record(ctx, MICROBENCH_GROUP_RPC, "rpc round trip", 0, n, &t);
+
+	return TEE_SUCCESS;
+}
+
+#ifdef CFG_WITH_PAGER
+#define MB_PAGER_PAGES	4
+
+/* Pageable memory can't be returned to the pager, it's kept once allocated */
+static uint8_t *mb_pager_area;
+
+TEE_Result mb_pager(struct mb_ctx *ctx)
+{
+	const size_t size = MB_PAGER_PAGES * SMALL_PAGE_SIZE;
+	struct mb_timer t = { };
+	size_t n = 0;
+	size_t m = 0;
+
+	if (!mb_pager_area) {
+		mb_pager_area = tee_pager_alloc(size);
+		if (!mb_pager_area)
+			return TEE_ERROR_OUT_OF_MEMORY;
+	}
+
+	for (n = 0; n < ctx->iterations; n++) {
+		/* Each page is unmapped, the next access faults */
+		tee_pager_release_phys(mb_pager_area, size);
+		mb_timer_start(&t);
+		for (m = 0; m < MB_PAGER_PAGES; m++)
+			mb_pager_area[m * SMALL_PAGE_SIZE] = n;
+		mb_timer_stop(&t);
+	}
+	mb_record(ctx, MICROBENCH_GROUP_PAGER, "page fault", SMALL_PAGE_SIZE,
+		  n * MB_PAGER_PAGES, &t);
+
+	return TEE_SUCCESS;
+}
+#else
+TEE_Result mb_pager(struct mb_ctx *ctx __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+static const size_t mb_storage_sizes[] = { 1024, MB_MAX_SIZE };
+static const char mb_obj_id[] = "microbench.dat";
+
+static TEE_Result storage_rw(struct mb_ctx *ctx, struct tee_pobj *po,
+			     size_t size)
+{
+	const struct tee_file_operations *fops = po->fops;
+	struct tee_file_handle *fh = NULL;
+	struct mb_timer tw = { };
+	struct mb_timer tr = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t len = 0;
+	size_t n = 0;
+
+	res = fops->create(po, true, NULL, 0, NULL, 0, NULL, 0, &fh);
+	if (res)
+		return res;
+
+	for (n = 0; n < ctx->iterations; n++) {
+		mb_timer_start(&tw);
+		res = fops->write(fh, 0, ctx->src, size);
+		mb_timer_stop(&tw);
+		if (res)
+			goto out;
+
+		len = size;
+		mb_timer_start(&tr);
+		res = fops->read(fh, 0, ctx->dst, &len);
+		mb_timer_stop(&tr);
+		if (res)
+			goto out;
+	}
+	mb_record(ctx, MICROBENCH_GROUP_STORAGE, "storage write", size, n,
+		  &tw);
+	mb_record(ctx, MICROBENCH_GROUP_STORAGE, "storage read", size, n,
+		  &tr);
+out:
+	fops->close(&fh);
+	fops->remove(po);
+
+	return res;
+}
+
+TEE_Result mb_storage(struct mb_ctx *ctx)
+{
+	const struct tee_file_operations *fops = NULL;
+	struct tee_ta_session *s = NULL;
+	struct tee_pobj *po = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	fops = tee_svc_storage_file_ops(TEE_STORAGE_PRIVATE);
+	if (!fops)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	res = tee_ta_get_current_session(&s);
+	if (res)
+		return res;
+
+	/* The object is private to this pseudo TA */
+	res = tee_pobj_get(&s->ctx->uuid, (void *)mb_obj_id,
+			   sizeof(mb_obj_id) - 1, TEE_DATA_FLAG_ACCESS_READ |
+			   TEE_DATA_FLAG_ACCESS_WRITE |
+			   TEE_DATA_FLAG_ACCESS_WRITE_META, false, fops, &po);
+	if (res)
+		return res;
+
+	for (n = 0; n < ARRAY_SIZE(mb_storage_sizes) && !res; n++)
+		res = storage_rw(ctx, po, mb_storage_sizes[n]);
+
+	tee_pobj_release(po);
+
+	return res;
+}
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+#include <crypto/crypto.h>
+#include <tee_api_defines.h>
+#include <trace.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "microbench.h"
+
+struct mb_alg {
+	uint32_t algo;
+	const char *name;
+	size_t key_len;
+	size_t key2_len;	/* Second key, XTS only */
+	size_t iv_len;		/* IV or nonce */
+};
+
+static const size_t mb_sizes[] = { 64, 1024, MB_MAX_SIZE };
+
+static const struct mb_alg mb_hash_algs[] = {
+	{ .algo = TEE_ALG_MD5, .name = "md5" },
+	{ .algo = TEE_ALG_SHA1, .name = "sha1" },
+	{ .algo = TEE_ALG_SHA224, .name = "sha224" },
+	{ .algo = TEE_ALG_SHA256, .name = "sha256" },
+	{ .algo = TEE_ALG_SHA384, .name = "sha384" },
+	{ .algo = TEE_ALG_SHA512, .name = "sha512" },
+	{ .algo = TEE_ALG_SM3, .name = "sm3" },
+};
+
+static const struct mb_alg mb_cipher_algs[] = {
+	{ TEE_ALG_AES_ECB_NOPAD, "aes-128-ecb", 16, 0, 0 },
+	{ TEE_ALG_AES_CBC_NOPAD, "aes-128-cbc", 16, 0, 16 },
+	{ TEE_ALG_AES_CTR, "aes-128-ctr", 16, 0, 16 },
+	{ TEE_ALG_AES_XTS, "aes-128-xts", 16, 16, 16 },
+	{ TEE_ALG_AES_CBC_NOPAD, "aes-256-cbc", 32, 0, 16 },
+	{ TEE_ALG_DES_ECB_NOPAD, "des-ecb", 8, 0, 0 },
+	{ TEE_ALG_DES_CBC_NOPAD, "des-cbc", 8, 0, 8 },
+	{ TEE_ALG_DES3_ECB_NOPAD, "des3-ecb", 24, 0, 0 },
+	{ TEE_ALG_DES3_CBC_NOPAD, "des3-cbc", 24, 0, 8 },
+	{ TEE_ALG_SM4_ECB_NOPAD, "sm4-ecb", 16, 0, 0 },
+	{ TEE_ALG_SM4_CBC_NOPAD, "sm4-cbc", 16, 0, 16 },
+	{ TEE_ALG_SM4_CTR, "sm4-ctr", 16, 0, 16 },
+};
+
+static const struct mb_alg mb_aead_algs[] = {
+	{ TEE_ALG_AES_GCM, "aes-128-gcm", 16, 0, 12 },
+	{ TEE_ALG_AES_CCM, "aes-128-ccm", 16, 0, 13 },
+};
+
+#define MB_TAG_LEN	16
+
+/* Key material, the values don't matter but DES weak keys are avoided */
+static const uint8_t mb_key[32] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+	0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+	0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+};
+
+/*
+ * Runs a benchmark for each size, algorithms which aren't available in
+ * this configuration are silently skipped.
+ */
+static void run_alg(struct mb_ctx *ctx, const struct mb_alg *alg,
+		    TEE_Result (*fn)(struct mb_ctx *ctx,
+				     const struct mb_alg *alg, size_t size))
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(mb_sizes); n++) {
+		res = fn(ctx, alg, mb_sizes[n]);
+		if (res == TEE_ERROR_NOT_IMPLEMENTED ||
+		    res == TEE_ERROR_NOT_SUPPORTED)
+			return;
+		if (res) {
+			EMSG("%s: error %#"PRIx32, alg->name, res);
+			return;
+		}
+	}
+}
+
+static TEE_Result hash_one(struct mb_ctx *ctx, const struct mb_alg *alg,
+			   size_t size)
+{
+	uint8_t digest[TEE_MAX_HASH_SIZE] = { };
+	struct mb_timer t = { };
+	TEE_Result res = TEE_SUCCESS;
+	void *hctx = NULL;
+	size_t n = 0;
+
+	res = crypto_hash_alloc_ctx(&hctx, alg->algo);
+	if (res)
+		return res;
+
+	for (n = 0; n < ctx->iterations; n++) {
+		mb_timer_start(&t);
+		res = crypto_hash_init(hctx);
+		if (!res)
+			res = crypto_hash_update(hctx, ctx->src, size);
+		if (!res)
+			res = crypto_hash_final(hctx, digest, sizeof(digest));
+		mb_timer_stop(&t);
+		if (res)
+			goto out;
+	}
+
+	mb_record(ctx, MICROBENCH_GROUP_HASH, alg->name, size, n, &t);
+out:
+	crypto_hash_free_ctx(hctx);
+
+	return res;
+}
+
+TEE_Result mb_hash(struct mb_ctx *ctx)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(mb_hash_algs); n++)
+		run_alg(ctx, mb_hash_algs + n, hash_one);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result cipher_one(struct mb_ctx *ctx, const struct mb_alg *alg,
+			     size_t size)
+{
+	struct mb_timer t = { };
+	TEE_Result res = TEE_SUCCESS;
+	void *cctx = NULL;
+	size_t n = 0;
+
+	res = crypto_cipher_alloc_ctx(&cctx, alg->algo);
+	if (res)
+		return res;
+
+	for (n = 0; n < ctx->iterations; n++) {
+		mb_timer_start(&t);
+		res = crypto_cipher_init(cctx, TEE_MODE_ENCRYPT,
+					 mb_key, alg->key_len,
+					 alg->key2_len ? mb_key + 16 : NULL,
+					 alg->key2_len, mb_key, alg->iv_len);
+		if (!res)
+			res = crypto_cipher_update(cctx, TEE_MODE_ENCRYPT, true,
+						   ctx->src, size, ctx->dst);
+		crypto_cipher_final(cctx);
+		mb_timer_stop(&t);
+		if (res)
+			goto out;
+	}
+
+	mb_record(ctx, MICROBENCH_GROUP_CIPHER, alg->name, size, n, &t);
+out:
+	crypto_cipher_free_ctx(cctx);
+
+	return res;
+}
+
+TEE_Result mb_cipher(struct mb_ctx *ctx)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(mb_cipher_algs); n++)
+		run_alg(ctx, mb_cipher_algs + n, cipher_one);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result aead_one(struct mb_ctx *ctx, const struct mb_alg *alg,
+			   size_t size)
+{
+	uint8_t tag[MB_TAG_LEN] = { };
+	size_t tag_len = 0;
+	struct mb_timer t = { };
+	TEE_Result res = TEE_SUCCESS;
+	void *actx = NULL;
+	size_t dlen = 0;
+	size_t n = 0;
+
+	res = crypto_authenc_alloc_ctx(&actx, alg->algo);
+	if (res)
+		return res;
+
+	for (n = 0; n < ctx->iterations; n++) {
+		dlen = MB_MAX_SIZE;
+		tag_len = sizeof(tag);
+		mb_timer_start(&t);
+		res = crypto_authenc_init(actx, TEE_MODE_ENCRYPT, mb_key,
+					  alg->key_len, mb_key, alg->iv_len,
+					  MB_TAG_LEN, 0, size);
+		if (!res)
+			res = crypto_authenc_enc_final(actx, ctx->src, size,
+						       ctx->dst, &dlen, tag,
+						       &tag_len);
+		crypto_authenc_final(actx);
+		mb_timer_stop(&t);
+		if (res)
+			goto out;
+	}
+
+	mb_record(ctx, MICROBENCH_GROUP_AEAD, alg->name, size, n, &t);
+out:
+	crypto_authenc_free_ctx(actx);
+
+	return res;
+}
+
+TEE_Result mb_aead(struct mb_ctx *ctx)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(mb_aead_algs); n++)
+		run_alg(ctx, mb_aead_algs + n, aead_one);
+
+	return TEE_SUCCESS;
+}
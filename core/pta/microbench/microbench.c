@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+#include <arm.h>
+#include <kernel/pseudo_ta.h>
+#include <malloc.h>
+#include <pta_microbench.h>
+#include <string.h>
+#include <string_ext.h>
+#include <trace.h>
+#include <util.h>
+
+#include "microbench.h"
+
+#define TA_NAME			"microbench.pta"
+
+#define MB_DEFAULT_ITERATIONS	100
+
+static TEE_Result (*const mb_groups[])(struct mb_ctx *ctx) = {
+	[MICROBENCH_GROUP_HASH] = mb_hash,
+	[MICROBENCH_GROUP_CIPHER] = mb_cipher,
+	[MICROBENCH_GROUP_AEAD] = mb_aead,
+	[MICROBENCH_GROUP_MEM] = mb_mem,
+	[MICROBENCH_GROUP_SYNC] = mb_sync,
+	[MICROBENCH_GROUP_RPC] = mb_rpc,
+	[MICROBENCH_GROUP_PAGER] = mb_pager,
+	[MICROBENCH_GROUP_STORAGE] = mb_storage,
+};
+
+void mb_record(struct mb_ctx *ctx, uint32_t group, const char *name,
+	       uint32_t size, uint32_t iterations, const struct mb_timer *t)
+{
+	struct microbench_result *r = NULL;
+
+	if (ctx->nb_res < ctx->max_res) {
+		r = ctx->res + ctx->nb_res;
+		memset(r, 0, sizeof(*r));
+		strlcpy(r->name, name, sizeof(r->name));
+		r->group = group;
+		r->size = size;
+		r->iterations = iterations;
+		r->ticks = t->ticks;
+		r->cycles = t->cycles;
+	}
+	ctx->nb_res++;
+}
+
+static TEE_Result run_benchmarks(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_MEMREF_OUTPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	struct microbench_header *hdr = p[1].memref.buffer;
+	uint32_t groups = p[0].value.a;
+	struct mb_ctx ctx = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t size = 0;
+	size_t n = 0;
+
+	if (type != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (hdr && p[1].memref.size >= sizeof(*hdr)) {
+		ctx.res = (struct microbench_result *)(hdr + 1);
+		ctx.max_res = (p[1].memref.size - sizeof(*hdr)) /
+			      sizeof(*ctx.res);
+	}
+	ctx.iterations = p[0].value.b;
+	if (!ctx.iterations)
+		ctx.iterations = MB_DEFAULT_ITERATIONS;
+
+	ctx.src = malloc(MB_MAX_SIZE);
+	ctx.dst = malloc(MB_MAX_SIZE);
+	if (!ctx.src || !ctx.dst) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+	memset(ctx.src, 0xa5, MB_MAX_SIZE);
+
+	for (n = 0; n < ARRAY_SIZE(mb_groups); n++) {
+		if (!(groups & BIT32(n)))
+			continue;
+		res = mb_groups[n](&ctx);
+		if (res == TEE_ERROR_NOT_SUPPORTED) {
+			DMSG("Benchmark group %zu not supported", n);
+			continue;
+		}
+		if (res)
+			goto out;
+	}
+
+	size = sizeof(*hdr) + ctx.nb_res * sizeof(*ctx.res);
+	if (ctx.nb_res > ctx.max_res || p[1].memref.size < sizeof(*hdr)) {
+		res = TEE_ERROR_SHORT_BUFFER;
+	} else {
+		hdr->version = MICROBENCH_VERSION;
+		hdr->nb_results = ctx.nb_res;
+		hdr->cntfrq = read_cntfrq();
+		hdr->reserved = 0;
+		res = TEE_SUCCESS;
+	}
+	p[1].memref.size = size;
+out:
+	free(ctx.src);
+	free(ctx.dst);
+
+	return res;
+}
+
+static TEE_Result handoff_peer(uint32_t type,
+			       TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	if (type != TEE_PARAM_TYPES(TEE_PARAM_TYPE_NONE, TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE, TEE_PARAM_TYPE_NONE))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	return mb_handoff_peer();
+}
+
+static TEE_Result invoke_command(void *psess __unused,
+				 uint32_t cmd, uint32_t ptypes,
+				 TEE_Param params[TEE_NUM_PARAMS])
+{
+	switch (cmd) {
+	case PTA_MICROBENCH_RUN:
+		return run_benchmarks(ptypes, params);
+	case PTA_MICROBENCH_HANDOFF_PEER:
+		return handoff_peer(ptypes, params);
+	default:
+		break;
+	}
+
+	return TEE_ERROR_BAD_PARAMETERS;
+}
+
+pseudo_ta_register(.uuid = PTA_MICROBENCH_UUID, .name = TA_NAME,
+		   .flags = PTA_DEFAULT_FLAGS | TA_FLAG_CONCURRENT,
+		   .invoke_command_entry_point = invoke_command);
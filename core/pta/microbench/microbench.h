@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+#ifndef CORE_PTA_MICROBENCH_MICROBENCH_H
+#define CORE_PTA_MICROBENCH_MICROBENCH_H
+
+#include <arm.h>
+#include <pta_microbench.h>
+#include <stddef.h>
+#include <tee_api_types.h>
+
+/* Buffer sizes used by the throughput benchmarks */
+#define MB_MAX_SIZE	8192
+
+struct mb_ctx {
+	struct microbench_result *res;
+	size_t max_res;
+	size_t nb_res;
+	uint32_t iterations;
+	uint8_t *src;
+	uint8_t *dst;
+};
+
+/* Accumulates the time spent between mb_timer_start() and mb_timer_stop() */
+struct mb_timer {
+	uint64_t ticks;
+	uint64_t cycles;
+	uint64_t start_ticks;
+	uint64_t start_cycles;
+};
+
+/*
+ * read_pmccntr() is defined in arm64.h on ARM64 and generated from
+ * core/arch/arm/kernel/arm32_sysreg.txt on ARM32, where the cycle counter
+ * is 32 bits wide.
+ */
+static inline void mb_timer_start(struct mb_timer *t)
+{
+	t->start_cycles = read_pmccntr();
+	t->start_ticks = read_cntpct();
+}
+
+static inline void mb_timer_stop(struct mb_timer *t)
+{
+	uint64_t ticks = read_cntpct();
+	uint64_t cycles = read_pmccntr();
+
+	t->ticks += ticks - t->start_ticks;
+#ifdef ARM32
+	/* PMCCNTR is read as a 32-bit register */
+	t->cycles += (uint32_t)(cycles - t->start_cycles);
+#else
+	t->cycles += cycles - t->start_cycles;
+#endif
+}
+
+/* Adds a result, results which don't fit in the output buffer are counted */
+void mb_record(struct mb_ctx *ctx, uint32_t group, const char *name,
+	       uint32_t size, uint32_t iterations, const struct mb_timer *t);
+
+TEE_Result mb_hash(struct mb_ctx *ctx);
+TEE_Result mb_cipher(struct mb_ctx *ctx);
+TEE_Result mb_aead(struct mb_ctx *ctx);
+TEE_Result mb_mem(struct mb_ctx *ctx);
+TEE_Result mb_sync(struct mb_ctx *ctx);
+TEE_Result mb_handoff_peer(void);
+TEE_Result mb_rpc(struct mb_ctx *ctx);
+TEE_Result mb_pager(struct mb_ctx *ctx);
+TEE_Result mb_storage(struct mb_ctx *ctx);
+
+#endif /*CORE_PTA_MICROBENCH_MICROBENCH_H*/
@@ -0,0 +1,3 @@
+srcs-y += microbench.c
+srcs-y += core.c
+srcs-y += crypto.c
@@ -0,0 +1,403 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+#include <arm.h>
+#include <keep.h>
+#include <kernel/interrupt.h>
+#include <kernel/linker.h>
+#include <kernel/misc.h>
+#include <kernel/mutex.h>
+#include <kernel/pseudo_ta.h>
+#include <kernel/spinlock.h>
+#include <kernel/tee_misc.h>
+#include <kernel/thread.h>
+#include <kernel/unwind.h>
+#include <malloc.h>
+#include <pta_pmu_prof.h>
+#include <string.h>
+#include <trace.h>
+
+#define TA_NAME		"pmu_prof.ta"
+
+/*
+ * Counter used for sampling. The normal world must not use the PMU while
+ * the secure world is profiled.
+ */
+#define PMU_PROF_CNT	0
+
+/* Architectural event numbers */
+#define PMU_EVT_L1D_CACHE_REFILL	0x03
+#define PMU_EVT_BR_MIS_PRED		0x10
+#define PMU_EVT_CPU_CYCLES		0x11
+
+/* Number of frames walked to find the interrupted frame pointer */
+#define MAX_TMP_FRAMES		16
+
+struct pmu_prof_ring {
+	unsigned int lock;
+	bool it_enabled;
+	size_t head;
+	size_t tail;
+	uint64_t lost;
+	struct pmu_prof_sample *samples;
+};
+
+static struct mutex pp_mu = MUTEX_INITIALIZER;
+static struct pmu_prof_ring pp_rings[CFG_TEE_CORE_NB_CORE];
+static struct pmu_prof_sample *pp_samples;
+static size_t pp_nb_samples;
+static uint32_t pp_event;
+static uint32_t pp_period;
+static bool pp_running;
+
+static const uint32_t pp_evt_num[] = {
+	[PMU_PROF_EVENT_CYCLES] = PMU_EVT_CPU_CYCLES,
+	[PMU_PROF_EVENT_CACHE_MISSES] = PMU_EVT_L1D_CACHE_REFILL,
+	[PMU_PROF_EVENT_BRANCH_MISSES] = PMU_EVT_BR_MIS_PRED,
+};
+
+static void pmu_load_counter(void)
+{
+	write_pmselr_el0(PMU_PROF_CNT);
+	isb();
+	write_pmxevcntr_el0(-pp_period);
+}
+
+static void pmu_arm(void)
+{
+	/* Count secure EL1 and EL0 only */
+	uint32_t evtyper = pp_evt_num[pp_event] | PMEVTYPER_NSK |
+			   PMEVTYPER_NSU | PMEVTYPER_M;
+
+	write_pmcntenclr_el0(BIT32(PMU_PROF_CNT));
+	write_pmselr_el0(PMU_PROF_CNT);
+	isb();
+	write_pmxevtyper_el0(evtyper);
+	pmu_load_counter();
+	write_pmovsclr_el0(BIT32(PMU_PROF_CNT));
+	write_pmintenset_el1(BIT32(PMU_PROF_CNT));
+	write_pmcr_el0(read_pmcr_el0() | PMCR_E);
+	write_pmcntenset_el0(BIT32(PMU_PROF_CNT));
+	isb();
+}
+
+static void pmu_disarm(void)
+{
+	write_pmintenclr_el1(BIT32(PMU_PROF_CNT));
+	write_pmcntenclr_el0(BIT32(PMU_PROF_CNT));
+	write_pmovsclr_el0(BIT32(PMU_PROF_CNT));
+	isb();
+}
+
+/*
+ * The native interrupt handler calls itr_core_handler() on the temporary
+ * stack without creating a frame record, so the first frame pointer found
+ * outside the temporary stack is the one of the interrupted code.
+ */
+static vaddr_t get_interrupted_fp(void)
+{
+	vaddr_t tmp_end = thread_get_core_local()->tmp_stack_va_end;
+	vaddr_t fp = read_fp();
+	vaddr_t low = fp;
+	size_t n = 0;
+
+	for (n = 0; n < MAX_TMP_FRAMES; n++) {
+		if (fp < low || fp > tmp_end - 2 * sizeof(uint64_t))
+			return fp;
+		low = fp;
+		fp = *(uint64_t *)fp;
+	}
+
+	return 0;
+}
+
+static void record_stack(struct pmu_prof_sample *smp, vaddr_t pc)
+{
+	struct unwind_state_arm64 state = { .pc = pc };
+	vaddr_t stack = thread_stack_start();
+	size_t stack_size = thread_stack_size();
+
+	smp->pc[0] = pc;
+	smp->depth = 1;
+
+	/* Only thread stacks are unwound */
+	if (!stack)
+		return;
+
+	state.fp = get_interrupted_fp();
+	while (smp->depth < PMU_PROF_MAX_DEPTH &&
+	       unwind_stack_arm64(&state, stack, stack_size))
+		smp->pc[smp->depth++] = state.pc;
+}
+
+static void record_sample(struct pmu_prof_ring *ring, size_t pos)
+{
+	uint32_t spsr = read_spsr_el1();
+	struct pmu_prof_sample *smp = NULL;
+
+	cpu_spin_lock(&ring->lock);
+
+	if (ring->head - ring->tail >= pp_nb_samples) {
+		ring->lost++;
+		goto out;
+	}
+
+	smp = ring->samples + (ring->head & (pp_nb_samples - 1));
+	smp->core = pos;
+	smp->flags = 0;
+	smp->reserved = 0;
+
+	/* ELR_EL1 and SPSR_EL1 still describe the interrupted context */
+	if ((spsr >> SPSR_MODE_RW_SHIFT) & SPSR_MODE_RW_MASK ||
+	    !((spsr >> SPSR_64_MODE_EL_SHIFT) & SPSR_64_MODE_EL_MASK)) {
+		/* TA stacks are unwound by ldelf, not from interrupt context */
+		smp->flags = PMU_PROF_SAMPLE_USER;
+		smp->pc[0] = read_elr_el1();
+		smp->depth = 1;
+	} else {
+		record_stack(smp, read_elr_el1());
+	}
+
+	ring->head++;
+out:
+	cpu_spin_unlock(&ring->lock);
+}
+
+static enum itr_return pmu_prof_it_handler(struct itr_handler *h __unused)
+{
+	size_t pos = get_core_pos();
+	struct pmu_prof_ring *ring = pp_rings + pos;
+
+	if (!(read_pmovsclr_el0() & BIT32(PMU_PROF_CNT)))
+		return ITRR_NONE;
+
+	if (!pp_running) {
+		pmu_disarm();
+		return ITRR_HANDLED;
+	}
+
+	write_pmovsclr_el0(BIT32(PMU_PROF_CNT));
+	record_sample(ring, pos);
+	pmu_load_counter();
+
+	return ITRR_HANDLED;
+}
+KEEP_PAGER(pmu_prof_it_handler);
+
+static struct itr_handler pmu_prof_itr = {
+	.it = CFG_CORE_PMU_PROF_IT,
+	.flags = ITRF_TRIGGER_LEVEL,
+	.handler = pmu_prof_it_handler,
+};
+KEEP_PAGER(pmu_prof_itr);
+
+static TEE_Result alloc_samples(size_t nb_samples)
+{
+	struct pmu_prof_sample *samples = NULL;
+	size_t n = 0;
+
+	if (pp_samples) {
+		if (nb_samples == pp_nb_samples)
+			return TEE_SUCCESS;
+		return TEE_ERROR_BAD_STATE;
+	}
+
+	if (MUL_OVERFLOW(nb_samples, CFG_TEE_CORE_NB_CORE, &n))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	samples = calloc(n, sizeof(*samples));
+	if (!samples)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	for (n = 0; n < CFG_TEE_CORE_NB_CORE; n++)
+		pp_rings[n].samples = samples + n * nb_samples;
+	pp_nb_samples = nb_samples;
+	pp_samples = samples;
+
+	/* Registered once, the handler is shared by all cores */
+	itr_add(&pmu_prof_itr);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result start_sampling(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	struct pmu_prof_ring *ring = NULL;
+	uint32_t exceptions = 0;
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t event = p[0].value.a;
+	uint32_t period = p[0].value.b;
+	size_t nb_samples = p[1].value.a;
+
+	if (type != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (event >= ARRAY_SIZE(pp_evt_num) || !period ||
+	    !nb_samples || !IS_POWER_OF_TWO(nb_samples))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!((read_pmcr_el0() >> PMCR_N_SHIFT) & PMCR_N_MASK))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	mutex_lock(&pp_mu);
+
+	if (pp_running && (event != pp_event || period != pp_period)) {
+		res = TEE_ERROR_BAD_STATE;
+		goto out;
+	}
+
+	res = alloc_samples(nb_samples);
+	if (res)
+		goto out;
+
+	pp_event = event;
+	pp_period = period;
+	pp_running = true;
+
+	/* Stay on this core while its PMU and interrupt are set up */
+	exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	ring = pp_rings + get_core_pos();
+	pmu_arm();
+	if (!ring->it_enabled) {
+		itr_enable(CFG_CORE_PMU_PROF_IT);
+		ring->it_enabled = true;
+	}
+	thread_unmask_exceptions(exceptions);
+
+	DMSG("Sampling event %"PRIu32" every %"PRIu32, event, period);
+out:
+	mutex_unlock(&pp_mu);
+
+	return res;
+}
+
+static TEE_Result stop_sampling(uint32_t type,
+				TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	if (type != TEE_PARAM_TYPES(TEE_PARAM_TYPE_NONE, TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE, TEE_PARAM_TYPE_NONE))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/*
+	 * Each core disarms its counter on the next overflow, the
+	 * interrupt stays enabled in case sampling is restarted.
+	 */
+	mutex_lock(&pp_mu);
+	pp_running = false;
+	mutex_unlock(&pp_mu);
+
+	return TEE_SUCCESS;
+}
+
+static size_t drain_ring(struct pmu_prof_ring *ring,
+			 struct pmu_prof_sample *dst, size_t max,
+			 uint64_t *lost)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&ring->lock);
+	size_t n = 0;
+
+	while (n < max && ring->tail != ring->head) {
+		dst[n] = ring->samples[ring->tail & (pp_nb_samples - 1)];
+		ring->tail++;
+		n++;
+	}
+	*lost += ring->lost;
+	ring->lost = 0;
+
+	cpu_spin_unlock_xrestore(&ring->lock, exceptions);
+
+	return n;
+}
+
+static size_t count_samples(void)
+{
+	uint32_t exceptions = 0;
+	size_t count = 0;
+	size_t n = 0;
+
+	for (n = 0; n < CFG_TEE_CORE_NB_CORE; n++) {
+		exceptions = cpu_spin_lock_xsave(&pp_rings[n].lock);
+		count += pp_rings[n].head - pp_rings[n].tail;
+		cpu_spin_unlock_xrestore(&pp_rings[n].lock, exceptions);
+	}
+
+	return count;
+}
+
+static TEE_Result get_samples(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_OUTPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	struct pmu_prof_header *hdr = p[0].memref.buffer;
+	struct pmu_prof_sample *smp = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	size_t count = 0;
+	size_t size = 0;
+	size_t n = 0;
+
+	if (type != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mutex_lock(&pp_mu);
+
+	/* More samples may come in, they're left for the next call */
+	count = count_samples();
+	size = sizeof(*hdr) + count * sizeof(*smp);
+	if (p[0].memref.size < size) {
+		p[0].memref.size = size;
+		res = TEE_ERROR_SHORT_BUFFER;
+		goto out;
+	}
+	if (!hdr) {
+		res = TEE_ERROR_BAD_PARAMETERS;
+		goto out;
+	}
+
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->version = PMU_PROF_VERSION;
+	hdr->event = pp_event;
+	hdr->period = pp_period;
+	hdr->load_addr = VCORE_START_VA;
+
+	smp = (struct pmu_prof_sample *)(hdr + 1);
+	for (n = 0; n < CFG_TEE_CORE_NB_CORE && pp_samples; n++)
+		hdr->nb_samples += drain_ring(pp_rings + n,
+					      smp + hdr->nb_samples,
+					      count - hdr->nb_samples,
+					      &hdr->lost);
+
+	p[0].memref.size = sizeof(*hdr) + hdr->nb_samples * sizeof(*smp);
+out:
+	mutex_unlock(&pp_mu);
+
+	return res;
+}
+
+static TEE_Result invoke_command(void *psess __unused,
+				 uint32_t cmd, uint32_t ptypes,
+				 TEE_Param params[TEE_NUM_PARAMS])
+{
+	switch (cmd) {
+	case PTA_PMU_PROF_START:
+		return start_sampling(ptypes, params);
+	case PTA_PMU_PROF_STOP:
+		return stop_sampling(ptypes, params);
+	case PTA_PMU_PROF_GET_SAMPLES:
+		return get_samples(ptypes, params);
+	default:
+		break;
+	}
+
+	return TEE_ERROR_BAD_PARAMETERS;
+}
+
+pseudo_ta_register(.uuid = PTA_PMU_PROF_UUID, .name = TA_NAME,
+		   .flags = PTA_DEFAULT_FLAGS,
+		   .invoke_command_entry_point = invoke_command);
@@ -2,10 +2,17 @@
 /*
  * Copyright (c) 2015, Linaro Limited
  */
+#include <arm.h>
 #include <compiler.h>
+#include <kernel/boot_prof.h>
+#include <kernel/delay.h>
 #include <stdio.h>
 #include <trace.h>
+#include <kernel/lock_prof.h>
 #include <kernel/pseudo_ta.h>
+#include <kernel/rpc_stats.h>
+#include <kernel/tee_ta_manager.h>
+#include <kernel/user_ta.h>
 #include <mm/tee_pager.h>
 #include <mm/tee_mm.h>
 #include <string.h>
@@ -21,9 +28,51 @@
 #define STATS_CMD_PAGER_STATS		0
 #define STATS_CMD_ALLOC_STATS		1
 #define STATS_CMD_MEMLEAK_STATS		2
+#define STATS_CMD_RPC_STATS		3
+#define STATS_CMD_TA_STATS		4
+#define STATS_CMD_LOCK_STATS		5
+#define STATS_CMD_ALLOC_SITES		6
+#define STATS_CMD_BOOT_PROF		7
+#define STATS_CMD_HEAP_USAGE		8
 
 #define STATS_NB_POOLS			4
 
+/*
+ * Element of the output buffer of STATS_CMD_TA_STATS
+ *
+ * The counters are kept per TA context, not per session: the sessions of
+ * a multi-session TA share its address space and heap, so the mapped RAM
+ * can't be attributed to one of them, and the times and counts are the
+ * sums over all the sessions. @ref_count gives the number of sessions.
+ */
+struct stats_ta_ctx {
+	TEE_UUID uuid;
+	uint32_t is_user_ta;
+	uint32_t ref_count;
+	uint32_t rpcs;
+	uint32_t pager_faults;
+	uint64_t user_time_us;
+	uint64_t kernel_time_us;
+	uint64_t rpc_time_us;
+	uint64_t ram;
+	uint64_t ram_peak;
+	uint32_t syscalls[TEE_SCN_MAX + 1];
+};
+
+#define STATS_SITE_FILE_LEN		48
+
+/* Element of the output buffer of STATS_CMD_ALLOC_SITES */
+struct stats_alloc_site {
+	char file[STATS_SITE_FILE_LEN];
+	uint32_t line;
+	uint32_t live_count;
+	uint64_t live_bytes;
+	uint64_t peak_bytes;
+	uint32_t num_alloc;
+	uint32_t num_free;
+	uint64_t alloc_bytes;
+};
+
 static TEE_Result get_alloc_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
 {
 	struct malloc_stats *stats;
@@ -137,6 +186,247 @@ static TEE_Result get_memleak_stats(uint32_t type,
 	return TEE_SUCCESS;
 }
 
+static TEE_Result get_rpc_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t count = 0;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].memref.buffer = output buffer to struct rpc_cmd_stats[], one
+	 *                      element per RPC command used since last reset
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type) {
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	count = p[1].memref.size / sizeof(struct rpc_cmd_stats);
+	res = rpc_stats_get(p[1].memref.buffer, &count, !!p[0].value.a);
+	p[1].memref.size = count * sizeof(struct rpc_cmd_stats);
+
+	return res;
+}
+
+static void get_ctx_stats(struct tee_ta_ctx *ctx, struct stats_ta_ctx *st,
+			  bool reset)
+{
+	struct tee_ta_ctx_stats *stats = &ctx->stats;
+
+	st->uuid = ctx->uuid;
+	st->is_user_ta = is_user_ta_ctx(ctx);
+	st->ref_count = ctx->ref_count;
+	st->rpcs = stats->rpcs;
+	st->pager_faults = stats->pager_faults;
+	st->user_time_us = arm_cnt_cnt2us(stats->utime);
+	st->kernel_time_us = arm_cnt_cnt2us(stats->ktime);
+	st->rpc_time_us = arm_cnt_cnt2us(stats->rpc_time);
+	st->ram = stats->ram;
+	st->ram_peak = stats->ram_peak;
+	memcpy(st->syscalls, stats->syscalls, sizeof(st->syscalls));
+
+	if (reset) {
+		stats->utime = 0;
+		stats->ktime = 0;
+		stats->rpc_time = 0;
+		stats->rpcs = 0;
+		stats->pager_faults = 0;
+		stats->ram_peak = stats->ram;
+		memset(stats->syscalls, 0, sizeof(stats->syscalls));
+	}
+}
+
+static TEE_Result get_ta_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct stats_ta_ctx *st = p[1].memref.buffer;
+	TEE_Result res = TEE_SUCCESS;
+	struct tee_ta_ctx *ctx = NULL;
+	size_t count = 0;
+	size_t n = 0;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].memref.buffer = output buffer to struct stats_ta_ctx[], one
+	 *                      element per loaded TA context
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type) {
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	mutex_lock(&tee_ta_mutex);
+
+	TAILQ_FOREACH(ctx, &tee_ctxes, link)
+		count++;
+
+	if (p[1].memref.size < count * sizeof(*st)) {
+		res = TEE_ERROR_SHORT_BUFFER;
+		goto out;
+	}
+
+	TAILQ_FOREACH(ctx, &tee_ctxes, link)
+		get_ctx_stats(ctx, st + n++, !!p[0].value.a);
+out:
+	mutex_unlock(&tee_ta_mutex);
+	p[1].memref.size = count * sizeof(*st);
+
+	return res;
+}
+
+static TEE_Result get_lock_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t count = 0;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].memref.buffer = output buffer to struct lock_prof_stats[], the
+	 *                      call sites which waited the longest for a lock
+	 *                      first
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type) {
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	count = p[1].memref.size / sizeof(struct lock_prof_stats);
+	res = lock_prof_get(p[1].memref.buffer, &count, !!p[0].value.a);
+	p[1].memref.size = count * sizeof(struct lock_prof_stats);
+
+	return res;
+}
+
+#ifdef ENABLE_MDBG
+static void copy_alloc_site(struct stats_alloc_site *st,
+			    const struct mdbg_site_stats *s)
+{
+	size_t len = strlen(s->fname);
+	const char *file = s->fname;
+
+	/* Keep the end of long file names */
+	if (len >= sizeof(st->file))
+		file += len - sizeof(st->file) + 1;
+
+	memset(st, 0, sizeof(*st));
+	strlcpy(st->file, file, sizeof(st->file));
+	st->line = s->line;
+	st->live_count = s->live_count;
+	st->live_bytes = s->live_bytes;
+	st->peak_bytes = s->peak_bytes;
+	st->num_alloc = s->num_alloc;
+	st->num_free = s->num_free;
+	st->alloc_bytes = s->alloc_bytes;
+}
+
+static TEE_Result get_alloc_sites(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct stats_alloc_site *st = p[1].memref.buffer;
+	struct mdbg_site_stats *sites = NULL;
+	size_t count = 0;
+	size_t n = 0;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[0].value.b = MDBG_ORDER_LIVE_BYTES to sort by bytes currently
+	 *                allocated, MDBG_ORDER_ALLOC_BYTES by bytes allocated
+	 *                since the last reset
+	 * p[1].memref.buffer = output buffer to struct stats_alloc_site[], the
+	 *                      core heap allocation sites largest first
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type) {
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	count = MIN(p[1].memref.size / sizeof(*st), (size_t)MDBG_MAX_SITES);
+	if (count) {
+		sites = calloc(count, sizeof(*sites));
+		if (!sites)
+			return TEE_ERROR_OUT_OF_MEMORY;
+	}
+
+	count = mdbg_get_site_stats(sites, count, p[0].value.b,
+				    !!p[0].value.a);
+	for (n = 0; n < count; n++)
+		copy_alloc_site(st + n, sites + n);
+	p[1].memref.size = count * sizeof(*st);
+
+	free(sites);
+
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result get_alloc_sites(uint32_t type __unused,
+				  TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+static TEE_Result get_boot_prof(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t count = 0;
+
+	/*
+	 * p[0].memref.buffer = output buffer to struct boot_prof_entry[], one
+	 *                      element per timed boot phase or initcall
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type) {
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	count = p[0].memref.size / sizeof(struct boot_prof_entry);
+	res = boot_prof_get(p[0].memref.buffer, &count);
+	p[0].memref.size = count * sizeof(struct boot_prof_entry);
+
+	return res;
+}
+
+static TEE_Result get_heap_usage(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct malloc_stats stats = { };
+
+	/*
+	 * p[0].value.a = bytes currently allocated in the TEE core heap
+	 * p[0].value.b = peak of allocated bytes
+	 * p[1].value.a = size of the heap
+	 * p[1].value.b = number of failed allocations
+	 *
+	 * The parameters are VALUE_INOUT when invoked with
+	 * OPTEE_SMC_CALL_PTA_FAST, their input values are ignored.
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type &&
+	    TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INOUT,
+			    TEE_PARAM_TYPE_VALUE_INOUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type) {
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	malloc_get_stats(&stats);
+	p[0].value.a = stats.allocated;
+	p[0].value.b = stats.max_allocated;
+	p[1].value.a = stats.size;
+	p[1].value.b = stats.num_alloc_fail;
+
+	return TEE_SUCCESS;
+}
+
 /*
  * Trusted Application Entry Points
  */
@@ -152,12 +442,38 @@ static TEE_Result invoke_command(void *psess __unused,
 		return get_alloc_stats(ptypes, params);
 	case STATS_CMD_MEMLEAK_STATS:
 		return get_memleak_stats(ptypes, params);
+	case STATS_CMD_RPC_STATS:
+		return get_rpc_stats(ptypes, params);
+	case STATS_CMD_TA_STATS:
+		return get_ta_stats(ptypes, params);
+	case STATS_CMD_LOCK_STATS:
+		return get_lock_stats(ptypes, params);
+	case STATS_CMD_ALLOC_SITES:
+		return get_alloc_sites(ptypes, params);
+	case STATS_CMD_BOOT_PROF:
+		return get_boot_prof(ptypes, params);
+	case STATS_CMD_HEAP_USAGE:
+		return get_heap_usage(ptypes, params);
 	default:
 		break;
 	}
 	return TEE_ERROR_BAD_PARAMETERS;
 }
 
+#ifdef CFG_PTA_FAST_INVOKE
+static TEE_Result fast_invoke_command(uint32_t cmd, uint32_t ptypes,
+				      TEE_Param params[TEE_NUM_PARAMS])
+{
+	if (cmd == STATS_CMD_HEAP_USAGE)
+		return get_heap_usage(ptypes, params);
+
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 pseudo_ta_register(.uuid = STATS_UUID, .name = TA_NAME,
-		   .flags = PTA_DEFAULT_FLAGS,
+		   .flags = PTA_DEFAULT_FLAGS | PTA_FLAG_STATELESS,
+#ifdef CFG_PTA_FAST_INVOKE
+		   .fast_invoke_entry_point = fast_invoke_command,
+#endif
 		   .invoke_command_entry_point = invoke_command);
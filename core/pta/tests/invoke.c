@@ -410,6 +410,8 @@ static TEE_Result invoke_command(void *pSessionContext __unused,
 		return core_mutex_tests(nParamTypes, pParams);
 	case PTA_INVOKE_TESTS_CMD_LOCKDEP:
 		return core_lockdep_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_STRING:
+		return core_string_tests(nParamTypes, pParams);
 	default:
 		break;
 	}
@@ -6,6 +6,7 @@
 #include <malloc.h>
 #include <stdbool.h>
 #include <trace.h>
+#include <kernel/interrupt.h>
 #include <kernel/panic.h>
 #include <util.h>
 
@@ -466,6 +467,52 @@ static int self_test_nex_malloc(void)
 	return 0;
 }
 #endif
+
+static unsigned int itr_work_count;
+
+static void itr_work_func(struct itr_work *work __unused)
+{
+	itr_work_count++;
+}
+
+/* Not on the stack, any std call may run the queued work */
+static struct itr_work itr_work_test = { .func = itr_work_func };
+
+/* test the deferred work of interrupt handlers, itr_queue_work() */
+static int self_test_itr_work(void)
+{
+	struct itr_work *work = &itr_work_test;
+	int ret = 0;
+
+	LOG("itr_work tests (itr_queue_work, itr_run_work):");
+	itr_work_count = 0;
+
+	/* Queued once until it's run */
+	if (!itr_queue_work(work) || itr_queue_work(work))
+		ret = -1;
+	itr_run_work();
+	if (itr_work_count != 1)
+		ret = -1;
+	LOG("- queue and run => test %s", ret ? "FAILED" : "ok");
+
+	/* May be queued again once it has been run */
+	if (!itr_queue_work(work))
+		ret = -1;
+	itr_run_work();
+	if (itr_work_count != 2)
+		ret = -1;
+	LOG("- queue again and run => test %s", ret ? "FAILED" : "ok");
+
+	/* Nothing left to run */
+	itr_run_work();
+	if (itr_work_count != 2)
+		ret = -1;
+	LOG("- run empty queue => test %s", ret ? "FAILED" : "ok");
+	LOG("itr_work test done");
+
+	return ret;
+}
+
 /* exported entry points for some basic test */
 TEE_Result core_self_tests(uint32_t nParamTypes __unused,
 		TEE_Param pParams[TEE_NUM_PARAMS] __unused)
@@ -473,7 +520,7 @@ TEE_Result core_self_tests(uint32_t nParamTypes __unused,
 	if (self_test_mul_signed_overflow() || self_test_add_overflow() ||
 	    self_test_sub_overflow() || self_test_mul_unsigned_overflow() ||
 	    self_test_division() || self_test_malloc() ||
-	    self_test_nex_malloc()) {
+	    self_test_nex_malloc() || self_test_itr_work()) {
 		EMSG("some self_test_xxx failed! you should enable local LOG");
 		return TEE_ERROR_GENERIC;
 	}
@@ -6,6 +6,7 @@
 #define CORE_PTA_TESTS_MISC_H
 
 #include <compiler.h>
+#include <stddef.h>
 #include <tee_api_types.h>
 #include <tee_api_defines.h>
 
@@ -19,6 +20,18 @@ TEE_Result core_fs_htree_tests(uint32_t nParamTypes,
 TEE_Result core_mutex_tests(uint32_t nParamTypes,
 			    TEE_Param pParams[TEE_NUM_PARAMS]);
 
+TEE_Result core_string_tests(uint32_t nParamTypes,
+			     TEE_Param pParams[TEE_NUM_PARAMS]);
+
+#ifdef CFG_ARM_STRING_ASM
+/* The C versions of the string functions, see lib/libutils/isoc/newlib */
+void *newlib_memcpy(void *dst, const void *src, size_t len);
+void *newlib_memmove(void *dst, const void *src, size_t len);
+void *newlib_memset(void *dst, int c, size_t len);
+int newlib_memcmp(const void *s1, const void *s2, size_t len);
+size_t newlib_strlen(const char *s);
+#endif
+
 #ifdef CFG_LOCKDEP
 TEE_Result core_lockdep_tests(uint32_t nParamTypes,
 			      TEE_Param pParams[TEE_NUM_PARAMS]);
@@ -0,0 +1,327 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+/*
+ * Tests memcpy(), memmove(), memset(), memcmp() and strlen() against
+ * plain byte loops for all the alignments of the buffers and a range of
+ * lengths, then reports their throughput. With CFG_ARM_STRING_ASM the C
+ * versions are built as newlib_*() and go through the same tests, so both
+ * the assembly and the C versions are checked against the same results
+ * and their throughput can be compared.
+ */
+
+#include <arm.h>
+#include <kernel/delay.h>
+#include <string.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "misc.h"
+
+#define TEST_MAX_ALIGN	16
+#define TEST_MAX_LEN	300
+#define TEST_GUARD	16
+#define TEST_BUF_SIZE	(TEST_GUARD + TEST_MAX_ALIGN + TEST_MAX_LEN + \
+			 TEST_GUARD)
+#define TEST_BENCH_SIZE	4096
+#define TEST_BENCH_LOOPS	256
+
+static uint8_t src_buf[TEST_BUF_SIZE] __aligned(TEST_MAX_ALIGN);
+static uint8_t dst_buf[TEST_BUF_SIZE] __aligned(TEST_MAX_ALIGN);
+static uint8_t ref_buf[TEST_BUF_SIZE] __aligned(TEST_MAX_ALIGN);
+static uint8_t bench_buf[2][TEST_BENCH_SIZE] __aligned(TEST_MAX_ALIGN);
+
+struct string_funcs {
+	const char *name;
+	void *(*memcpy)(void *dst, const void *src, size_t len);
+	void *(*memmove)(void *dst, const void *src, size_t len);
+	void *(*memset)(void *dst, int c, size_t len);
+	int (*memcmp)(const void *s1, const void *s2, size_t len);
+	size_t (*strlen)(const char *s);
+};
+
+static const struct string_funcs string_funcs[] = {
+#ifdef CFG_ARM_STRING_ASM
+	{
+		.name = "asm", .memcpy = memcpy, .memmove = memmove,
+		.memset = memset, .memcmp = memcmp, .strlen = strlen,
+	},
+	{
+		.name = "C", .memcpy = newlib_memcpy,
+		.memmove = newlib_memmove, .memset = newlib_memset,
+		.memcmp = newlib_memcmp, .strlen = newlib_strlen,
+	},
+#else
+	{
+		.name = "C", .memcpy = memcpy, .memmove = memmove,
+		.memset = memset, .memcmp = memcmp, .strlen = strlen,
+	},
+#endif
+};
+
+static void fill_buf(uint8_t *buf, size_t len, uint8_t seed)
+{
+	size_t n = 0;
+
+	for (n = 0; n < len; n++)
+		buf[n] = seed + n * 7;
+}
+
+static bool buf_equal(const uint8_t *b1, const uint8_t *b2, size_t len)
+{
+	size_t n = 0;
+
+	for (n = 0; n < len; n++)
+		if (b1[n] != b2[n])
+			return false;
+	return true;
+}
+
+static int sign(int v)
+{
+	return (v > 0) - (v < 0);
+}
+
+static int ref_memcmp(const uint8_t *s1, const uint8_t *s2, size_t len)
+{
+	size_t n = 0;
+
+	for (n = 0; n < len; n++)
+		if (s1[n] != s2[n])
+			return s1[n] - s2[n];
+	return 0;
+}
+
+static TEE_Result test_memcpy(const struct string_funcs *f,
+			      size_t dst_off, size_t src_off, size_t len)
+{
+	uint8_t *dst = dst_buf + TEST_GUARD + dst_off;
+	uint8_t *src = src_buf + TEST_GUARD + src_off;
+	size_t n = 0;
+
+	fill_buf(src_buf, sizeof(src_buf), 1);
+	fill_buf(dst_buf, sizeof(dst_buf), 2);
+	fill_buf(ref_buf, sizeof(ref_buf), 2);
+	for (n = 0; n < len; n++)
+		ref_buf[TEST_GUARD + dst_off + n] = src[n];
+
+	if (f->memcpy(dst, src, len) != dst ||
+	    !buf_equal(dst_buf, ref_buf, sizeof(dst_buf))) {
+		EMSG("%s memcpy dst_off %zu src_off %zu len %zu", f->name,
+		     dst_off, src_off, len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result test_memmove(const struct string_funcs *f,
+			       size_t dst_off, size_t src_off, size_t len)
+{
+	uint8_t *dst = dst_buf + TEST_GUARD + dst_off;
+	uint8_t *src = dst_buf + TEST_GUARD + src_off;
+	size_t n = 0;
+
+	/* Overlapping buffers, dst before or after src */
+	fill_buf(dst_buf, sizeof(dst_buf), 3);
+	fill_buf(ref_buf, sizeof(ref_buf), 3);
+	for (n = 0; n < len; n++)
+		ref_buf[TEST_GUARD + dst_off + n] = dst_buf[TEST_GUARD +
+							    src_off + n];
+
+	if (f->memmove(dst, src, len) != dst ||
+	    !buf_equal(dst_buf, ref_buf, sizeof(dst_buf))) {
+		EMSG("%s memmove dst_off %zu src_off %zu len %zu", f->name,
+		     dst_off, src_off, len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result test_memset(const struct string_funcs *f,
+			      size_t off, size_t len)
+{
+	uint8_t *dst = dst_buf + TEST_GUARD + off;
+	size_t n = 0;
+
+	fill_buf(dst_buf, sizeof(dst_buf), 4);
+	fill_buf(ref_buf, sizeof(ref_buf), 4);
+	for (n = 0; n < len; n++)
+		ref_buf[TEST_GUARD + off + n] = 0xa5;
+
+	if (f->memset(dst, 0x1a5, len) != dst ||
+	    !buf_equal(dst_buf, ref_buf, sizeof(dst_buf))) {
+		EMSG("%s memset off %zu len %zu", f->name, off, len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result test_memcmp(const struct string_funcs *f,
+			      size_t off1, size_t off2, size_t len)
+{
+	uint8_t *s1 = dst_buf + TEST_GUARD + off1;
+	uint8_t *s2 = src_buf + TEST_GUARD + off2;
+	size_t n = 0;
+
+	fill_buf(s1, len, 5);
+	fill_buf(s2, len, 5);
+	if (f->memcmp(s1, s2, len)) {
+		EMSG("%s memcmp off1 %zu off2 %zu len %zu", f->name, off1,
+		     off2, len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	/* A difference at each position, in both directions */
+	for (n = 0; n < len; n++) {
+		s2[n] = s1[n] + 0x80;
+		if (sign(f->memcmp(s1, s2, len)) !=
+		    sign(ref_memcmp(s1, s2, len)) ||
+		    sign(f->memcmp(s2, s1, len)) !=
+		    sign(ref_memcmp(s2, s1, len))) {
+			EMSG("%s memcmp off1 %zu off2 %zu len %zu diff %zu",
+			     f->name, off1, off2, len, n);
+			return TEE_ERROR_GENERIC;
+		}
+		s2[n] = s1[n];
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result test_strlen(const struct string_funcs *f,
+			      size_t off, size_t len)
+{
+	char *s = (char *)dst_buf + TEST_GUARD + off;
+	size_t n = 0;
+
+	/* Non-zero bytes up to the terminator and after it */
+	for (n = 0; n < sizeof(dst_buf); n++)
+		dst_buf[n] = 0x80 | n;
+	s[len] = '\0';
+
+	if (f->strlen(s) != len) {
+		EMSG("%s strlen off %zu len %zu", f->name, off, len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result test_correctness(const struct string_funcs *f)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t off1 = 0;
+	size_t off2 = 0;
+	size_t len = 0;
+
+	for (off1 = 0; off1 < TEST_MAX_ALIGN; off1++) {
+		for (len = 0; len < TEST_MAX_LEN; len++) {
+			res = test_memset(f, off1, len);
+			if (res)
+				return res;
+			res = test_strlen(f, off1, len);
+			if (res)
+				return res;
+		}
+	}
+
+	for (off1 = 0; off1 < TEST_MAX_ALIGN; off1++) {
+		for (off2 = 0; off2 < TEST_MAX_ALIGN; off2++) {
+			for (len = 0; len < TEST_MAX_LEN; len++) {
+				res = test_memcpy(f, off1, off2, len);
+				if (res)
+					return res;
+				res = test_memmove(f, off1, off2, len);
+				if (res)
+					return res;
+			}
+			for (len = 0; len < TEST_MAX_LEN; len += 13) {
+				res = test_memcmp(f, off1, off2, len);
+				if (res)
+					return res;
+			}
+		}
+	}
+
+	return TEE_SUCCESS;
+}
+
+static void print_throughput(const struct string_funcs *f, const char *name,
+			     uint64_t begin, uint64_t end)
+{
+	uint64_t bytes = (uint64_t)TEST_BENCH_SIZE * TEST_BENCH_LOOPS;
+	uint64_t us = arm_cnt_cnt2us(end - begin);
+
+	IMSG("%-3s %-8s %"PRIu64" bytes in %"PRIu64" us, %"PRIu64" MB/s",
+	     f->name, name, bytes, us, us ? bytes / us : 0);
+}
+
+static void test_throughput(const struct string_funcs *f)
+{
+	uint8_t *b0 = bench_buf[0];
+	uint8_t *b1 = bench_buf[1];
+	volatile size_t sink = 0;
+	uint64_t begin = 0;
+	size_t n = 0;
+
+	begin = read_cntpct();
+	for (n = 0; n < TEST_BENCH_LOOPS; n++)
+		f->memset(b0, n, TEST_BENCH_SIZE);
+	print_throughput(f, "memset", begin, read_cntpct());
+
+	begin = read_cntpct();
+	for (n = 0; n < TEST_BENCH_LOOPS; n++)
+		f->memcpy(b1, b0, TEST_BENCH_SIZE);
+	print_throughput(f, "memcpy", begin, read_cntpct());
+
+	begin = read_cntpct();
+	for (n = 0; n < TEST_BENCH_LOOPS; n++)
+		f->memmove(b0 + 1, b0, TEST_BENCH_SIZE - 1);
+	print_throughput(f, "memmove", begin, read_cntpct());
+
+	memcpy(b1, b0, TEST_BENCH_SIZE);
+	begin = read_cntpct();
+	for (n = 0; n < TEST_BENCH_LOOPS; n++)
+		sink += f->memcmp(b0, b1, TEST_BENCH_SIZE);
+	print_throughput(f, "memcmp", begin, read_cntpct());
+
+	memset(b0, 'a', TEST_BENCH_SIZE - 1);
+	b0[TEST_BENCH_SIZE - 1] = '\0';
+	begin = read_cntpct();
+	for (n = 0; n < TEST_BENCH_LOOPS; n++)
+		sink += f->strlen((char *)b0);
+	print_throughput(f, "strlen", begin, read_cntpct());
+}
+
+TEE_Result core_string_tests(uint32_t nParamTypes,
+			     TEE_Param pParams[TEE_NUM_PARAMS] __unused)
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	if (exp_pt != nParamTypes) {
+		DMSG("bad parameter types");
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	for (n = 0; n < ARRAY_SIZE(string_funcs); n++) {
+		res = test_correctness(string_funcs + n);
+		if (res)
+			return res;
+	}
+
+	for (n = 0; n < ARRAY_SIZE(string_funcs); n++)
+		test_throughput(string_funcs + n);
+
+	return TEE_SUCCESS;
+}
@@ -5,3 +5,5 @@ srcs-$(CFG_LOCKDEP) += lockdep.c
 srcs-y += misc.c
 cflags-misc.c-y += -fno-builtin
 srcs-y += mutex.c
+srcs-y += string.c
+cflags-string.c-y += -fno-builtin
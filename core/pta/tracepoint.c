@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+#include <arm.h>
+#include <atomic.h>
+#include <keep.h>
+#include <kernel/misc.h>
+#include <kernel/mutex.h>
+#include <kernel/pseudo_ta.h>
+#include <kernel/thread.h>
+#include <kernel/tracepoint.h>
+#include <mm/core_memprot.h>
+#include <mm/mobj.h>
+#include <pta_tracepoint.h>
+#include <string.h>
+#include <trace.h>
+
+#define TA_NAME		"tracepoint.ta"
+
+uint32_t tp_event_mask;
+
+static struct mutex tp_mu = MUTEX_INITIALIZER;
+static struct mobj *tp_mobj;
+static struct tp_global *tp_global;
+static size_t tp_size;
+
+/*
+ * The geometry of the buffer and the ring heads are kept in secure memory,
+ * what's in the shared buffer is only ever written by secure world.
+ */
+static size_t tp_ring_size;
+static uint32_t tp_events_mask;
+static uint64_t tp_head[CFG_TEE_CORE_NB_CORE];
+
+/*
+ * Set by a core while it may record an event, so the rings aren't reset
+ * under its feet, see wait_recorders()
+ */
+static unsigned int tp_recording[CFG_TEE_CORE_NB_CORE];
+
+void __tp_record(uint32_t id, uint64_t arg0, uint64_t arg1)
+{
+	uint32_t exceptions = 0;
+	struct tp_ring *ring = NULL;
+	struct tp_event *ev = NULL;
+	size_t pos = 0;
+
+	exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+
+	/* Announce the record before checking that the event is enabled */
+	pos = get_core_pos();
+	atomic_store_uint(tp_recording + pos, 1);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (!(tp_event_mask & BIT32(id)))
+		goto out;
+
+	ring = (struct tp_ring *)(tp_global->rings + pos * tp_ring_size);
+	ev = ring->ev + (tp_head[pos] & tp_events_mask);
+
+	ev->cnt = read_cntpct();
+	ev->id = id;
+	ev->thread = thread_get_id_may_fail();
+	ev->arg[0] = arg0;
+	ev->arg[1] = arg1;
+
+	/* Publish the event only once it's complete */
+	tp_head[pos]++;
+	dsb_ishst();
+	ring->head = tp_head[pos];
+out:
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	atomic_store_uint(tp_recording + pos, 0);
+	thread_unmask_exceptions(exceptions);
+}
+KEEP_PAGER(__tp_record);
+
+/*
+ * Waits for the records in progress on the other cores once
+ * tp_event_mask has been cleared. A core announces a record before
+ * checking tp_event_mask, so either it sees the cleared mask or it's seen
+ * recording here.
+ */
+static void wait_recorders(void)
+{
+	size_t n = 0;
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	for (n = 0; n < CFG_TEE_CORE_NB_CORE; n++)
+		while (atomic_load_uint(tp_recording + n))
+			;
+}
+
+static TEE_Result alloc_buffer(size_t nb_events)
+{
+	size_t ring_size = 0;
+	size_t size = 0;
+
+	if (MUL_OVERFLOW(nb_events, sizeof(struct tp_event), &ring_size) ||
+	    ADD_OVERFLOW(ring_size, sizeof(struct tp_ring), &ring_size) ||
+	    MUL_OVERFLOW(ring_size, CFG_TEE_CORE_NB_CORE, &size) ||
+	    ADD_OVERFLOW(size, sizeof(struct tp_global), &size))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (tp_global) {
+		if (size == tp_size)
+			return TEE_SUCCESS;
+		return TEE_ERROR_BAD_STATE;
+	}
+
+	tp_mobj = thread_rpc_alloc_global_payload(size);
+	if (!tp_mobj)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	tp_global = mobj_get_va(tp_mobj, 0);
+	if (!tp_global) {
+		thread_rpc_free_global_payload(tp_mobj);
+		tp_mobj = NULL;
+		return TEE_ERROR_BAD_STATE;
+	}
+
+	tp_size = size;
+	tp_ring_size = ring_size;
+	tp_events_mask = nb_events - 1;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result start_tracing(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_VALUE_OUTPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	TEE_Result res = TEE_SUCCESS;
+	size_t nb_events = p[0].value.a;
+
+	if (type != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!nb_events || !IS_POWER_OF_TWO(nb_events))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mutex_lock(&tp_mu);
+
+	res = alloc_buffer(nb_events);
+	if (res)
+		goto out;
+
+	/* Stop recording while the rings are reset */
+	tp_event_mask = 0;
+	wait_recorders();
+	memset(tp_head, 0, sizeof(tp_head));
+	memset(tp_global, 0, tp_size);
+	tp_global->cores = CFG_TEE_CORE_NB_CORE;
+	tp_global->nb_events = nb_events;
+	tp_global->cntfrq = read_cntfrq();
+	tp_global->ring_size = tp_ring_size;
+	dsb_ishst();
+	tp_event_mask = p[0].value.b & GENMASK_32(TP_MAX_EVENT, 1);
+
+	DMSG("Tracing events %#"PRIx32", buffer pa %#"PRIxPA,
+	     tp_event_mask, virt_to_phys(tp_global));
+
+	p[1].value.a = virt_to_phys(tp_global);
+	p[1].value.b = tp_size;
+out:
+	mutex_unlock(&tp_mu);
+
+	return res;
+}
+
+static TEE_Result stop_tracing(uint32_t type,
+			       TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	if (type != TEE_PARAM_TYPES(TEE_PARAM_TYPE_NONE, TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE, TEE_PARAM_TYPE_NONE))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	tp_event_mask = 0;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_memref(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	if (type != TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+				    TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mutex_lock(&tp_mu);
+
+	if (tp_global) {
+		p[0].value.a = virt_to_phys(tp_global);
+		p[0].value.b = tp_size;
+	} else {
+		p[0].value.a = 0;
+		p[0].value.b = 0;
+	}
+
+	mutex_unlock(&tp_mu);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result invoke_command(void *psess __unused,
+				 uint32_t cmd, uint32_t ptypes,
+				 TEE_Param params[TEE_NUM_PARAMS])
+{
+	switch (cmd) {
+	case PTA_TRACEPOINT_START:
+		return start_tracing(ptypes, params);
+	case PTA_TRACEPOINT_STOP:
+		return stop_tracing(ptypes, params);
+	case PTA_TRACEPOINT_GET_MEMREF:
+		return get_memref(ptypes, params);
+	default:
+		break;
+	}
+
+	return TEE_ERROR_BAD_PARAMETERS;
+}
+
+pseudo_ta_register(.uuid = PTA_TRACEPOINT_UUID, .name = TA_NAME,
+		   .flags = PTA_DEFAULT_FLAGS,
+		   .invoke_command_entry_point = invoke_command);
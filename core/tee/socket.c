@@ -3,22 +3,250 @@
  * Copyright (c) 2016-2017, Linaro Limited
  */
 
+#include <__tee_tcpsocket_defines.h>
 #include <assert.h>
 #include <mm/mobj.h>
 #include <kernel/pseudo_ta.h>
 #include <optee_rpc_cmd.h>
 #include <pta_socket.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/queue.h>
 #include <tee/tee_fs_rpc.h>
+#include <util.h>
+
+/* Header of a ring, see OPTEE_RPC_SOCKET_SET_STREAM */
+struct socket_ring {
+	uint32_t head;
+	uint32_t tail;
+	uint8_t data[];
+};
+
+/*
+ * struct socket_stream - rings of a streaming socket
+ * @handle:	socket handle
+ * @ring_size:	size of the data of each ring
+ * @tx_head:	secure copy of @tx->head, only updated by us
+ * @rx_tail:	secure copy of @rx->tail, only updated by us
+ * @mobj:	shared memory holding the rings
+ * @tx:		ring of data to send
+ * @rx:		ring of received data
+ */
+struct socket_stream {
+	uint32_t handle;
+	uint32_t ring_size;
+	uint32_t tx_head;
+	uint32_t rx_tail;
+	struct mobj *mobj;
+	struct socket_ring *tx;
+	struct socket_ring *rx;
+	SLIST_ENTRY(socket_stream) link;
+};
+
+struct socket_sess {
+	uint32_t instance_id;
+	SLIST_HEAD(, socket_stream) streams;
+};
 
 static uint32_t get_instance_id(struct tee_ta_session *sess)
 {
 	return sess->ctx->ops->get_instance_id(sess->ctx);
 }
 
-static TEE_Result socket_open(uint32_t instance_id, uint32_t param_types,
+static struct socket_stream *find_stream(struct socket_sess *ss,
+					 uint32_t handle)
+{
+	struct socket_stream *st = NULL;
+
+	SLIST_FOREACH(st, &ss->streams, link)
+		if (st->handle == handle)
+			return st;
+
+	return NULL;
+}
+
+static void free_stream(struct socket_stream *st)
+{
+	thread_rpc_free_payload(st->mobj);
+	free(st);
+}
+
+static void setup_stream(struct socket_sess *ss, uint32_t handle,
+			 uint32_t ring_size)
+{
+	size_t ring_bytes = sizeof(struct socket_ring) + ring_size;
+	struct socket_stream *st = calloc(1, sizeof(*st));
+	TEE_Result res = TEE_ERROR_GENERIC;
+	uint8_t *va = NULL;
+
+	if (!st)
+		return;
+
+	st->mobj = thread_rpc_alloc_payload(2 * ring_bytes);
+	if (!st->mobj)
+		goto err;
+	va = mobj_get_va(st->mobj, 0);
+	if (!va)
+		goto err;
+	memset(va, 0, 2 * ring_bytes);
+
+	struct thread_param tpm[3] = {
+		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_SET_STREAM,
+					 ss->instance_id, handle),
+		[1] = THREAD_PARAM_VALUE(IN, ring_size, 0, 0),
+		[2] = THREAD_PARAM_MEMREF(IN, st->mobj, 0, 2 * ring_bytes),
+	};
+
+	/* Normal world not supporting streaming isn't an error */
+	res = thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 3, tpm);
+	if (res) {
+		DMSG("No streaming for socket %#"PRIx32": %#"PRIx32,
+		     handle, res);
+		goto err;
+	}
+
+	st->handle = handle;
+	st->ring_size = ring_size;
+	st->tx = (struct socket_ring *)va;
+	st->rx = (struct socket_ring *)(va + ring_bytes);
+	SLIST_INSERT_HEAD(&ss->streams, st, link);
+	return;
+err:
+	if (st->mobj)
+		thread_rpc_free_payload(st->mobj);
+	free(st);
+}
+
+/*
+ * The counters of the rings are in non-secure memory, the counter updated
+ * by normal world is checked before it's used.
+ */
+static uint32_t ring_load(uint32_t *p)
+{
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static void ring_store(uint32_t *p, uint32_t val)
+{
+	__atomic_store_n(p, val, __ATOMIC_RELEASE);
+}
+
+static void ring_copy_in(struct socket_ring *r, uint32_t ring_size,
+			 uint32_t pos, const uint8_t *buf, size_t len)
+{
+	size_t offs = pos & (ring_size - 1);
+	size_t n = MIN(len, ring_size - offs);
+
+	memcpy(r->data + offs, buf, n);
+	memcpy(r->data, buf + n, len - n);
+}
+
+static void ring_copy_out(struct socket_ring *r, uint32_t ring_size,
+			  uint32_t pos, uint8_t *buf, size_t len)
+{
+	size_t offs = pos & (ring_size - 1);
+	size_t n = MIN(len, ring_size - offs);
+
+	memcpy(buf, r->data + offs, n);
+	memcpy(buf + n, r->data, len - n);
+}
+
+static TEE_Result stream_write(struct socket_stream *st, const uint8_t *buf,
+			       size_t len, size_t *written)
+{
+	uint32_t used = st->tx_head - ring_load(&st->tx->tail);
+	size_t n = 0;
+
+	if (used > st->ring_size)
+		return TEE_ERROR_CORRUPT_OBJECT;
+
+	n = MIN(len, st->ring_size - used);
+	ring_copy_in(st->tx, st->ring_size, st->tx_head, buf, n);
+	st->tx_head += n;
+	ring_store(&st->tx->head, st->tx_head);
+	*written = n;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result stream_read(struct socket_stream *st, uint8_t *buf,
+			      size_t len, size_t *read)
+{
+	uint32_t avail = ring_load(&st->rx->head) - st->rx_tail;
+	size_t n = 0;
+
+	if (avail > st->ring_size)
+		return TEE_ERROR_CORRUPT_OBJECT;
+
+	n = MIN(len, avail);
+	ring_copy_out(st->rx, st->ring_size, st->rx_tail, buf, n);
+	st->rx_tail += n;
+	ring_store(&st->rx->tail, st->rx_tail);
+	*read = n;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result stream_sync(struct socket_sess *ss, struct socket_stream *st,
+			      uint32_t timeout, uint32_t flags)
+{
+	struct thread_param tpm[2] = {
+		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_STREAM_SYNC,
+					 ss->instance_id, st->handle),
+		[1] = THREAD_PARAM_VALUE(IN, timeout, flags, 0),
+	};
+
+	return thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 2, tpm);
+}
+
+static TEE_Result stream_send(struct socket_sess *ss, struct socket_stream *st,
+			      const uint8_t *buf, size_t len, uint32_t timeout,
+			      size_t *sent)
+{
+	TEE_Result res = TEE_SUCCESS;
+	bool synced = false;
+	size_t n = 0;
+
+	*sent = 0;
+	while (true) {
+		res = stream_write(st, buf + *sent, len - *sent, &n);
+		if (res)
+			return res;
+		*sent += n;
+		/* Nothing more could be sent before the timeout */
+		if (*sent == len || (synced && !n))
+			return TEE_SUCCESS;
+
+		/* The TX ring is full, have normal world send it */
+		res = stream_sync(ss, st, timeout, 0);
+		if (res)
+			return res;
+		synced = true;
+	}
+}
+
+static TEE_Result stream_recv(struct socket_sess *ss, struct socket_stream *st,
+			      uint8_t *buf, size_t len, uint32_t timeout,
+			      size_t *received)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	res = stream_read(st, buf, len, received);
+	if (res || *received || !len)
+		return res;
+
+	/* Nothing received yet, send what's queued and wait for data */
+	res = stream_sync(ss, st, timeout, OPTEE_RPC_SOCKET_SYNC_RECV);
+	if (res)
+		return res;
+
+	return stream_read(st, buf, len, received);
+}
+
+static TEE_Result socket_open(struct socket_sess *ss, uint32_t param_types,
 			      TEE_Param params[TEE_NUM_PARAMS])
 {
+	uint32_t ring_size = 0;
 	struct mobj *mobj;
 	TEE_Result res;
 	void *va;
@@ -33,6 +261,13 @@ static TEE_Result socket_open(uint32_t instance_id, uint32_t param_types,
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
 
+	ring_size = params[2].value.b;
+	if (ring_size && (params[2].value.a != TEE_ISOCKET_PROTOCOLID_TCP ||
+			  !IS_POWER_OF_TWO(ring_size) ||
+			  ring_size < PTA_SOCKET_RING_MIN_SIZE ||
+			  ring_size > PTA_SOCKET_RING_MAX_SIZE))
+		return TEE_ERROR_BAD_PARAMETERS;
+
 	va = tee_fs_rpc_cache_alloc(params[1].memref.size, &mobj);
 	if (!va)
 		return TEE_ERROR_OUT_OF_MEMORY;
@@ -41,7 +276,7 @@ static TEE_Result socket_open(uint32_t instance_id, uint32_t param_types,
 
 	struct thread_param tpm[4] = {
 		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_OPEN,
-					 instance_id, 0),
+					 ss->instance_id, 0),
 		[1] = THREAD_PARAM_VALUE(IN,
 				params[0].value.b, /* server port number */
 				params[2].value.a, /* protocol */
@@ -51,15 +286,22 @@ static TEE_Result socket_open(uint32_t instance_id, uint32_t param_types,
 	};
 
 	res = thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 4, tpm);
-	if (res == TEE_SUCCESS)
-		params[3].value.a = tpm[3].u.value.a;
+	if (res != TEE_SUCCESS)
+		return res;
 
-	return res;
+	params[3].value.a = tpm[3].u.value.a;
+	if (ring_size)
+		setup_stream(ss, params[3].value.a, ring_size);
+	params[3].value.b = !!find_stream(ss, params[3].value.a);
+
+	return TEE_SUCCESS;
 }
 
-static TEE_Result socket_close(uint32_t instance_id, uint32_t param_types,
+static TEE_Result socket_close(struct socket_sess *ss, uint32_t param_types,
 			       TEE_Param params[TEE_NUM_PARAMS])
 {
+	struct socket_stream *st = NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
 	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
 					  TEE_PARAM_TYPE_NONE,
 					  TEE_PARAM_TYPE_NONE,
@@ -72,15 +314,26 @@ static TEE_Result socket_close(uint32_t instance_id, uint32_t param_types,
 	}
 
 	struct thread_param tpm = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_CLOSE,
-						     instance_id,
+						     ss->instance_id,
 						     params[0].value.a);
 
-	return thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 1, &tpm);
+	/* Normal world sends what's left in the TX ring before closing */
+	res = thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 1, &tpm);
+
+	st = find_stream(ss, params[0].value.a);
+	if (st) {
+		SLIST_REMOVE(&ss->streams, st, socket_stream, link);
+		free_stream(st);
+	}
+
+	return res;
 }
 
-static TEE_Result socket_send(uint32_t instance_id, uint32_t param_types,
+static TEE_Result socket_send(struct socket_sess *ss, uint32_t param_types,
 			      TEE_Param params[TEE_NUM_PARAMS])
 {
+	struct socket_stream *st = NULL;
+	size_t sent = 0;
 	struct mobj *mobj;
 	TEE_Result res;
 	void *va;
@@ -95,6 +348,15 @@ static TEE_Result socket_send(uint32_t instance_id, uint32_t param_types,
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
 
+	st = find_stream(ss, params[0].value.a);
+	if (st) {
+		res = stream_send(ss, st, params[1].memref.buffer,
+				  params[1].memref.size, params[0].value.b,
+				  &sent);
+		params[2].value.a = sent;
+		return res;
+	}
+
 	va = tee_fs_rpc_cache_alloc(params[1].memref.size, &mobj);
 	if (!va)
 		return TEE_ERROR_OUT_OF_MEMORY;
@@ -102,7 +364,8 @@ static TEE_Result socket_send(uint32_t instance_id, uint32_t param_types,
 	memcpy(va, params[1].memref.buffer, params[1].memref.size);
 
 	struct thread_param tpm[3] = {
-		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_SEND, instance_id,
+		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_SEND,
+					 ss->instance_id,
 					 params[0].value.a /* handle */),
 		[1] = THREAD_PARAM_MEMREF(IN, mobj, 0, params[1].memref.size),
 		[2] = THREAD_PARAM_VALUE(INOUT, params[0].value.b, /* timeout */
@@ -115,9 +378,11 @@ static TEE_Result socket_send(uint32_t instance_id, uint32_t param_types,
 	return res;
 }
 
-static TEE_Result socket_recv(uint32_t instance_id, uint32_t param_types,
+static TEE_Result socket_recv(struct socket_sess *ss, uint32_t param_types,
 			      TEE_Param params[TEE_NUM_PARAMS])
 {
+	struct socket_stream *st = NULL;
+	size_t received = 0;
 	struct mobj *mobj;
 	TEE_Result res;
 	void *va;
@@ -132,12 +397,22 @@ static TEE_Result socket_recv(uint32_t instance_id, uint32_t param_types,
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
 
+	st = find_stream(ss, params[0].value.a);
+	if (st) {
+		res = stream_recv(ss, st, params[1].memref.buffer,
+				  params[1].memref.size, params[0].value.b,
+				  &received);
+		params[1].memref.size = received;
+		return res;
+	}
+
 	va = tee_fs_rpc_cache_alloc(params[1].memref.size, &mobj);
 	if (!va)
 		return TEE_ERROR_OUT_OF_MEMORY;
 
 	struct thread_param tpm[3] = {
-		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_RECV, instance_id,
+		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_RECV,
+					 ss->instance_id,
 					 params[0].value.a /* handle */),
 		[1] = THREAD_PARAM_MEMREF(OUT, mobj, 0, params[1].memref.size),
 		[2] = THREAD_PARAM_VALUE(IN, params[0].value.b /* timeout */,
@@ -155,7 +430,7 @@ static TEE_Result socket_recv(uint32_t instance_id, uint32_t param_types,
 	return res;
 }
 
-static TEE_Result socket_ioctl(uint32_t instance_id, uint32_t param_types,
+static TEE_Result socket_ioctl(struct socket_sess *ss, uint32_t param_types,
 			       TEE_Param params[TEE_NUM_PARAMS])
 {
 	struct mobj *mobj;
@@ -180,7 +455,7 @@ static TEE_Result socket_ioctl(uint32_t instance_id, uint32_t param_types,
 
 	struct thread_param tpm[3] = {
 		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_IOCTL,
-					 instance_id,
+					 ss->instance_id,
 					 params[0].value.a /* handle */),
 		[1] = THREAD_PARAM_MEMREF(INOUT, mobj, 0,
 					  params[1].memref.size),
@@ -198,7 +473,290 @@ static TEE_Result socket_ioctl(uint32_t instance_id, uint32_t param_types,
 	return res;
 }
 
-typedef TEE_Result (*ta_func)(uint32_t instance_id, uint32_t param_types,
+static TEE_Result socket_flush(struct socket_sess *ss, uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS])
+{
+	struct socket_stream *st = NULL;
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+
+	if (exp_pt != param_types) {
+		DMSG("got param_types 0x%x, expected 0x%x",
+		     param_types, exp_pt);
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	st = find_stream(ss, params[0].value.a);
+	if (!st || st->tx_head == ring_load(&st->tx->tail))
+		return TEE_SUCCESS;
+
+	return stream_sync(ss, st, params[0].value.b /* timeout */, 0);
+}
+
+/*
+ * Copies the message lengths of PTA_SOCKET_SENDMMSG and
+ * PTA_SOCKET_RECVMMSG from params[2] and checks that the messages fit in
+ * params[1].
+ */
+static TEE_Result get_mmsg_lens(TEE_Param params[TEE_NUM_PARAMS],
+				uint32_t lens[PTA_SOCKET_MMSG_MAX],
+				size_t *count, size_t *total)
+{
+	size_t tot = 0;
+	size_t n = 0;
+	size_t i = 0;
+
+	if (params[2].memref.size % sizeof(uint32_t))
+		return TEE_ERROR_BAD_PARAMETERS;
+	n = params[2].memref.size / sizeof(uint32_t);
+	if (!n || n > PTA_SOCKET_MMSG_MAX)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	memcpy(lens, params[2].memref.buffer, n * sizeof(uint32_t));
+	for (i = 0; i < n; i++)
+		if (ADD_OVERFLOW(tot, lens[i], &tot))
+			return TEE_ERROR_BAD_PARAMETERS;
+	if (tot > params[1].memref.size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	*count = n;
+	*total = tot;
+	return TEE_SUCCESS;
+}
+
+/*
+ * Copies the message lengths returned by normal world in @shm_lens to
+ * @out_lens and params[2], checking each against the length of its
+ * message.
+ */
+static TEE_Result put_mmsg_lens(TEE_Param params[TEE_NUM_PARAMS],
+				const uint32_t *lens, const uint32_t *shm_lens,
+				uint32_t *out_lens, size_t count)
+{
+	size_t i = 0;
+
+	memcpy(out_lens, shm_lens, count * sizeof(uint32_t));
+	for (i = 0; i < count; i++)
+		if (out_lens[i] > lens[i])
+			return TEE_ERROR_GENERIC;
+
+	memcpy(params[2].memref.buffer, out_lens, count * sizeof(uint32_t));
+	params[3].value.a = count;
+	return TEE_SUCCESS;
+}
+
+static TEE_Result stream_sendmmsg(struct socket_sess *ss,
+				  struct socket_stream *st,
+				  TEE_Param params[TEE_NUM_PARAMS],
+				  const uint32_t *lens, size_t count)
+{
+	uint32_t out_lens[PTA_SOCKET_MMSG_MAX] = { 0 };
+	const uint8_t *buf = params[1].memref.buffer;
+	TEE_Result res = TEE_SUCCESS;
+	size_t sent = 0;
+	size_t n = 0;
+
+	for (n = 0; n < count; n++) {
+		res = stream_send(ss, st, buf, lens[n], params[0].value.b,
+				  &sent);
+		if (res) {
+			/* Report the messages already sent, if any */
+			if (n)
+				break;
+			return res;
+		}
+		out_lens[n] = sent;
+		buf += lens[n];
+		if (sent != lens[n]) {
+			n++;
+			break;
+		}
+	}
+	memcpy(params[2].memref.buffer, out_lens, n * sizeof(uint32_t));
+	params[3].value.a = n;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result socket_sendmmsg(struct socket_sess *ss, uint32_t param_types,
+				  TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t out_lens[PTA_SOCKET_MMSG_MAX] = { 0 };
+	uint32_t lens[PTA_SOCKET_MMSG_MAX] = { 0 };
+	struct socket_stream *st = NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	struct mobj *mobj = NULL;
+	size_t lens_sz = 0;
+	size_t count = 0;
+	size_t tot = 0;
+	uint8_t *va = NULL;
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_MEMREF_INPUT,
+					  TEE_PARAM_TYPE_MEMREF_INOUT,
+					  TEE_PARAM_TYPE_VALUE_OUTPUT);
+
+	if (exp_pt != param_types) {
+		DMSG("got param_types 0x%x, expected 0x%x",
+		     param_types, exp_pt);
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	res = get_mmsg_lens(params, lens, &count, &tot);
+	if (res)
+		return res;
+
+	st = find_stream(ss, params[0].value.a);
+	if (st)
+		return stream_sendmmsg(ss, st, params, lens, count);
+
+	/* The lengths followed by the messages in one payload buffer */
+	lens_sz = ROUNDUP(count * sizeof(uint32_t), sizeof(uint64_t));
+	va = tee_fs_rpc_cache_alloc(lens_sz + tot, &mobj);
+	if (!va)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	memcpy(va, lens, count * sizeof(uint32_t));
+	memcpy(va + lens_sz, params[1].memref.buffer, tot);
+
+	struct thread_param tpm[4] = {
+		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_SENDMMSG,
+					 ss->instance_id,
+					 params[0].value.a /* handle */),
+		[1] = THREAD_PARAM_MEMREF(IN, mobj, lens_sz, tot),
+		[2] = THREAD_PARAM_MEMREF(INOUT, mobj, 0,
+					  count * sizeof(uint32_t)),
+		[3] = THREAD_PARAM_VALUE(INOUT, params[0].value.b, /* timeout */
+					 0, 0),
+	};
+
+	/*
+	 * Normal world may fail after some of the messages are sent, those
+	 * are reported as a successful send of fewer messages.
+	 */
+	res = thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 4, tpm);
+	if (res && !tpm[3].u.value.b)
+		return res;
+	if (tpm[3].u.value.b > count)
+		return TEE_ERROR_GENERIC;
+
+	return put_mmsg_lens(params, lens, (uint32_t *)va, out_lens,
+			     tpm[3].u.value.b);
+}
+
+static TEE_Result stream_recvmmsg(struct socket_sess *ss,
+				  struct socket_stream *st,
+				  TEE_Param params[TEE_NUM_PARAMS],
+				  const uint32_t *lens, size_t count)
+{
+	uint32_t out_lens[PTA_SOCKET_MMSG_MAX] = { 0 };
+	uint8_t *buf = params[1].memref.buffer;
+	TEE_Result res = TEE_SUCCESS;
+	size_t received = 0;
+	size_t n = 0;
+
+	for (n = 0; n < count; n++) {
+		/* Only the first message may wait for data */
+		if (n)
+			res = stream_read(st, buf, lens[n], &received);
+		else
+			res = stream_recv(ss, st, buf, lens[n],
+					  params[0].value.b, &received);
+		if (res) {
+			/* Report the messages already received, if any */
+			if (n)
+				break;
+			return res;
+		}
+		if (n && !received)
+			break;
+		out_lens[n] = received;
+		buf += lens[n];
+	}
+	memcpy(params[2].memref.buffer, out_lens, n * sizeof(uint32_t));
+	params[3].value.a = n;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result socket_recvmmsg(struct socket_sess *ss, uint32_t param_types,
+				  TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t out_lens[PTA_SOCKET_MMSG_MAX] = { 0 };
+	uint32_t lens[PTA_SOCKET_MMSG_MAX] = { 0 };
+	struct socket_stream *st = NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	struct mobj *mobj = NULL;
+	size_t lens_sz = 0;
+	size_t count = 0;
+	size_t offs = 0;
+	size_t tot = 0;
+	uint8_t *va = NULL;
+	size_t n = 0;
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_MEMREF_OUTPUT,
+					  TEE_PARAM_TYPE_MEMREF_INOUT,
+					  TEE_PARAM_TYPE_VALUE_OUTPUT);
+
+	if (exp_pt != param_types) {
+		DMSG("got param_types 0x%x, expected 0x%x",
+		     param_types, exp_pt);
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	res = get_mmsg_lens(params, lens, &count, &tot);
+	if (res)
+		return res;
+
+	st = find_stream(ss, params[0].value.a);
+	if (st)
+		return stream_recvmmsg(ss, st, params, lens, count);
+
+	/* The slot sizes followed by the slots in one payload buffer */
+	lens_sz = ROUNDUP(count * sizeof(uint32_t), sizeof(uint64_t));
+	va = tee_fs_rpc_cache_alloc(lens_sz + tot, &mobj);
+	if (!va)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	memcpy(va, lens, count * sizeof(uint32_t));
+
+	struct thread_param tpm[4] = {
+		[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_SOCKET_RECVMMSG,
+					 ss->instance_id,
+					 params[0].value.a /* handle */),
+		[1] = THREAD_PARAM_MEMREF(OUT, mobj, lens_sz, tot),
+		[2] = THREAD_PARAM_MEMREF(INOUT, mobj, 0,
+					  count * sizeof(uint32_t)),
+		[3] = THREAD_PARAM_VALUE(INOUT, params[0].value.b, /* timeout */
+					 0, 0),
+	};
+
+	/*
+	 * Normal world may fail after some of the messages are received,
+	 * those are reported as a successful receive of fewer messages.
+	 */
+	res = thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 4, tpm);
+	if (res && !tpm[3].u.value.b)
+		return res;
+	if (tpm[3].u.value.b > count)
+		return TEE_ERROR_GENERIC;
+
+	res = put_mmsg_lens(params, lens, (uint32_t *)va, out_lens,
+			     tpm[3].u.value.b);
+	if (res)
+		return res;
+
+	for (n = 0; n < tpm[3].u.value.b; n++) {
+		memcpy((uint8_t *)params[1].memref.buffer + offs,
+		       va + lens_sz + offs, out_lens[n]);
+		offs += lens[n];
+	}
+
+	return TEE_SUCCESS;
+}
+
+typedef TEE_Result (*ta_func)(struct socket_sess *ss, uint32_t param_types,
 			      TEE_Param params[TEE_NUM_PARAMS]);
 
 static const ta_func ta_funcs[] = {
@@ -207,6 +765,9 @@ static const ta_func ta_funcs[] = {
 	[PTA_SOCKET_SEND] = socket_send,
 	[PTA_SOCKET_RECV] = socket_recv,
 	[PTA_SOCKET_IOCTL] = socket_ioctl,
+	[PTA_SOCKET_FLUSH] = socket_flush,
+	[PTA_SOCKET_SENDMMSG] = socket_sendmmsg,
+	[PTA_SOCKET_RECVMMSG] = socket_recvmmsg,
 };
 
 /*
@@ -217,6 +778,7 @@ static TEE_Result pta_socket_open_session(uint32_t param_types __unused,
 			TEE_Param pParams[TEE_NUM_PARAMS] __unused,
 			void **sess_ctx)
 {
+	struct socket_sess *ss = NULL;
 	struct tee_ta_session *s;
 
 	/* Check that we're called from a TA */
@@ -224,30 +786,45 @@ static TEE_Result pta_socket_open_session(uint32_t param_types __unused,
 	if (!s)
 		return TEE_ERROR_ACCESS_DENIED;
 
-	*sess_ctx = (void *)(vaddr_t)get_instance_id(s);
+	ss = calloc(1, sizeof(*ss));
+	if (!ss)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	ss->instance_id = get_instance_id(s);
+	SLIST_INIT(&ss->streams);
+	*sess_ctx = ss;
 
 	return TEE_SUCCESS;
 }
 
 static void pta_socket_close_session(void *sess_ctx)
 {
+	struct socket_sess *ss = sess_ctx;
+	struct socket_stream *st = NULL;
 	TEE_Result res;
 	struct thread_param tpm = {
 		.attr = THREAD_PARAM_ATTR_VALUE_IN, .u.value = {
-			.a = OPTEE_RPC_SOCKET_CLOSE_ALL, .b = (vaddr_t)sess_ctx,
+			.a = OPTEE_RPC_SOCKET_CLOSE_ALL, .b = ss->instance_id,
 		},
 	};
 
 	res = thread_rpc_cmd(OPTEE_RPC_CMD_SOCKET, 1, &tpm);
 	if (res != TEE_SUCCESS)
 		DMSG("OPTEE_RPC_SOCKET_CLOSE_ALL failed: %#" PRIx32, res);
+
+	while (!SLIST_EMPTY(&ss->streams)) {
+		st = SLIST_FIRST(&ss->streams);
+		SLIST_REMOVE_HEAD(&ss->streams, link);
+		free_stream(st);
+	}
+	free(ss);
 }
 
 static TEE_Result pta_socket_invoke_command(void *sess_ctx, uint32_t cmd_id,
 			uint32_t param_types, TEE_Param params[TEE_NUM_PARAMS])
 {
 	if (cmd_id < ARRAY_SIZE(ta_funcs) && ta_funcs[cmd_id])
-		return ta_funcs[cmd_id]((vaddr_t)sess_ctx, param_types, params);
+		return ta_funcs[cmd_id](sess_ctx, param_types, params);
 
 	return TEE_ERROR_NOT_IMPLEMENTED;
 }
@@ -6,6 +6,7 @@
 #include <assert.h>
 #include <kernel/tee_misc.h>
 #include <kernel/thread.h>
+#include <kernel/tracepoint.h>
 #include <mm/core_memprot.h>
 #include <optee_rpc_cmd.h>
 #include <stdlib.h>
@@ -25,7 +26,13 @@ struct tee_fs_dir {
 
 static TEE_Result operation_commit(struct tee_fs_rpc_operation *op)
 {
-	return thread_rpc_cmd(op->id, op->num_params, op->params);
+	TEE_Result res = TEE_SUCCESS;
+
+	trace_storage_rpc(op->id, op->params[0].u.value.a);
+	res = thread_rpc_cmd(op->id, op->num_params, op->params);
+	trace_storage_rpc_done(op->id, res);
+
+	return res;
 }
 
 static TEE_Result operation_open(uint32_t id, unsigned int cmd,
@@ -5,6 +5,7 @@
 
 #include <assert.h>
 #include <crypto/crypto.h>
+#include <kernel/boot_prof.h>
 #include <kernel/huk_subkey.h>
 #include <kernel/misc.h>
 #include <kernel/msg_param.h>
@@ -14,6 +15,7 @@
 #include <kernel/tee_common_otp.h>
 #include <kernel/tee_misc.h>
 #include <kernel/thread.h>
+#include <kernel/tracepoint.h>
 #include <mm/core_memprot.h>
 #include <mm/mobj.h>
 #include <mm/tee_mm.h>
@@ -432,8 +434,13 @@ static TEE_Result tee_rpmb_invoke(struct tee_rpmb_mem *mem)
 		[1] = THREAD_PARAM_MEMREF(OUT, mem->phresp_mobj, 0,
 					  mem->resp_size),
 	};
+	TEE_Result res = TEE_SUCCESS;
+
+	trace_storage_rpc(OPTEE_RPC_CMD_RPMB, mem->req_size);
+	res = thread_rpc_cmd(OPTEE_RPC_CMD_RPMB, 2, params);
+	trace_storage_rpc_done(OPTEE_RPC_CMD_RPMB, res);
 
-	return thread_rpc_cmd(OPTEE_RPC_CMD_RPMB, 2, params);
+	return res;
 }
 
 static bool is_zero(const uint8_t *buf, size_t size)
@@ -1595,12 +1602,16 @@ static TEE_Result rpmb_fs_setup(void)
 	struct rpmb_fs_partition *partition_data = NULL;
 	struct rpmb_file_handle *fh = NULL;
 	uint32_t max_rpmb_block = 0;
+	uint64_t begin = 0;
 
 	if (fs_par) {
 		res = TEE_SUCCESS;
 		goto out;
 	}
 
+	/* Done on first use, recorded with the boot steps */
+	begin = boot_prof_begin();
+
 	res = tee_rpmb_get_max_block(CFG_RPMB_FS_DEV_ID, &max_rpmb_block);
 	if (res != TEE_SUCCESS)
 		goto out;
@@ -1675,6 +1686,7 @@ store_fs_par:
 	fs_par->max_rpmb_address = max_rpmb_block << RPMB_BLOCK_SIZE_SHIFT;
 
 	dump_fat();
+	boot_prof_end("rpmb setup", BOOT_PROF_PHASE, begin);
 
 out:
 	free(fh);
@@ -858,8 +858,8 @@ TEE_Result syscall_invoke_ta_command(unsigned long ta_sess,
 		return res;
 	utc = to_user_ta_ctx(sess->ctx);
 
-	called_sess = tee_ta_get_session((uint32_t)ta_sess, true,
-				&utc->open_sessions);
+	called_sess = tee_ta_get_invoke_session((uint32_t)ta_sess,
+						&utc->open_sessions);
 	if (!called_sess)
 		return TEE_ERROR_BAD_PARAMETERS;
 
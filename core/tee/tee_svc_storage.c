@@ -163,41 +163,192 @@ TEE_Result tee_svc_storage_create_dirname(void *buf, size_t blen,
 	return TEE_SUCCESS;
 }
 
+/*
+ * Persistent key cache
+ *
+ * The header and the deserialized attributes of the last opened persistent
+ * key objects are kept so that opening such an object again doesn't have
+ * to read and convert them. Entries are identified by the storage, the TA
+ * UUID and the object ID, and are dropped when the object is created,
+ * overwritten, renamed or removed as the stored attributes can't change
+ * otherwise. The attributes are wiped before being freed.
+ */
+struct key_cache_entry {
+	TAILQ_ENTRY(key_cache_entry) link;
+	const struct tee_file_operations *fops;
+	TEE_UUID uuid;
+	uint8_t obj_id[TEE_OBJECT_ID_MAX_LEN];
+	uint32_t obj_id_len;
+	struct tee_svc_storage_head head;
+	struct tee_obj *attr_o;
+};
+
+static TAILQ_HEAD(key_cache_head, key_cache_entry) key_cache =
+	TAILQ_HEAD_INITIALIZER(key_cache);
+static size_t key_cache_count;
+static struct mutex key_cache_mu = MUTEX_INITIALIZER;
+
+static struct key_cache_entry *key_cache_find(struct tee_pobj *po)
+{
+	struct key_cache_entry *e = NULL;
+
+	TAILQ_FOREACH(e, &key_cache, link)
+		if (e->fops == po->fops && e->obj_id_len == po->obj_id_len &&
+		    !memcmp(&e->uuid, &po->uuid, sizeof(TEE_UUID)) &&
+		    !memcmp(e->obj_id, po->obj_id, po->obj_id_len))
+			return e;
+
+	return NULL;
+}
+
+static void key_cache_free_entry(struct key_cache_entry *e)
+{
+	TAILQ_REMOVE(&key_cache, e, link);
+	key_cache_count--;
+
+	tee_obj_attr_clear(e->attr_o);
+	tee_obj_free(e->attr_o);
+	free(e);
+}
+
+static void key_cache_invalidate(struct tee_pobj *po)
+{
+	struct key_cache_entry *e = NULL;
+
+	if (!CFG_PERSISTENT_KEY_CACHE_SIZE || !po || !po->obj_id)
+		return;
+
+	mutex_lock(&key_cache_mu);
+	e = key_cache_find(po);
+	if (e)
+		key_cache_free_entry(e);
+	mutex_unlock(&key_cache_mu);
+}
+
+/*
+ * Set the type and the attributes of @o from the cache and return its
+ * header in @head. Returns TEE_ERROR_ITEM_NOT_FOUND if the object isn't
+ * cached or if the cached header doesn't fit the @size bytes file.
+ */
+static TEE_Result key_cache_get(struct tee_obj *o, size_t size,
+				struct tee_svc_storage_head *head)
+{
+	TEE_Result res = TEE_ERROR_ITEM_NOT_FOUND;
+	struct key_cache_entry *e = NULL;
+
+	if (!CFG_PERSISTENT_KEY_CACHE_SIZE)
+		return TEE_ERROR_ITEM_NOT_FOUND;
+
+	mutex_lock(&key_cache_mu);
+
+	e = key_cache_find(o->pobj);
+	if (!e)
+		goto out;
+
+	if (sizeof(*head) + e->head.attr_size > size) {
+		key_cache_free_entry(e);
+		goto out;
+	}
+
+	res = tee_obj_set_type(o, e->head.objectType, e->head.maxKeySize);
+	if (!res)
+		res = tee_obj_attr_copy_from(o, e->attr_o);
+	if (res)
+		goto out;
+
+	*head = e->head;
+	o->ds_pos = sizeof(*head) + head->attr_size;
+
+	/* Most recently used first */
+	TAILQ_REMOVE(&key_cache, e, link);
+	TAILQ_INSERT_HEAD(&key_cache, e, link);
+out:
+	mutex_unlock(&key_cache_mu);
+
+	return res;
+}
+
+/* Keep the attributes of @o just read from storage, evicting the LRU entry */
+static void key_cache_put(struct tee_obj *o,
+			  const struct tee_svc_storage_head *head)
+{
+	struct key_cache_entry *e = NULL;
+	struct tee_pobj *po = o->pobj;
+
+	if (!CFG_PERSISTENT_KEY_CACHE_SIZE ||
+	    head->objectType == TEE_TYPE_DATA || !head->attr_size ||
+	    po->obj_id_len > sizeof(e->obj_id))
+		return;
+
+	e = calloc(1, sizeof(*e));
+	if (!e)
+		return;
+
+	e->attr_o = tee_obj_alloc();
+	if (!e->attr_o)
+		goto err;
+
+	if (tee_obj_set_type(e->attr_o, head->objectType, head->maxKeySize) ||
+	    tee_obj_attr_copy_from(e->attr_o, o))
+		goto err;
+
+	e->fops = po->fops;
+	e->uuid = po->uuid;
+	memcpy(e->obj_id, po->obj_id, po->obj_id_len);
+	e->obj_id_len = po->obj_id_len;
+	e->head = *head;
+
+	mutex_lock(&key_cache_mu);
+	if (key_cache_find(po)) {
+		/* Cached meanwhile by a concurrent open */
+		mutex_unlock(&key_cache_mu);
+		goto err;
+	}
+	if (key_cache_count == CFG_PERSISTENT_KEY_CACHE_SIZE)
+		key_cache_free_entry(TAILQ_LAST(&key_cache, key_cache_head));
+	TAILQ_INSERT_HEAD(&key_cache, e, link);
+	key_cache_count++;
+	mutex_unlock(&key_cache_mu);
+
+	return;
+err:
+	if (e->attr_o) {
+		tee_obj_attr_clear(e->attr_o);
+		tee_obj_free(e->attr_o);
+	}
+	free(e);
+}
+
 static TEE_Result tee_svc_storage_remove_corrupt_obj(
 					struct tee_ta_session *sess,
 					struct tee_obj *o)
 {
+	key_cache_invalidate(o->pobj);
 	o->pobj->fops->remove(o->pobj);
 	tee_obj_close(to_user_ta_ctx(sess->ctx), o);
 
 	return TEE_SUCCESS;
 }
 
-static TEE_Result tee_svc_storage_read_head(struct tee_obj *o)
+static TEE_Result tee_svc_storage_read_attrs(struct tee_obj *o, size_t size,
+					     struct tee_svc_storage_head *head)
 {
 	TEE_Result res = TEE_SUCCESS;
 	size_t bytes;
-	struct tee_svc_storage_head head;
 	const struct tee_file_operations *fops = o->pobj->fops;
 	void *attr = NULL;
-	size_t size;
 	size_t tmp = 0;
 
-	assert(!o->fh);
-	res = fops->open(o->pobj, &size, &o->fh);
-	if (res != TEE_SUCCESS)
-		goto exit;
-
 	/* read head */
 	bytes = sizeof(struct tee_svc_storage_head);
-	res = fops->read(o->fh, 0, &head, &bytes);
+	res = fops->read(o->fh, 0, head, &bytes);
 	if (res != TEE_SUCCESS) {
 		if (res == TEE_ERROR_CORRUPT_OBJECT)
 			EMSG("Head corrupt");
 		goto exit;
 	}
 
-	if (ADD_OVERFLOW(sizeof(head), head.attr_size, &tmp)) {
+	if (ADD_OVERFLOW(sizeof(*head), head->attr_size, &tmp)) {
 		res = TEE_ERROR_OVERFLOW;
 		goto exit;
 	}
@@ -211,45 +362,70 @@ static TEE_Result tee_svc_storage_read_head(struct tee_obj *o)
 		goto exit;
 	}
 
-	res = tee_obj_set_type(o, head.objectType, head.maxKeySize);
+	res = tee_obj_set_type(o, head->objectType, head->maxKeySize);
 	if (res != TEE_SUCCESS)
 		goto exit;
 
 	o->ds_pos = tmp;
 
-	if (head.attr_size) {
-		attr = malloc(head.attr_size);
+	if (head->attr_size) {
+		attr = malloc(head->attr_size);
 		if (!attr) {
 			res = TEE_ERROR_OUT_OF_MEMORY;
 			goto exit;
 		}
 
 		/* read meta */
-		bytes = head.attr_size;
+		bytes = head->attr_size;
 		res = fops->read(o->fh, sizeof(struct tee_svc_storage_head),
 				 attr, &bytes);
 		if (res == TEE_ERROR_OUT_OF_MEMORY)
 			goto exit;
-		if (res != TEE_SUCCESS || bytes != head.attr_size)
+		if (res != TEE_SUCCESS || bytes != head->attr_size)
 			res = TEE_ERROR_CORRUPT_OBJECT;
 		if (res)
 			goto exit;
 	}
 
-	res = tee_obj_attr_from_binary(o, attr, head.attr_size);
+	res = tee_obj_attr_from_binary(o, attr, head->attr_size);
 	if (res != TEE_SUCCESS)
 		goto exit;
 
+	key_cache_put(o, head);
+
+exit:
+	if (attr)
+		memset(attr, 0, head->attr_size);
+	free(attr);
+
+	return res;
+}
+
+static TEE_Result tee_svc_storage_read_head(struct tee_obj *o)
+{
+	TEE_Result res = TEE_SUCCESS;
+	struct tee_svc_storage_head head;
+	const struct tee_file_operations *fops = o->pobj->fops;
+	size_t size;
+
+	assert(!o->fh);
+	res = fops->open(o->pobj, &size, &o->fh);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = key_cache_get(o, size, &head);
+	if (res == TEE_ERROR_ITEM_NOT_FOUND)
+		res = tee_svc_storage_read_attrs(o, size, &head);
+	if (res != TEE_SUCCESS)
+		return res;
+
 	o->info.dataSize = size - sizeof(head) - head.attr_size;
 	o->info.keySize = head.keySize;
 	o->info.objectUsage = head.objectUsage;
 	o->info.objectType = head.objectType;
 	o->have_attrs = head.have_attrs;
 
-exit:
-	free(attr);
-
-	return res;
+	return TEE_SUCCESS;
 }
 
 TEE_Result syscall_storage_obj_open(unsigned long storage_id, void *object_id,
@@ -466,6 +642,7 @@ TEE_Result syscall_storage_obj_create(unsigned long storage_id, void *object_id,
 	}
 
 	res = tee_svc_storage_init_file(o, attr_o, data, len);
+	key_cache_invalidate(po);
 	if (res != TEE_SUCCESS)
 		goto err;
 
@@ -519,6 +696,7 @@ TEE_Result syscall_storage_obj_del(unsigned long obj)
 	if (o->pobj == NULL || o->pobj->obj_id == NULL)
 		return TEE_ERROR_BAD_STATE;
 
+	key_cache_invalidate(o->pobj);
 	res = o->pobj->fops->remove(o->pobj);
 	tee_obj_close(utc, o);
 
@@ -578,6 +756,8 @@ TEE_Result syscall_storage_obj_rename(unsigned long obj, void *object_id,
 		goto exit;
 
 	/* move */
+	key_cache_invalidate(o->pobj);
+	key_cache_invalidate(po);
 	res = fops->rename(o->pobj, po, false /* no overwrite */);
 	if (res)
 		goto exit;
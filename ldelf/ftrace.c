@@ -3,8 +3,10 @@
  * Copyright (c) 2019, Linaro Limited
  */
 
+#include <arm_user_sysreg.h>
 #include <assert.h>
 #include <printk.h>
+#include <string.h>
 #include <sys/queue.h>
 #include <types_ext.h>
 #include <util.h>
@@ -13,7 +15,7 @@
 #include "ta_elf.h"
 
 #define MIN_FTRACE_BUF_SIZE	1024
-#define MAX_HEADER_STRLEN	128
+#define MAX_HEADER_STRLEN	192
 
 static struct ftrace_buf *fbuf;
 
@@ -23,7 +25,9 @@ bool ftrace_init(struct ftrace_buf **fbuf_ptr)
 	struct ta_elf *elf = TAILQ_FIRST(&main_elf_queue);
 	TEE_Result res = TEE_SUCCESS;
 	vaddr_t val = 0;
-	int count = 0;
+	char *hdr = NULL;
+	size_t count = 0;
+	size_t pad = 0;
 	size_t fbuf_size = 0;
 
 	res = ta_elf_resolve_sym("__ftrace_info", &val, NULL);
@@ -38,25 +42,43 @@ bool ftrace_init(struct ftrace_buf **fbuf_ptr)
 			 &fbuf_size))
 		return false;
 
-	if (fbuf_size < MIN_FTRACE_BUF_SIZE) {
+	if (fbuf_size < MIN_FTRACE_BUF_SIZE ||
+	    fbuf_size < sizeof(struct ftrace_buf) + MAX_HEADER_STRLEN +
+			sizeof(struct ftrace_rec)) {
 		DMSG("ftrace buffer too small");
 		return false;
 	}
 
 	fbuf = (struct ftrace_buf *)(vaddr_t)finfo->buf_start.ptr64;
 	fbuf->head_off = sizeof(struct ftrace_buf);
-	count = snprintk((char *)fbuf + fbuf->head_off, MAX_HEADER_STRLEN,
-			 "Function graph for TA: %pUl @ %lx\n",
-			 (void *)&elf->uuid, elf->load_addr);
+	hdr = (char *)fbuf + fbuf->head_off;
+	count = snprintk(hdr, MAX_HEADER_STRLEN,
+			 "Function graph for TA: %pUl @ %lx\n"
+			 "Ftrace records: version %d size %zu cntfrq %"PRIu32,
+			 (void *)&elf->uuid, elf->load_addr,
+			 FTRACE_REC_VERSION, sizeof(struct ftrace_rec),
+			 read_cntfrq());
+	/*
+	 * Pad the header with spaces so that the binary records which
+	 * follow the final newline are naturally aligned.
+	 */
+	pad = ROUNDUP(fbuf->head_off + count + 1, sizeof(struct ftrace_rec)) -
+	      (fbuf->head_off + count + 1);
+	memset(hdr + count, ' ', pad);
+	count += pad;
+	hdr[count++] = '\n';
 	assert(count < MAX_HEADER_STRLEN);
 
 	fbuf->ret_func_ptr = finfo->ret_ptr.ptr64;
 	fbuf->ret_idx = 0;
 	fbuf->lr_idx = 0;
 	fbuf->suspend_time = 0;
+	fbuf->last_time = 0;
 	fbuf->buf_off = fbuf->head_off + count;
 	fbuf->curr_size = 0;
-	fbuf->max_size = fbuf_size - sizeof(struct ftrace_buf) - count;
+	fbuf->wr_off = 0;
+	fbuf->max_size = ROUNDDOWN(fbuf_size - fbuf->buf_off,
+				   sizeof(struct ftrace_rec));
 	fbuf->syscall_trace_enabled = false;
 	fbuf->syscall_trace_suspended = false;
 
@@ -70,11 +92,19 @@ void ftrace_copy_buf(void *pctx, void (*copy_func)(void *pctx, void *b,
 {
 	if (fbuf) {
 		struct ta_elf *elf = TAILQ_FIRST(&main_elf_queue);
-		size_t dump_size = fbuf->buf_off - fbuf->head_off +
-				   fbuf->curr_size;
+		char *ring = (char *)fbuf + fbuf->buf_off;
+		size_t tail = 0;
 
 		assert(elf && elf->is_main);
-		copy_func(pctx, (char *)fbuf + fbuf->head_off, dump_size);
+		copy_func(pctx, (char *)fbuf + fbuf->head_off,
+			  fbuf->buf_off - fbuf->head_off);
+
+		/* Oldest records first once the ring has wrapped */
+		if (fbuf->curr_size == fbuf->max_size) {
+			tail = fbuf->max_size - fbuf->wr_off;
+			copy_func(pctx, ring + fbuf->wr_off, tail);
+		}
+		copy_func(pctx, ring, fbuf->curr_size - tail);
 	}
 }
 
@@ -9,5 +9,13 @@
 /* Instance and implementation specific ioctl functions */
 #define TEE_TCP_SET_RECVBUF	0x65f00000
 #define TEE_TCP_SET_SENDBUF	0x65f00001
+/*
+ * Transmits the data queued on a socket opened with TEE_tcpStreamSocket,
+ * buf is a uint32_t timeout in ms or TEE_TIMEOUT_INFINITE
+ */
+#define TEE_TCP_FLUSH		0x65f00002
+
+/* Size of each ring of a socket opened with TEE_tcpStreamSocket */
+#define TEE_TCP_STREAM_RING_SIZE	(16 * 1024)
 
 #endif /*____TEE_TCPSOCKET_DEFINES_EXTENSIONS_H*/
@@ -73,5 +73,11 @@
  */
 #define PTA_INVOKE_TESTS_CMD_LOCKDEP		8
 
+/*
+ * Tests memcpy(), memmove(), memset(), memcmp() and strlen() and prints
+ * their throughput
+ */
+#define PTA_INVOKE_TESTS_CMD_STRING		9
+
 #endif /*__PTA_INVOKE_TESTS_H*/
 
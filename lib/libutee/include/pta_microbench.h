@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __PTA_MICROBENCH_H
+#define __PTA_MICROBENCH_H
+
+#include <stdint.h>
+
+/*
+ * Interface to the micro-benchmark pseudo-TA, which measures the cost of
+ * TEE core primitives.
+ */
+
+#define PTA_MICROBENCH_UUID { 0x8a4f2e1c, 0x3b6d, 0x4e0a, { \
+			      0xb5, 0x7c, 0x2d, 0x91, 0x6f, 0x40, 0xa3, 0x5e } }
+
+/*
+ * Run the benchmarks of the selected groups. The output buffer receives a
+ * struct microbench_header followed by struct microbench_header::nb_results
+ * struct microbench_result. If it is too small, the benchmarks are run
+ * anyway and TEE_ERROR_SHORT_BUFFER is returned with the required size.
+ *
+ * [in]     value[0].a: mask of groups, (1 << MICROBENCH_GROUP_*)
+ * [in]     value[0].b: number of iterations of each benchmark, 0 for the
+ *			default
+ * [out]    memref[1]: output buffer
+ */
+#define PTA_MICROBENCH_RUN		0
+
+/*
+ * Act as the peer of the mutex/condvar hand-off benchmark. This command
+ * blocks until the next PTA_MICROBENCH_RUN of MICROBENCH_GROUP_SYNC has
+ * completed the benchmark, it must be invoked from another thread before
+ * that run. Without a peer the hand-off benchmark is skipped.
+ */
+#define PTA_MICROBENCH_HANDOFF_PEER	1
+
+#define MICROBENCH_GROUP_HASH		0
+#define MICROBENCH_GROUP_CIPHER		1
+#define MICROBENCH_GROUP_AEAD		2
+#define MICROBENCH_GROUP_MEM		3
+#define MICROBENCH_GROUP_SYNC		4
+#define MICROBENCH_GROUP_RPC		5
+#define MICROBENCH_GROUP_PAGER		6
+#define MICROBENCH_GROUP_STORAGE	7
+
+#define MICROBENCH_VERSION		1
+#define MICROBENCH_NAME_LEN		24
+
+struct microbench_header {
+	uint32_t version;
+	uint32_t nb_results;
+	uint32_t cntfrq;	/* Frequency of the counter used for @ticks */
+	uint32_t reserved;
+};
+
+/*
+ * @name:	benchmark, e.g. "sha256" or "mutex lock/unlock"
+ * @group:	MICROBENCH_GROUP_*
+ * @size:	bytes processed by each iteration, 0 if not relevant
+ * @iterations:	number of iterations measured
+ * @ticks:	CNTPCT ticks for all iterations
+ * @cycles:	PMCCNTR cycles for all iterations, 0 if the cycle counter
+ *		isn't running in the secure world
+ */
+struct microbench_result {
+	char name[MICROBENCH_NAME_LEN];
+	uint32_t group;
+	uint32_t size;
+	uint32_t iterations;
+	uint32_t reserved;
+	uint64_t ticks;
+	uint64_t cycles;
+};
+
+#endif /* __PTA_MICROBENCH_H */
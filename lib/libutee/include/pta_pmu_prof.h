@@ -0,0 +1,73 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __PTA_PMU_PROF_H
+#define __PTA_PMU_PROF_H
+
+#include <stdint.h>
+
+/*
+ * Interface to the PMU profiler pseudo-TA, which samples the secure world
+ * (TEE core and TAs) on overflow of a Performance Monitors counter.
+ */
+
+#define PTA_PMU_PROF_UUID { 0x5c1d8d4a, 0x7ef5, 0x4b5d, { \
+			    0x9a, 0x3c, 0x51, 0xa2, 0x1d, 0x6b, 0x0e, 0x88 } }
+
+/*
+ * Start sampling on the calling core. The sample buffers are allocated the
+ * first time and are kept afterwards. Each core to profile has to call this
+ * command (for instance by pinning the client to each core in turn), all
+ * cores must use the same parameters.
+ *
+ * [in]     value[0].a: event, PMU_PROF_EVENT_*
+ * [in]     value[0].b: sampling period, in events
+ * [in]     value[1].a: number of samples per core, power of two
+ */
+#define PTA_PMU_PROF_START		0
+
+/*
+ * Stop sampling on all cores. Samples taken so far are kept.
+ */
+#define PTA_PMU_PROF_STOP		1
+
+/*
+ * Copy the samples taken so far and remove them from the sample buffers.
+ * The output is a struct pmu_prof_header followed by
+ * struct pmu_prof_header::nb_samples struct pmu_prof_sample.
+ *
+ * [out]    memref[0]: output buffer
+ */
+#define PTA_PMU_PROF_GET_SAMPLES	2
+
+#define PMU_PROF_EVENT_CYCLES		0
+#define PMU_PROF_EVENT_CACHE_MISSES	1
+#define PMU_PROF_EVENT_BRANCH_MISSES	2
+
+#define PMU_PROF_VERSION		1
+#define PMU_PROF_MAX_DEPTH		15
+
+/* The sample was taken in user mode, only @pc[0] is valid */
+#define PMU_PROF_SAMPLE_USER		(1 << 0)
+
+struct pmu_prof_header {
+	uint32_t version;
+	uint32_t event;
+	uint32_t period;
+	uint32_t nb_samples;
+	uint64_t load_addr;	/* TEE core load address */
+	uint64_t lost;		/* Samples dropped because a buffer was full */
+};
+
+/* @pc[0] is the sampled PC, @pc[1..depth - 1] the return addresses */
+struct pmu_prof_sample {
+	uint8_t core;
+	uint8_t flags;
+	uint16_t depth;
+	uint32_t reserved;
+	uint64_t pc[PMU_PROF_MAX_DEPTH];
+};
+
+#endif /* __PTA_PMU_PROF_H */
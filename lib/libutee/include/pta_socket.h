@@ -14,10 +14,24 @@
  * [in]		value[0].b	server port number
  * [in]		memref[1]	server address
  * [in]		value[2].a	protocol, TEE_ISOCKET_PROTOCOLID_*
+ * [in]		value[2].b	ring size for streaming or 0
  * [out]	value[3].a	socket handle
+ * [out]	value[3].b	1 if streaming is used, else 0
+ *
+ * With streaming, data sent is queued in a ring shared with normal world
+ * and only transmitted when the ring is full, on PTA_SOCKET_FLUSH or when
+ * receiving needs to wait. Data received by normal world is queued in
+ * another ring and returned without a round trip to normal world. Normal
+ * world may not support streaming, the socket is then opened without.
+ * Streaming is only available with TEE_ISOCKET_PROTOCOLID_TCP. The ring
+ * size must be a power of two between PTA_SOCKET_RING_MIN_SIZE and
+ * PTA_SOCKET_RING_MAX_SIZE.
  */
 #define PTA_SOCKET_OPEN		1
 
+#define PTA_SOCKET_RING_MIN_SIZE	1024
+#define PTA_SOCKET_RING_MAX_SIZE	(64 * 1024)
+
 /*
  * [in]		value[0].a	socket handle
  */
@@ -48,4 +62,52 @@
  */
 #define PTA_SOCKET_IOCTL	5
 
+/*
+ * Transmits the data queued on a streaming socket, does nothing on other
+ * sockets
+ *
+ * [in]		value[0].a	socket handle
+ * [in]		value[0].b	timeout ms or TEE_TIMEOUT_INFINITE
+ */
+#define PTA_SOCKET_FLUSH	6
+
+/*
+ * Sends several messages, each with one send operation, one datagram
+ * each on an UDP socket. On a TCP socket the messages are sent back to
+ * back. Sending stops at the first message that isn't completely sent.
+ * If an error occurs after at least one message is sent, TEE_SUCCESS is
+ * returned with the messages sent so far.
+ *
+ * [in]		value[0].a	socket handle
+ * [in]		value[0].b	timeout ms or TEE_TIMEOUT_INFINITE
+ * [in]		memref[1]	messages to send, back to back
+ * [inout]	memref[2]	array of uint32_t, length of each message,
+ *				on return the number of bytes sent of each
+ *				message sent
+ * [out]	value[3].a	number of messages sent, the last one may be
+ *				partly sent
+ */
+#define PTA_SOCKET_SENDMMSG	7
+
+/*
+ * Receives several messages, each with one receive operation, one
+ * datagram each on an UDP socket. The timeout only applies to the first
+ * message, the following are only received if available. If an error
+ * occurs after at least one message is received, TEE_SUCCESS is returned
+ * with the messages received so far.
+ *
+ * [in]		value[0].a	socket handle
+ * [in]		value[0].b	timeout ms or TEE_TIMEOUT_INFINITE
+ * [out]	memref[1]	buffer split in consecutive slots with the
+ *				sizes in memref[2]
+ * [inout]	memref[2]	array of uint32_t, size of each slot, on
+ *				return the number of bytes received of each
+ *				message received
+ * [out]	value[3].a	number of messages received
+ */
+#define PTA_SOCKET_RECVMMSG	8
+
+/* Maximum number of messages of PTA_SOCKET_SENDMMSG and PTA_SOCKET_RECVMMSG */
+#define PTA_SOCKET_MMSG_MAX	64
+
 #endif /*__PTA_SOCKET*/
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2020, Linaro Limited
+ */
+
+#ifndef __PTA_TRACEPOINT_H
+#define __PTA_TRACEPOINT_H
+
+#include <stdint.h>
+
+/*
+ * Interface to the tracepoint pseudo-TA, which is used to register the
+ * shared memory buffer where the TEE core records trace events.
+ */
+
+#define PTA_TRACEPOINT_UUID { 0xd03da2b1, 0x2e6e, 0x4c80, { \
+			      0x88, 0x47, 0x08, 0xc6, 0x1e, 0x4f, 0x51, 0xf9 } }
+
+/*
+ * Start recording trace events. The event buffer is allocated in normal
+ * world shared memory the first time and is kept afterwards, recording
+ * may be stopped and restarted any number of times.
+ *
+ * [in]     value[0].a: number of events per core, power of two
+ * [in]     value[0].b: mask of enabled events, BIT(TP_*)
+ * [out]    value[1].a: physical address of struct tp_global
+ * [out]    value[1].b: size of the buffer
+ */
+#define PTA_TRACEPOINT_START		0
+
+/*
+ * Stop recording trace events. The buffer content is left untouched.
+ */
+#define PTA_TRACEPOINT_STOP		1
+
+/*
+ * Return the physical address and size of the event buffer
+ *
+ * [out]    value[0].a: physical address of struct tp_global, 0 if none
+ * [out]    value[0].b: size of the buffer
+ */
+#define PTA_TRACEPOINT_GET_MEMREF	2
+
+/*
+ * Trace event IDs, with the meaning of the two event arguments
+ */
+#define TP_SMC_ENTRY		1	/* SMC function ID, message arg paddr */
+#define TP_SMC_EXIT		2	/* SMC function ID, return value */
+#define TP_RPC_OUT		3	/* RPC command, number of parameters */
+#define TP_RPC_IN		4	/* RPC command, result */
+#define TP_THREAD_ALLOC		5	/* Thread ID, SMC function ID */
+#define TP_THREAD_FREE		6	/* Thread ID */
+#define TP_PAGER_FAULT		7	/* Faulting VA, abort type */
+#define TP_MUTEX_SLEEP		8	/* Sync object VA, sleeping thread */
+#define TP_MUTEX_WAKE		9	/* Sync object VA, woken thread */
+#define TP_STORAGE_RPC		10	/* RPC command, storage operation */
+#define TP_STORAGE_RPC_DONE	11	/* RPC command, result */
+#define TP_MAX_EVENT		TP_STORAGE_RPC_DONE
+
+struct tp_event {
+	uint64_t cnt;		/* CNTPCT value */
+	uint32_t id;		/* TP_* */
+	int32_t thread;		/* Thread ID, -1 if none */
+	uint64_t arg[2];	/* Event specific */
+};
+
+/*
+ * Per-core event ring. The core owning the ring is the only writer: an
+ * event is written to ev[head % nb_events] and then @head is incremented.
+ * A reader snapshots @head, copies the events it needs and reads @head
+ * again. Events which are older than the second head value minus
+ * nb_events may have been overwritten in the meantime and must be
+ * discarded.
+ */
+struct tp_ring {
+	uint64_t head;
+	struct tp_event ev[];
+};
+
+/*
+ * Layout of the event buffer: the header is followed by @cores rings of
+ * @ring_size bytes each.
+ */
+struct tp_global {
+	uint32_t cores;
+	uint32_t nb_events;
+	uint64_t cntfrq;
+	uint64_t ring_size;
+	uint8_t rings[];
+};
+
+#endif /* __PTA_TRACEPOINT_H */
@@ -32,4 +32,47 @@ typedef const struct TEE_iSocket_s {
 			    void *buf, uint32_t *length);
 } TEE_iSocket;
 
+/*
+ * Extension: sending and receiving several messages in one operation
+ *
+ * struct TEE_iSocketMsg - a message
+ * @buf:	the data of the message
+ * @length:	the length of the message when sending or the size of @buf
+ *		when receiving, on return the number of bytes sent or
+ *		received
+ */
+typedef struct TEE_iSocketMsg_s {
+	void *buf;
+	uint32_t length;
+} TEE_iSocketMsg;
+
+/*
+ * tee_isocket_sendmmsg() - Send several messages
+ * @ctx:	socket opened with TEE_tcpSocket, TEE_tcpStreamSocket or
+ *		TEE_udpSocket
+ * @msgs:	the messages, each sent as one datagram on an UDP socket
+ * @count:	number of messages, on return the number of messages sent,
+ *		the last one may be partly sent
+ * @timeout:	timeout ms or TEE_TIMEOUT_INFINITE
+ *
+ * At most PTA_SOCKET_MMSG_MAX messages are sent per call.
+ */
+TEE_Result tee_isocket_sendmmsg(TEE_iSocketHandle ctx, TEE_iSocketMsg *msgs,
+				uint32_t *count, uint32_t timeout);
+
+/*
+ * tee_isocket_recvmmsg() - Receive several messages
+ * @ctx:	socket opened with TEE_tcpSocket, TEE_tcpStreamSocket or
+ *		TEE_udpSocket
+ * @msgs:	the messages, each receiving one datagram on an UDP socket
+ * @count:	number of messages, on return the number of messages
+ *		received
+ * @timeout:	timeout ms or TEE_TIMEOUT_INFINITE, only waiting for the
+ *		first message
+ *
+ * At most PTA_SOCKET_MMSG_MAX messages are received per call.
+ */
+TEE_Result tee_isocket_recvmmsg(TEE_iSocketHandle ctx, TEE_iSocketMsg *msgs,
+				uint32_t *count, uint32_t timeout);
+
 #endif /*__TEE_ISOCKET_H*/
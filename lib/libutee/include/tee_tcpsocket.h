@@ -18,4 +18,12 @@ typedef struct TEE_tcpSocket_Setup_s {
 
 extern TEE_iSocket *const TEE_tcpSocket;
 
+/*
+ * Extension: TCP socket with the data sent and received queued in rings
+ * shared with normal world, see PTA_SOCKET_OPEN. Sent data may remain
+ * queued until TEE_TCP_FLUSH, a receive or close. Falls back to the
+ * behaviour of TEE_tcpSocket if normal world doesn't support streaming.
+ */
+extern TEE_iSocket *const TEE_tcpStreamSocket;
+
 #endif /*__TEE_TCPSOCKET_H*/
@@ -50,6 +50,23 @@ struct __ftrace_info {
 	union compat_ptr ret_ptr;
 };
 
+/*
+ * Function trace records are stored in binary form in a ring following
+ * the text header of the ftrace buffer. They are turned into a function
+ * graph on the host by scripts/ftrace_decode.py.
+ */
+#define FTRACE_REC_ENTER		0
+#define FTRACE_REC_RETURN		1
+#define FTRACE_REC_VERSION		1
+
+struct ftrace_rec {
+	uint64_t pc;		/* Function address, 0 for FTRACE_REC_RETURN */
+	uint32_t ticks;		/* Enter: ticks since previous enter */
+				/* Return: duration in ticks */
+	uint16_t depth;		/* Call depth */
+	uint16_t type;		/* FTRACE_REC_* */
+};
+
 struct ftrace_buf {
 	uint64_t ret_func_ptr;	/* __ftrace_return pointer */
 	uint64_t ret_stack[FTRACE_RETFUNC_DEPTH]; /* Return stack */
@@ -57,10 +74,12 @@ struct ftrace_buf {
 	uint32_t lr_idx;	/* lr index used for stack unwinding */
 	uint64_t begin_time[FTRACE_RETFUNC_DEPTH]; /* Timestamp */
 	uint64_t suspend_time;	/* Suspend timestamp */
-	uint32_t curr_size;	/* Size of ftrace buffer */
-	uint32_t max_size;	/* Max allowed size of ftrace buffer */
+	uint64_t last_time;	/* Timestamp of the last enter record */
+	uint32_t curr_size;	/* Bytes of valid records in the ring */
+	uint32_t max_size;	/* Size of the record ring */
+	uint32_t wr_off;	/* Offset of the next record in the ring */
 	uint32_t head_off;	/* Ftrace buffer header offset */
-	uint32_t buf_off;	/* Ftrace buffer offset */
+	uint32_t buf_off;	/* Record ring offset */
 	bool syscall_trace_enabled; /* Some syscalls are never traced */
 	bool syscall_trace_suspended; /* By foreign interrupt or RPC */
 };
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <__tee_ipsocket.h>
+#include <tee_isocket.h>
 
 static inline uint8_t __tee_socket_ioctl_cmd_to_proto(uint32_t cmd_code)
 {
@@ -16,7 +17,8 @@ static inline uint8_t __tee_socket_ioctl_cmd_to_proto(uint32_t cmd_code)
 
 TEE_Result __tee_socket_pta_open(TEE_ipSocket_ipVersion ip_vers,
 				 const char *addr, uint16_t port,
-				 uint32_t protocol, uint32_t *handle);
+				 uint32_t protocol, uint32_t ring_size,
+				 uint32_t *handle);
 
 TEE_Result __tee_socket_pta_close(uint32_t handle);
 
@@ -29,4 +31,12 @@ TEE_Result __tee_socket_pta_recv(uint32_t handle, void *buf, uint32_t *len,
 TEE_Result __tee_socket_pta_ioctl(uint32_t handle, uint32_t command, void *buf,
 				  uint32_t *len);
 
+TEE_Result __tee_socket_pta_sendmmsg(uint32_t handle, TEE_iSocketMsg *msgs,
+				     uint32_t *count, uint32_t timeout);
+
+TEE_Result __tee_socket_pta_recvmmsg(uint32_t handle, TEE_iSocketMsg *msgs,
+				     uint32_t *count, uint32_t timeout);
+
+TEE_Result __tee_socket_pta_flush(uint32_t handle, uint32_t timeout);
+
 #endif /*__TEE_SOCKET_PRIVATE_H*/
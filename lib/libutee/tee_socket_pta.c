@@ -6,6 +6,8 @@
 #include <pta_socket.h>
 #include <string.h>
 #include <tee_internal_api.h>
+#include <tee_internal_api_extensions.h>
+#include <util.h>
 #include <__tee_tcpsocket_defines.h>
 #include <__tee_udpsocket_defines.h>
 
@@ -32,7 +34,8 @@ static TEE_Result invoke_socket_pta(uint32_t cmd_id, uint32_t param_types,
 
 TEE_Result __tee_socket_pta_open(TEE_ipSocket_ipVersion ip_vers,
 				 const char *addr, uint16_t port,
-				 uint32_t protocol, uint32_t *handle)
+				 uint32_t protocol, uint32_t ring_size,
+				 uint32_t *handle)
 {
 	TEE_Result res;
 	uint32_t param_types;
@@ -70,6 +73,8 @@ TEE_Result __tee_socket_pta_open(TEE_ipSocket_ipVersion ip_vers,
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
 
+	params[2].value.b = ring_size;
+
 	res = invoke_socket_pta(PTA_SOCKET_OPEN, param_types, params);
 	if (res == TEE_SUCCESS)
 		*handle = params[3].value.a;
@@ -160,3 +165,105 @@ TEE_Result __tee_socket_pta_ioctl(uint32_t handle, uint32_t command, void *buf,
 	*len =  params[1].memref.size;
 	return res;
 }
+
+TEE_Result __tee_socket_pta_flush(uint32_t handle, uint32_t timeout)
+{
+	uint32_t param_types;
+	TEE_Param params[TEE_NUM_PARAMS];
+
+	param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+				      TEE_PARAM_TYPE_NONE, TEE_PARAM_TYPE_NONE,
+				      TEE_PARAM_TYPE_NONE);
+	memset(params, 0, sizeof(params));
+
+	params[0].value.a = handle;
+	params[0].value.b = timeout;
+	return invoke_socket_pta(PTA_SOCKET_FLUSH, param_types, params);
+}
+
+/*
+ * Invokes PTA_SOCKET_SENDMMSG or PTA_SOCKET_RECVMMSG with the messages
+ * packed back to back in one buffer.
+ */
+static TEE_Result socket_pta_mmsg(uint32_t cmd_id, uint32_t handle,
+				  TEE_iSocketMsg *msgs, uint32_t *count,
+				  uint32_t timeout)
+{
+	uint32_t lens[PTA_SOCKET_MMSG_MAX] = { 0 };
+	bool send = cmd_id == PTA_SOCKET_SENDMMSG;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	TEE_Param params[TEE_NUM_PARAMS];
+	uint32_t param_types = 0;
+	uint8_t *buf = NULL;
+	size_t offs = 0;
+	size_t tot = 0;
+	size_t n = 0;
+
+	n = MIN(*count, (uint32_t)PTA_SOCKET_MMSG_MAX);
+	*count = 0;
+	if (!n)
+		return TEE_SUCCESS;
+
+	for (size_t i = 0; i < n; i++) {
+		lens[i] = msgs[i].length;
+		if (ADD_OVERFLOW(tot, lens[i], &tot))
+			return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	buf = TEE_Malloc(MAX(tot, 1U), TEE_USER_MEM_HINT_NO_FILL_ZERO);
+	if (!buf)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	if (send) {
+		for (size_t i = 0; i < n; i++) {
+			memcpy(buf + offs, msgs[i].buf, lens[i]);
+			offs += lens[i];
+		}
+	}
+
+	param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+				      send ? TEE_PARAM_TYPE_MEMREF_INPUT :
+					     TEE_PARAM_TYPE_MEMREF_OUTPUT,
+				      TEE_PARAM_TYPE_MEMREF_INOUT,
+				      TEE_PARAM_TYPE_VALUE_OUTPUT);
+	memset(params, 0, sizeof(params));
+
+	params[0].value.a = handle;
+	params[0].value.b = timeout;
+
+	params[1].memref.buffer = buf;
+	params[1].memref.size = tot;
+
+	params[2].memref.buffer = lens;
+	params[2].memref.size = n * sizeof(uint32_t);
+
+	res = invoke_socket_pta(cmd_id, param_types, params);
+	if (res != TEE_SUCCESS || params[3].value.a > n)
+		goto out;
+
+	offs = 0;
+	for (size_t i = 0; i < params[3].value.a; i++) {
+		if (!send)
+			memcpy(msgs[i].buf, buf + offs, lens[i]);
+		offs += msgs[i].length;
+		msgs[i].length = lens[i];
+	}
+	*count = params[3].value.a;
+out:
+	TEE_Free(buf);
+	return res;
+}
+
+TEE_Result __tee_socket_pta_sendmmsg(uint32_t handle, TEE_iSocketMsg *msgs,
+				     uint32_t *count, uint32_t timeout)
+{
+	return socket_pta_mmsg(PTA_SOCKET_SENDMMSG, handle, msgs, count,
+			       timeout);
+}
+
+TEE_Result __tee_socket_pta_recvmmsg(uint32_t handle, TEE_iSocketMsg *msgs,
+				     uint32_t *count, uint32_t timeout)
+{
+	return socket_pta_mmsg(PTA_SOCKET_RECVMMSG, handle, msgs, count,
+			       timeout);
+}
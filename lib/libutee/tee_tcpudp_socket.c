@@ -17,8 +17,8 @@ struct socket_ctx {
 	uint32_t proto_error;
 };
 
-static TEE_Result tcp_open(TEE_iSocketHandle *ctx, void *setup,
-			   uint32_t *proto_error)
+static TEE_Result tcp_open_common(TEE_iSocketHandle *ctx, void *setup,
+				  uint32_t *proto_error, uint32_t ring_size)
 {
 	TEE_Result res;
 	struct socket_ctx *sock_ctx;
@@ -36,7 +36,7 @@ static TEE_Result tcp_open(TEE_iSocketHandle *ctx, void *setup,
 	res = __tee_socket_pta_open(tcp_setup->ipVersion,
 				    tcp_setup->server_addr,
 				    tcp_setup->server_port,
-				    TEE_ISOCKET_PROTOCOLID_TCP,
+				    TEE_ISOCKET_PROTOCOLID_TCP, ring_size,
 				    &sock_ctx->handle);
 	if (res != TEE_SUCCESS) {
 		TEE_Free(sock_ctx);
@@ -56,6 +56,19 @@ static TEE_Result tcp_open(TEE_iSocketHandle *ctx, void *setup,
 	}
 }
 
+static TEE_Result tcp_open(TEE_iSocketHandle *ctx, void *setup,
+			   uint32_t *proto_error)
+{
+	return tcp_open_common(ctx, setup, proto_error, 0);
+}
+
+static TEE_Result tcp_stream_open(TEE_iSocketHandle *ctx, void *setup,
+				  uint32_t *proto_error)
+{
+	return tcp_open_common(ctx, setup, proto_error,
+			       TEE_TCP_STREAM_RING_SIZE);
+}
+
 static TEE_Result udp_open(TEE_iSocketHandle *ctx, void *setup,
 			   uint32_t *proto_error)
 {
@@ -75,7 +88,7 @@ static TEE_Result udp_open(TEE_iSocketHandle *ctx, void *setup,
 	res = __tee_socket_pta_open(udp_setup->ipVersion,
 				    udp_setup->server_addr,
 				    udp_setup->server_port,
-				    TEE_ISOCKET_PROTOCOLID_UDP,
+				    TEE_ISOCKET_PROTOCOLID_UDP, 0,
 				    &sock_ctx->handle);
 	if (res != TEE_SUCCESS) {
 		TEE_Free(sock_ctx);
@@ -149,6 +162,36 @@ static uint32_t sock_error(TEE_iSocketHandle ctx)
 	return sock_ctx->proto_error;
 }
 
+TEE_Result tee_isocket_sendmmsg(TEE_iSocketHandle ctx, TEE_iSocketMsg *msgs,
+				uint32_t *count, uint32_t timeout)
+{
+	TEE_Result res;
+	struct socket_ctx *sock_ctx = (struct socket_ctx *)ctx;
+
+	if (ctx == TEE_HANDLE_NULL || !count || (!msgs && *count))
+		TEE_Panic(0);
+
+	res = __tee_socket_pta_sendmmsg(sock_ctx->handle, msgs, count, timeout);
+	sock_ctx->proto_error = res;
+
+	return res;
+}
+
+TEE_Result tee_isocket_recvmmsg(TEE_iSocketHandle ctx, TEE_iSocketMsg *msgs,
+				uint32_t *count, uint32_t timeout)
+{
+	TEE_Result res;
+	struct socket_ctx *sock_ctx = (struct socket_ctx *)ctx;
+
+	if (ctx == TEE_HANDLE_NULL || !count || (!msgs && *count))
+		TEE_Panic(0);
+
+	res = __tee_socket_pta_recvmmsg(sock_ctx->handle, msgs, count, timeout);
+	sock_ctx->proto_error = res;
+
+	return res;
+}
+
 static TEE_Result tcp_ioctl(TEE_iSocketHandle ctx, uint32_t commandCode,
 			    void *buf, uint32_t *length)
 {
@@ -167,6 +210,12 @@ static TEE_Result tcp_ioctl(TEE_iSocketHandle ctx, uint32_t commandCode,
 		res = __tee_socket_pta_ioctl(sock_ctx->handle, commandCode,
 					     buf, length);
 		break;
+	case TEE_TCP_FLUSH:
+		if (*length != sizeof(uint32_t))
+			TEE_Panic(0);
+		res = __tee_socket_pta_flush(sock_ctx->handle,
+					     *(uint32_t *)buf);
+		break;
 	default:
 		TEE_Panic(0);
 	}
@@ -203,8 +252,6 @@ static TEE_Result udp_ioctl(TEE_iSocketHandle ctx, uint32_t commandCode,
 	return res;
 }
 
-
-
 static TEE_iSocket tcp_socket_instance = {
 	.TEE_iSocketVersion = TEE_ISOCKET_VERSION,
 	.protocolID = TEE_ISOCKET_PROTOCOLID_TCP,
@@ -216,6 +263,17 @@ static TEE_iSocket tcp_socket_instance = {
 	.ioctl = &tcp_ioctl,
 };
 
+static TEE_iSocket tcp_stream_socket_instance = {
+	.TEE_iSocketVersion = TEE_ISOCKET_VERSION,
+	.protocolID = TEE_ISOCKET_PROTOCOLID_TCP,
+	.open = &tcp_stream_open,
+	.close = &sock_close,
+	.send = &sock_send,
+	.recv = &sock_recv,
+	.error = &sock_error,
+	.ioctl = &tcp_ioctl,
+};
+
 static TEE_iSocket udp_socket_instance = {
 	.TEE_iSocketVersion = TEE_ISOCKET_VERSION,
 	.protocolID = TEE_ISOCKET_PROTOCOLID_UDP,
@@ -228,4 +286,5 @@ static TEE_iSocket udp_socket_instance = {
 };
 
 TEE_iSocket *const TEE_tcpSocket = &tcp_socket_instance;
+TEE_iSocket *const TEE_tcpStreamSocket = &tcp_stream_socket_instance;
 TEE_iSocket *const TEE_udpSocket = &udp_socket_instance;
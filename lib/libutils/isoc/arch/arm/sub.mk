@@ -20,6 +20,17 @@ endif
 srcs-$(CFG_ARM32_$(sm)) += setjmp_a32.S
 srcs-$(CFG_ARM64_$(sm)) += setjmp_a64.S
 
+ifeq ($(CFG_ARM_STRING_ASM),y)
+srcs-$(CFG_ARM32_$(sm)) += memcmp_a32.S
+srcs-$(CFG_ARM32_$(sm)) += memcpy_a32.S
+srcs-$(CFG_ARM32_$(sm)) += memset_a32.S
+srcs-$(CFG_ARM32_$(sm)) += strlen_a32.S
+srcs-$(CFG_ARM64_$(sm)) += memcmp_a64.S
+srcs-$(CFG_ARM64_$(sm)) += memcpy_a64.S
+srcs-$(CFG_ARM64_$(sm)) += memset_a64.S
+srcs-$(CFG_ARM64_$(sm)) += strlen_a64.S
+endif
+
 ifeq ($(CFG_TA_FLOAT_SUPPORT),y)
 # Floating point is only supported for user TAs
 ifneq ($(sm),core)
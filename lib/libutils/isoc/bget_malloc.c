@@ -78,6 +78,7 @@
 #endif
 
 #include <compiler.h>
+#include <inttypes.h>
 #include <malloc.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -152,6 +153,9 @@ struct malloc_ctx {
 #ifdef BufStats
 	struct malloc_stats mstats;
 #endif
+#ifdef ENABLE_MDBG
+	struct mdbg_site_stats mdbg_sites[MDBG_MAX_SITES];
+#endif
 #ifdef __KERNEL__
 	unsigned int spinlock;
 #endif
@@ -505,6 +509,62 @@ static void mdbg_update_hdr(struct mdbg_hdr *hdr, const char *fname,
 	*footer = MDBG_FOOTER_MAGIC;
 }
 
+/*
+ * Returns the statistics of the allocation site of @hdr, a new entry is
+ * used if @add is true and the site isn't accounted yet. Sites are never
+ * removed, allocations from new sites aren't accounted once all entries
+ * are used.
+ */
+static struct mdbg_site_stats *mdbg_get_site(struct malloc_ctx *ctx,
+					     struct mdbg_hdr *hdr, bool add)
+{
+	size_t h = ((vaddr_t)hdr->fname ^ hdr->line) * 0x9e3779b1;
+	struct mdbg_site_stats *s = NULL;
+	size_t n = 0;
+
+	if (!hdr->fname)
+		return NULL;
+
+	for (n = 0; n < MDBG_MAX_SITES; n++) {
+		s = ctx->mdbg_sites + (h + n) % MDBG_MAX_SITES;
+		if (s->fname == hdr->fname && s->line == hdr->line)
+			return s;
+		if (!s->fname) {
+			if (!add)
+				return NULL;
+			s->fname = hdr->fname;
+			s->line = hdr->line;
+			return s;
+		}
+	}
+
+	return NULL;
+}
+
+static void mdbg_account_alloc(struct malloc_ctx *ctx, struct mdbg_hdr *hdr)
+{
+	struct mdbg_site_stats *s = mdbg_get_site(ctx, hdr, true);
+
+	if (s) {
+		s->live_count++;
+		s->live_bytes += hdr->pl_size;
+		s->peak_bytes = MAX(s->peak_bytes, s->live_bytes);
+		s->num_alloc++;
+		s->alloc_bytes += hdr->pl_size;
+	}
+}
+
+static void mdbg_account_free(struct malloc_ctx *ctx, struct mdbg_hdr *hdr)
+{
+	struct mdbg_site_stats *s = mdbg_get_site(ctx, hdr, false);
+
+	if (s) {
+		s->live_count--;
+		s->live_bytes -= hdr->pl_size;
+		s->num_free++;
+	}
+}
+
 static void *gen_mdbg_malloc(struct malloc_ctx *ctx, const char *fname,
 			     int lineno, size_t size)
 {
@@ -524,6 +584,7 @@ static void *gen_mdbg_malloc(struct malloc_ctx *ctx, const char *fname,
 			 mdbg_get_ftr_size(size), size, ctx);
 	if (hdr) {
 		mdbg_update_hdr(hdr, fname, lineno, size);
+		mdbg_account_alloc(ctx, hdr);
 		hdr++;
 	}
 
@@ -544,6 +605,7 @@ static void gen_mdbg_free(struct malloc_ctx *ctx, void *ptr, bool wipe)
 	if (hdr) {
 		hdr--;
 		assert_header(hdr);
+		mdbg_account_free(ctx, hdr);
 		hdr->magic = 0;
 		*mdbg_get_footer(hdr) = 0;
 		raw_free(hdr, ctx, wipe);
@@ -569,6 +631,7 @@ static void *gen_mdbg_calloc(struct malloc_ctx *ctx, const char *fname, int line
 			  ctx);
 	if (hdr) {
 		mdbg_update_hdr(hdr, fname, lineno, nmemb * size);
+		mdbg_account_alloc(ctx, hdr);
 		hdr++;
 	}
 	malloc_unlock(ctx, exceptions);
@@ -579,15 +642,21 @@ static void *gen_mdbg_realloc_unlocked(struct malloc_ctx *ctx, const char *fname
 				       int lineno, void *ptr, size_t size)
 {
 	struct mdbg_hdr *hdr = ptr;
+	struct mdbg_hdr old_hdr = { };
 
 	if (hdr) {
 		hdr--;
 		assert_header(hdr);
+		old_hdr = *hdr;
 	}
 	hdr = raw_realloc(hdr, sizeof(struct mdbg_hdr),
 			   mdbg_get_ftr_size(size), size, ctx);
 	if (hdr) {
+		/* The old buffer is only released if the realloc succeeds */
+		if (ptr)
+			mdbg_account_free(ctx, &old_hdr);
 		mdbg_update_hdr(hdr, fname, lineno, size);
+		mdbg_account_alloc(ctx, hdr);
 		hdr++;
 	}
 	return hdr;
@@ -643,6 +712,77 @@ static void gen_mdbg_check(struct malloc_ctx *ctx, int bufdump)
 	malloc_unlock(ctx, exceptions);
 }
 
+static uint64_t mdbg_site_key(const struct mdbg_site_stats *s, int order)
+{
+	if (order == MDBG_ORDER_ALLOC_BYTES)
+		return s->alloc_bytes;
+	return s->live_bytes;
+}
+
+/*
+ * Copies the site with the largest key according to @order among those
+ * not marked in @taken into @stats and marks it. The copy is made with
+ * the lock held, the caller's buffer is accessed without it.
+ */
+static bool mdbg_select_site(struct malloc_ctx *ctx, uint8_t *taken,
+			     int order, struct mdbg_site_stats *stats)
+{
+	uint32_t exceptions = malloc_lock(ctx);
+	struct mdbg_site_stats *s = ctx->mdbg_sites;
+	size_t idx = MDBG_MAX_SITES;
+	size_t n = 0;
+
+	for (n = 0; n < MDBG_MAX_SITES; n++) {
+		if (!s[n].fname || (taken[n / 8] & BIT(n % 8)))
+			continue;
+		if (!s[n].live_count && !s[n].num_alloc)
+			continue;
+		if (idx == MDBG_MAX_SITES ||
+		    mdbg_site_key(s + n, order) > mdbg_site_key(s + idx, order))
+			idx = n;
+	}
+	if (idx != MDBG_MAX_SITES) {
+		memcpy_unchecked(stats, s + idx, sizeof(*stats));
+		taken[idx / 8] |= BIT(idx % 8);
+	}
+
+	malloc_unlock(ctx, exceptions);
+
+	return idx != MDBG_MAX_SITES;
+}
+
+static size_t gen_mdbg_get_site_stats(struct malloc_ctx *ctx,
+				      struct mdbg_site_stats *stats,
+				      size_t count, int order, bool reset)
+{
+	uint8_t taken[MDBG_MAX_SITES / 8] = { };
+	struct mdbg_site_stats *site = NULL;
+	struct mdbg_site_stats s = { };
+	uint32_t exceptions = 0;
+	size_t n = 0;
+	size_t m = 0;
+
+	for (n = 0; n < count; n++) {
+		if (!mdbg_select_site(ctx, taken, order, &s))
+			break;
+		stats[n] = s;
+	}
+
+	if (reset) {
+		exceptions = malloc_lock(ctx);
+		for (m = 0; m < MDBG_MAX_SITES; m++) {
+			site = ctx->mdbg_sites + m;
+			site->peak_bytes = site->live_bytes;
+			site->num_alloc = 0;
+			site->num_free = 0;
+			site->alloc_bytes = 0;
+		}
+		malloc_unlock(ctx, exceptions);
+	}
+
+	return n;
+}
+
 void *mdbg_malloc(const char *fname, int lineno, size_t size)
 {
 	return gen_mdbg_malloc(&malloc_ctx, fname, lineno, size);
@@ -662,6 +802,30 @@ void mdbg_check(int bufdump)
 {
 	gen_mdbg_check(&malloc_ctx, bufdump);
 }
+
+size_t mdbg_get_site_stats(struct mdbg_site_stats *stats, size_t count,
+			   int order, bool reset)
+{
+	return gen_mdbg_get_site_stats(&malloc_ctx, stats, count, order,
+				       reset);
+}
+
+void mdbg_dump_sites(size_t count)
+{
+	uint8_t taken[MDBG_MAX_SITES / 8] = { };
+	struct mdbg_site_stats s = { };
+	size_t n = 0;
+
+	for (n = 0; n < count; n++) {
+		if (!mdbg_select_site(&malloc_ctx, taken, MDBG_ORDER_LIVE_BYTES,
+				      &s))
+			break;
+		IMSG("site: %zu bytes in %"PRIu32" buffers (peak %zu, %"PRIu32
+		     " allocs %"PRIu64" bytes) %s:%"PRIu32,
+		     s.live_bytes, s.live_count, s.peak_bytes, s.num_alloc,
+		     s.alloc_bytes, s.fname, s.line);
+	}
+}
 #else
 
 void *malloc(size_t size)
@@ -910,6 +1074,13 @@ void nex_mdbg_check(int bufdump)
 	gen_mdbg_check(&nex_malloc_ctx, bufdump);
 }
 
+size_t nex_mdbg_get_site_stats(struct mdbg_site_stats *stats, size_t count,
+			       int order, bool reset)
+{
+	return gen_mdbg_get_site_stats(&nex_malloc_ctx, stats, count, order,
+				       reset);
+}
+
 void nex_free(void *ptr)
 {
 	uint32_t exceptions = malloc_lock(&nex_malloc_ctx);
@@ -5,6 +5,7 @@
 #ifndef MALLOC_H
 #define MALLOC_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <types_ext.h>
 
@@ -12,12 +13,53 @@ void free(void *ptr);
 
 #ifdef ENABLE_MDBG
 
+/* Number of allocation sites accounted by each heap */
+#define MDBG_MAX_SITES		256
+
+#define MDBG_ORDER_LIVE_BYTES	0	/* Bytes currently allocated */
+#define MDBG_ORDER_ALLOC_BYTES	1	/* Bytes allocated since reset (churn) */
+
+/*
+ * struct mdbg_site_stats - allocations made at one file and line
+ * @fname:		file of the allocation site
+ * @line:		line of the allocation site
+ * @live_count:		number of buffers currently allocated
+ * @live_bytes:		bytes currently allocated
+ * @peak_bytes:		highest value of @live_bytes since reset
+ * @num_alloc:		number of allocations since reset
+ * @num_free:		number of frees since reset
+ * @alloc_bytes:	bytes allocated since reset
+ *
+ * A realloc() is accounted as a free and an allocation.
+ */
+struct mdbg_site_stats {
+	const char *fname;
+	uint32_t line;
+	uint32_t live_count;
+	size_t live_bytes;
+	size_t peak_bytes;
+	uint32_t num_alloc;
+	uint32_t num_free;
+	uint64_t alloc_bytes;
+};
+
 void *mdbg_malloc(const char *fname, int lineno, size_t size);
 void *mdbg_calloc(const char *fname, int lineno, size_t nmemb, size_t size);
 void *mdbg_realloc(const char *fname, int lineno, void *ptr, size_t size);
 
 void mdbg_check(int bufdump);
 
+/*
+ * Copies the statistics of up to @count allocation sites into @stats,
+ * largest first according to @order (MDBG_ORDER_*). Returns the number
+ * of elements copied. If @reset is true, the counters accumulated since
+ * the last reset are cleared.
+ */
+size_t mdbg_get_site_stats(struct mdbg_site_stats *stats, size_t count,
+			   int order, bool reset);
+/* Prints the @count allocation sites with the most bytes allocated */
+void mdbg_dump_sites(size_t count);
+
 #define malloc(size)	mdbg_malloc(__FILE__, __LINE__, (size))
 #define calloc(nmemb, size) \
 		mdbg_calloc(__FILE__, __LINE__, (nmemb), (size))
@@ -31,6 +73,7 @@ void *calloc(size_t nmemb, size_t size);
 void *realloc(void *ptr, size_t size);
 
 #define mdbg_check(x)        do { } while (0)
+#define mdbg_dump_sites(x)   do { } while (0)
 
 #endif
 
@@ -88,6 +131,8 @@ void *nex_mdbg_calloc(const char *fname, int lineno, size_t nmemb, size_t size);
 void *nex_mdbg_realloc(const char *fname, int lineno, void *ptr, size_t size);
 
 void nex_mdbg_check(int bufdump);
+size_t nex_mdbg_get_site_stats(struct mdbg_site_stats *stats, size_t count,
+			       int order, bool reset);
 
 #define nex_malloc(size)	nex_mdbg_malloc(__FILE__, __LINE__, (size))
 #define nex_calloc(nmemb, size) \
@@ -5,17 +5,33 @@ cflags-remove-y += -Wcast-align
 srcs-y += abs.c
 srcs-y += bcmp.c
 srcs-y += memchr.c
-srcs-y += memcmp.c
-srcs-y += memcpy.c
-srcs-y += memmove.c
-srcs-y += memset.c
 srcs-y += strchr.c
 srcs-y += strcmp.c
 srcs-y += strcpy.c
-srcs-y += strlen.c
 srcs-y += strncmp.c
 srcs-y += strncpy.c
 srcs-y += strnlen.c
 srcs-y += strrchr.c
 srcs-y += strstr.c
 srcs-y += strtoul.c
+
+# The assembly versions in arch/arm are used instead
+ifneq ($(CFG_ARM_STRING_ASM),y)
+srcs-y += memcmp.c
+srcs-y += memcpy.c
+srcs-y += memmove.c
+srcs-y += memset.c
+srcs-y += strlen.c
+else ifeq ($(sm)-$(CFG_TEE_CORE_EMBED_INTERNAL_TESTS),core-y)
+# Renamed to be compared with the assembly versions by the core string tests
+srcs-y += memcmp.c
+cflags-memcmp.c-y += -Dmemcmp=newlib_memcmp
+srcs-y += memcpy.c
+cflags-memcpy.c-y += -Dmemcpy=newlib_memcpy
+srcs-y += memmove.c
+cflags-memmove.c-y += -Dmemmove=newlib_memmove
+srcs-y += memset.c
+cflags-memset.c-y += -Dmemset=newlib_memset
+srcs-y += strlen.c
+cflags-strlen.c-y += -Dstrlen=newlib_strlen
+endif
@@ -65,7 +65,11 @@ CFG_TEE_CORE_TA_TRACE ?= y
 # If y, enable the memory leak detection feature in the bget memory allocator.
 # When this feature is enabled, calling mdbg_check(1) will print a list of all
 # the currently allocated buffers and the location of the allocation (file and
-# line number).
+# line number). The allocations are also accounted per site (live bytes,
+# number of allocations and bytes allocated over time): mdbg_dump_sites()
+# prints the largest sites and mdbg_get_site_stats() returns them. For the
+# TEE core heap, they are also reported by the stats pseudo TA
+# (CFG_WITH_STATS).
 # Note: make sure the log level is high enough for the messages to show up on
 # the secure console! For instance:
 # - To debug user-mode (TA) allocations: build OP-TEE *and* the TA with:
@@ -151,6 +155,13 @@ CFG_RPMB_FS_DEV_ID ?= 0
 # - RPMB key provisioning in a controlled environment (factory setup)
 CFG_RPMB_WRITE_KEY ?= n
 
+# Number of persistent objects for which the core keeps the deserialized
+# key attributes after they have been opened, so that opening them again
+# skips reading and parsing the object header and attributes. The cached
+# keys use core heap, bignums being allocated for CFG_CORE_BIGNUM_MAX_BITS.
+# 0 disables the cache.
+CFG_PERSISTENT_KEY_CACHE_SIZE ?= 2
+
 # Embed public part of this key in OP-TEE OS
 TA_SIGN_KEY ?= keys/default_ta.pem
 
@@ -283,6 +294,17 @@ CFG_WITH_PAGER ?= n
 # Expect a significant performance impact when enabling this.
 CFG_LOCKDEP ?= n
 
+# Lock contention profiler: accounts per lock and call site the number of
+# acquisitions and contended acquisitions, the time spent waiting for the
+# lock (spinning or sleeping in normal world) and the time the lock was
+# held. Mutexes and the pager lock are fully accounted, other spinlocks
+# only when contended. The call sites which waited the longest are
+# reported by the stats pseudo TA (CFG_WITH_STATS).
+CFG_LOCK_PROF ?= n
+ifeq ($(CFG_LOCK_PROF),y)
+$(call force,CFG_MUTEX_DEBUG,y)
+endif
+
 # BestFit algorithm in bget reduces the fragmentation of the heap when running
 # with the pager enabled or lockdep
 CFG_CORE_BGET_BESTFIT ?= $(call cfg-one-enabled, CFG_WITH_PAGER CFG_LOCKDEP)
@@ -338,6 +360,11 @@ CFG_EXTERNAL_DTB_OVERLAY ?= n
 # Enable core self tests and related pseudo TAs
 CFG_TEE_CORE_EMBED_INTERNAL_TESTS ?= y
 
+# Enable the micro-benchmark pseudo TA (lib/libutee/include/pta_microbench.h)
+# which measures the cost of core primitives: crypto, heap and tee_mm
+# allocations, synchronization, RPC, pager faults and secure storage.
+CFG_MICROBENCH_PTA ?= n
+
 # This option enables OP-TEE to respond to SMP boot request: the Rich OS
 # issues this to request OP-TEE to release secondaries cores out of reset,
 # with specific core number and non-secure entry address.
@@ -365,16 +392,12 @@ CFG_TA_GPROF_SUPPORT ?= n
 # TA function tracing.
 # When this option is enabled, OP-TEE can execute Trusted Applications
 # instrumented with GCC's -pg flag and will output function tracing
-# information in ftrace.out format to /tmp/ftrace-<ta_uuid>.out (path is
-# defined in tee-supplicant)
+# information to /tmp/ftrace-<ta_uuid>.out (path is defined in tee-supplicant).
+# Trace records are kept in binary form in a ring buffer (the oldest records
+# are overwritten when the buffer is full) and must be decoded on the host
+# with scripts/ftrace_decode.py.
 CFG_FTRACE_SUPPORT ?= n
 
-# Function tracing: unit to be used when displaying durations
-#  0: always display durations in microseconds
-# >0: if duration is greater or equal to the specified value (in microseconds),
-#     display it in milliseconds
-CFG_FTRACE_US_MS ?= 10000
-
 # Core syscall function tracing.
 # When this option is enabled, OP-TEE core is instrumented with GCC's
 # -pg flag and will output syscall function graph in user TA ftrace
@@ -382,6 +405,13 @@ CFG_FTRACE_US_MS ?= 10000
 CFG_SYSCALL_FTRACE ?= n
 $(call cfg-depends-all,CFG_SYSCALL_FTRACE,CFG_FTRACE_SUPPORT)
 
+# User TA syscall profiling.
+# When this option is enabled, the number of calls and the total and maximum
+# latency of each syscall are recorded per session. The profile is sent to
+# normal world with the ftrace dump RPC (OPTEE_RPC_CMD_FTRACE) when the
+# session is closed, tee-supplicant stores it next to the ftrace dumps.
+CFG_TA_SYSCALL_PROF ?= n
+
 # Enable to compile user TA libraries with profiling (-pg).
 # Depends on CFG_TA_GPROF_SUPPORT or CFG_FTRACE_SUPPORT.
 CFG_ULIBS_MCOUNT ?= n
@@ -394,6 +424,36 @@ $(error Cannot instrument user libraries if user mode profiling is disabled)
 endif
 endif
 
+# Static tracepoints in the TEE core.
+# When enabled, events such as SMC entry/exit, RPCs, thread allocation,
+# pager faults, mutex sleep/wake and storage RPCs can be recorded in per-core
+# rings in a normal world shared memory buffer. Recording is started and
+# stopped through the tracepoint pseudo TA (lib/libutee/include/
+# pta_tracepoint.h), and costs a single test of a global mask per tracepoint
+# when stopped.
+CFG_CORE_TRACEPOINTS ?= n
+
+# PMU sampling profiler for the secure world.
+# When enabled, a Performance Monitors counter is programmed to count CPU
+# cycles, cache misses or branch misses in secure EL1/EL0, and the TEE core
+# PC and call stack (or the TA PC) is sampled when the counter overflows.
+# Sampling is controlled through the PMU profiler pseudo TA
+# (lib/libutee/include/pta_pmu_prof.h), samples are decoded on the host with
+# scripts/pmu_prof_decode.py. CFG_CORE_PMU_PROF_IT is the PMU interrupt, it
+# must be configured as a secure interrupt on each core by the platform. The
+# EL3 firmware must allow the PMU to count in the secure world (MDCR_EL3.SPME)
+# and the normal world must not use the PMU while profiling.
+CFG_CORE_PMU_PROF ?= n
+CFG_CORE_PMU_PROF_IT ?= 23
+ifeq ($(CFG_CORE_PMU_PROF),y)
+ifneq ($(CFG_ARM64_core),y)
+$(error CFG_CORE_PMU_PROF requires CFG_ARM64_core=y)
+endif
+ifeq ($(CFG_WITH_PAGER),y)
+$(error CFG_CORE_PMU_PROF and CFG_WITH_PAGER are currently incompatible)
+endif
+endif
+
 # Build libutee, libutils, libmpa/libmbedtls as shared libraries.
 # - Static libraries are still generated when this is enabled, but TAs will use
 # the shared libraries unless explicitly linked with the -static flag.
@@ -450,6 +510,21 @@ CFG_CORE_THREAD_SHIFT ?= 0
 # non-secure memory).
 CFG_CORE_DYN_SHM ?= y
 
+# Enable support for OPTEE_MSG_CMD_INVOKE_BATCH, invoking several commands
+# of Trusted Applications with a single call from normal world.
+CFG_CORE_INVOKE_BATCH ?= y
+
+# Enable support for OPTEE_SMC_CALL_PTA_FAST, letting normal world invoke
+# value-only commands of stateless pseudo TAs, such as the heap usage of the
+# stats pseudo TA, with a fast call instead of a thread. Not supported with
+# the pager since pseudo TAs are paged, nor with virtualization since fast
+# calls don't run in the context of a guest.
+ifeq ($(filter y,$(CFG_WITH_PAGER) $(CFG_VIRTUALIZATION)),)
+CFG_PTA_FAST_INVOKE ?= y
+else
+CFG_PTA_FAST_INVOKE ?= n
+endif
+
 # Enable support for reserved shared memory (shared memory in a carved out
 # memory area).
 CFG_CORE_RESERVED_SHM ?= y
@@ -508,9 +583,34 @@ $(call force,CFG_CORE_RWDATA_NOEXEC,y)
 CFG_VIRT_GUEST_COUNT ?= 2
 endif
 
+# Asynchronous notifications: wait queue wake-ups are signalled to normal
+# world with an interrupt, CFG_CORE_ASYNC_NOTIF_GIC_INTID, instead of an
+# RPC once normal world has enabled them with OPTEE_SMC_ENABLE_ASYNC_NOTIF.
+# The interrupt is either a non-secure SGI (0-7) raised on the current CPU
+# or a peripheral interrupt configured as non-secure.
+CFG_CORE_ASYNC_NOTIF ?= n
+ifeq ($(CFG_CORE_ASYNC_NOTIF),y)
+ifeq ($(CFG_CORE_ASYNC_NOTIF_GIC_INTID),)
+$(error CFG_CORE_ASYNC_NOTIF requires CFG_CORE_ASYNC_NOTIF_GIC_INTID)
+endif
+ifeq ($(CFG_VIRTUALIZATION),y)
+$(error CFG_CORE_ASYNC_NOTIF and CFG_VIRTUALIZATION are currently incompatible)
+endif
+endif
+
 # Enables backwards compatible derivation of RPMB and SSK keys
 CFG_CORE_HUK_SUBKEY_COMPAT ?= y
 
 # Compress and encode conf.mk into the TEE core, and show the encoded string on
 # boot (with severity TRACE_INFO).
 CFG_SHOW_CONF_ON_BOOT ?= n
+
+# Boot time profiler: records how long each initcall and the major boot
+# phases (MMU and heap setup, pager, thread and DT initialization, TEE
+# runtime) take, based on the system counter. The RPMB file system setup
+# done on first use is recorded too. The results are reported by the stats
+# pseudo TA (CFG_WITH_STATS) and printed at the end of the boot with
+# CFG_BOOT_PROF_PRINT=y. scripts/boot_prof_check.py compares them with a
+# reference.
+CFG_BOOT_PROF ?= n
+CFG_BOOT_PROF_PRINT ?= n
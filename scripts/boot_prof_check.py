@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Copyright (c) 2020, Linaro Limited
+#
+
+import argparse
+import collections
+import re
+import struct
+import sys
+
+# struct boot_prof_entry in core/include/kernel/boot_prof.h
+BOOT_PROF_ENTRY_FMT = '<32sIIQQ'
+BOOT_PROF_PHASE = 0
+
+# Lines printed with CFG_BOOT_PROF_PRINT=y, for instance:
+# I/TC: boot:      81234 us      512 us mmu
+# I/TC: boot:      95120 us      230 us   initcall1 early_ta_init
+LOG_RE = re.compile(r'boot:\s+(?P<begin>\d+) us\s+(?P<duration>\d+) us\s+'
+                    r'(initcall(?P<level>\d+) )?(?P<name>\S.*?)\s*$')
+
+epilog = '''
+This script compares the boot time profile of the TEE core (built with
+CFG_BOOT_PROF=y) with a reference profile and reports the boot phases and
+initcalls which got slower than the allowed thresholds. A step has
+regressed if it is slower than the reference by more than both the
+relative and the absolute threshold. The exit status is 1 if any step
+regressed or if the total boot time is over budget.
+
+A profile is either a secure console log with CFG_BOOT_PROF_PRINT=y or a
+binary dump of the buffer returned by the STATS_CMD_BOOT_PROF command of
+the stats pseudo TA.
+
+Sample usage:
+
+  $ scripts/boot_prof_check.py --ref boot-ref.log boot.log
+  $ scripts/boot_prof_check.py --ref boot-ref.log --max-increase-pct 5 \\
+        --total-budget-us 150000 boot.log
+'''
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        description='Checks the TEE core boot time for regressions',
+        epilog=epilog)
+    parser.add_argument('file', help='Boot profile to check')
+    parser.add_argument('--ref', help='Reference boot profile')
+    parser.add_argument('--max-increase-pct', type=float, default=10,
+                        help='Allowed relative increase of each step '
+                        '(default: %(default)s)')
+    parser.add_argument('--max-increase-us', type=int, default=500,
+                        help='Allowed absolute increase of each step in '
+                        'microseconds (default: %(default)s)')
+    parser.add_argument('--total-budget-us', type=int,
+                        help='Maximum time in microseconds from the start '
+                        'of the first step to the end of the boot')
+
+    return parser.parse_args()
+
+
+def parse_log(text):
+    steps = []
+
+    for line in text.splitlines():
+        m = LOG_RE.search(line)
+        if not m:
+            continue
+        level = int(m.group('level') or BOOT_PROF_PHASE)
+        steps.append((m.group('name'), level, int(m.group('begin')),
+                      int(m.group('duration'))))
+
+    return steps
+
+
+def parse_dump(data):
+    steps = []
+    size = struct.calcsize(BOOT_PROF_ENTRY_FMT)
+
+    for pos in range(0, len(data) - size + 1, size):
+        (name, level, _, begin,
+         duration) = struct.unpack_from(BOOT_PROF_ENTRY_FMT, data, pos)
+        name = name.split(b'\0', 1)[0].decode('utf-8', 'replace')
+        steps.append((name, level, begin, duration))
+
+    return steps
+
+
+def load(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    try:
+        steps = parse_log(data.decode('utf-8'))
+    except UnicodeDecodeError:
+        steps = []
+    if not steps:
+        steps = parse_dump(data)
+    if not steps:
+        sys.exit('{}: no boot profile found'.format(path))
+
+    return steps
+
+
+def step_name(key):
+    name, level = key
+    if level == BOOT_PROF_PHASE:
+        return name
+    return 'initcall{} {}'.format(level, name)
+
+
+def durations(steps):
+    # Steps may be recorded more than once, their durations are added
+    d = collections.OrderedDict()
+
+    for name, level, _, duration in steps:
+        d[(name, level)] = d.get((name, level), 0) + duration
+
+    return d
+
+
+def boot_time(steps):
+    # Steps done on first use after boot, such as the RPMB setup, are
+    # recorded after 'tee runtime' which ends the boot.
+    first = min(s[2] for s in steps)
+    ends = [s[2] + s[3] for s in steps
+            if s[0] == 'tee runtime' and s[1] == BOOT_PROF_PHASE]
+    if not ends:
+        ends = [s[2] + s[3] for s in steps]
+
+    return max(ends) - first
+
+
+def main():
+    args = get_args()
+    steps = load(args.file)
+    cur = durations(steps)
+    failed = False
+
+    total = boot_time(steps)
+    print('Boot time: {} us'.format(total))
+    if args.total_budget_us is not None and total > args.total_budget_us:
+        print('FAIL: boot time over budget of {} us'.format(
+              args.total_budget_us))
+        failed = True
+
+    if args.ref:
+        ref = durations(load(args.ref))
+        print('{:<40} {:>10} {:>10} {:>8}'.format('step', 'ref us', 'us',
+                                                  'delta'))
+        for key, us in cur.items():
+            name = step_name(key)
+            if key not in ref:
+                print('{:<40} {:>10} {:>10} {:>8}'.format(name, '-', us,
+                                                          'new'))
+                continue
+            ref_us = ref[key]
+            delta = us - ref_us
+            pct = delta * 100.0 / ref_us if ref_us else 0
+            mark = ''
+            if (delta > args.max_increase_us and
+                    (not ref_us or pct > args.max_increase_pct)):
+                mark = ' FAIL'
+                failed = True
+            print('{:<40} {:>10} {:>10} {:>+7.1f}%{}'.format(
+                  name, ref_us, us, pct, mark))
+        for key in ref:
+            if key not in cur:
+                print('{:<40} {:>10} {:>10} {:>8}'.format(step_name(key),
+                                                          ref[key], '-',
+                                                          'gone'))
+    else:
+        for key, us in cur.items():
+            print('{:<40} {:>10}'.format(step_name(key), us))
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Copyright (c) 2020, Linaro Limited
+#
+
+import argparse
+import re
+import struct
+import sys
+
+FUNC_GRAPH_RE = re.compile(rb'Function graph')
+REC_HDR_RE = re.compile(rb'Ftrace records: version (?P<version>[0-9]+) '
+                        rb'size (?P<size>[0-9]+) cntfrq (?P<cntfrq>[0-9]+)')
+
+# struct ftrace_rec in lib/libutee/include/user_ta_header.h
+FTRACE_REC_FMT = '<QIHH'
+FTRACE_REC_ENTER = 0
+FTRACE_REC_RETURN = 1
+FTRACE_REC_VERSION = 1
+
+# Width of the duration column, including the trailing '| '
+DURATION_MAX_LEN = 16
+
+epilog = '''
+This script converts the binary function trace produced by an OP-TEE user TA
+built with CFG_FTRACE_SUPPORT=y (saved by tee-supplicant to
+/tmp/ftrace-<ta_uuid>.out) into a text function graph. The text which
+precedes the trace (TEE load address, memory mappings) is copied unchanged so
+that the output can be fed to symbolize.py.
+
+Sample usage:
+
+  $ scripts/ftrace_decode.py /tmp/ftrace-<ta_uuid>.out | \\
+        scripts/symbolize.py -d <ta_uuid>.elf -d out/arm-plat-vexpress/core
+'''
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        description='Decodes OP-TEE binary function traces',
+        epilog=epilog)
+    parser.add_argument('file', nargs='?',
+                        help='Trace file (default: standard input)')
+    parser.add_argument('-m', '--us-ms', type=int, default=10000,
+                        help='Display durations greater or equal to US_MS '
+                        'microseconds in milliseconds, 0 to always use '
+                        'microseconds (default: %(default)s)')
+
+    return parser.parse_args()
+
+
+class FtraceDecoder(object):
+    def __init__(self, out, us_ms):
+        self._out = out
+        self._us_ms = us_ms
+
+    def duration(self, ticks, cntfrq):
+        if ticks == 0xffffffff:
+            return '-' * 10
+        us = ticks * 1000000 / cntfrq
+        if self._us_ms and us >= self._us_ms:
+            return '{:.3f} ms'.format(us / 1000)
+        return '{:.3f} us'.format(us)
+
+    def line(self, depth, text, dur=''):
+        self._out.write('{:>{w}} | {}{}\n'.format(dur, ' ' * depth, text,
+                                                  w=DURATION_MAX_LEN - 3))
+
+    def decode_records(self, data, cntfrq, size):
+        recs = [struct.unpack_from(FTRACE_REC_FMT, data, offs)
+                for offs in range(0, len(data) - size + 1, size)]
+        i = 0
+        while i < len(recs):
+            pc, ticks, depth, rtype = recs[i]
+            if rtype == FTRACE_REC_ENTER:
+                func = '0x{:08x}()'.format(pc)
+                if (i + 1 < len(recs) and
+                        recs[i + 1][3] == FTRACE_REC_RETURN and
+                        recs[i + 1][2] == depth):
+                    # Leaf function
+                    self.line(depth, func + ';',
+                              self.duration(recs[i + 1][1], cntfrq))
+                    i += 1
+                else:
+                    self.line(depth, func + ' {')
+            elif rtype == FTRACE_REC_RETURN:
+                self.line(depth, '}', self.duration(ticks, cntfrq))
+            i += 1
+
+    def decode(self, data):
+        pos = 0
+        while pos < len(data):
+            end = data.find(b'\n', pos)
+            if end < 0:
+                end = len(data) - 1
+            line = data[pos:end + 1]
+            pos = end + 1
+            self._out.write(line.decode('latin-1'))
+            if not re.search(FUNC_GRAPH_RE, line):
+                continue
+            end = data.find(b'\n', pos)
+            match = re.search(REC_HDR_RE, data[pos:end])
+            if end < 0 or not match:
+                continue
+            if int(match.group('version')) != FTRACE_REC_VERSION:
+                print('*** Error: unsupported ftrace record version',
+                      file=sys.stderr)
+                sys.exit(1)
+            # The binary records run to the end of the dump
+            self.decode_records(data[end + 1:], int(match.group('cntfrq')),
+                                int(match.group('size')))
+            return
+
+
+def main():
+    args = get_args()
+
+    if args.file:
+        with open(args.file, 'rb') as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    FtraceDecoder(sys.stdout, args.us_ms).decode(data)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Copyright (c) 2020, Linaro Limited
+#
+
+import argparse
+import collections
+import struct
+import sys
+
+# struct pmu_prof_header and struct pmu_prof_sample in
+# lib/libutee/include/pta_pmu_prof.h
+PMU_PROF_HDR_FMT = '<IIIIQQ'
+PMU_PROF_MAX_DEPTH = 15
+PMU_PROF_SAMPLE_FMT = '<BBHI{}Q'.format(PMU_PROF_MAX_DEPTH)
+PMU_PROF_SAMPLE_USER = 1 << 0
+PMU_PROF_VERSION = 1
+
+EVENTS = ['cycles', 'cache-misses', 'branch-misses']
+
+epilog = '''
+This script converts the samples returned by the PMU profiler pseudo TA
+(PTA_PMU_PROF_GET_SAMPLES, built with CFG_CORE_PMU_PROF=y) into one line per
+distinct call stack. Several dumps may be concatenated in the input file.
+symbolize.py turns these lines into the folded stack format expected by
+flame graph tools.
+
+Sample usage:
+
+  $ scripts/pmu_prof_decode.py samples.bin | \\
+        scripts/symbolize.py -d out/arm-plat-vexpress/core | \\
+        flamegraph.pl > tee.svg
+'''
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        description='Decodes OP-TEE PMU profiler samples',
+        epilog=epilog)
+    parser.add_argument('file', nargs='?',
+                        help='Sample file (default: standard input)')
+
+    return parser.parse_args()
+
+
+def decode(data, out):
+    hdr_size = struct.calcsize(PMU_PROF_HDR_FMT)
+    smp_size = struct.calcsize(PMU_PROF_SAMPLE_FMT)
+    stacks = collections.Counter()
+    load_addr = None
+    total = 0
+    lost = 0
+    pos = 0
+
+    while pos + hdr_size <= len(data):
+        (version, event, period, nb_samples, addr,
+         nb_lost) = struct.unpack_from(PMU_PROF_HDR_FMT, data, pos)
+        if version != PMU_PROF_VERSION:
+            print('*** Error: unsupported PMU profile version',
+                  file=sys.stderr)
+            sys.exit(1)
+        if load_addr is None:
+            load_addr = addr
+            ev = EVENTS[event] if event < len(EVENTS) else str(event)
+            out.write('TEE load address @ 0x{:x}\n'.format(load_addr))
+            out.write('PMU profile: event {} period {}\n'.format(ev,
+                                                                 period))
+        pos += hdr_size
+        for _ in range(nb_samples):
+            smp = struct.unpack_from(PMU_PROF_SAMPLE_FMT, data, pos)
+            pos += smp_size
+            flags, depth = smp[1], smp[2]
+            mode = 'ta' if flags & PMU_PROF_SAMPLE_USER else 'core'
+            stacks[(mode,) + smp[4:4 + depth]] += 1
+        total += nb_samples
+        lost += nb_lost
+
+    out.write('PMU samples: {} lost {}\n'.format(total, lost))
+    for stack, count in stacks.most_common():
+        out.write('PMU stack {} {}:{}\n'.format(
+            count, stack[0], ''.join(' 0x{:x}'.format(pc)
+                                     for pc in stack[1:])))
+
+
+def main():
+    args = get_args()
+
+    if args.file:
+        with open(args.file, 'rb') as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    decode(data, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
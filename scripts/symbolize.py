@@ -29,6 +29,8 @@ ELF_LIST_RE = re.compile(r'\[(?P<idx>[0-9]+)\] (?P<uuid>[0-9a-f\-]+)'
 FUNC_GRAPH_RE = re.compile(r'Function graph')
 GRAPH_ADDR_RE = re.compile(r'(?P<addr>0x[0-9a-f]+)')
 GRAPH_RE = re.compile(r'}')
+PMU_STACK_RE = re.compile(r'PMU stack (?P<count>[0-9]+) (?P<mode>core|ta):'
+                          r'(?P<addrs>( 0x[0-9a-f]+)+)')
 
 epilog = '''
 This scripts reads an OP-TEE abort or panic message from stdin and adds debug
@@ -65,14 +67,25 @@ Sample usage:
   ^D
 
 Also, this script reads function graph generated for OP-TEE user TA from
-/tmp/ftrace-<ta_uuid>.out file and resolves function addresses to corresponding
-symbols.
+/tmp/ftrace-<ta_uuid>.out file, once decoded by ftrace_decode.py, and resolves
+function addresses to corresponding symbols.
 
 Sample usage:
 
-  $ cat /tmp/ftrace-<ta_uuid>.out | scripts/symbolize.py -d <ta_uuid>.elf
+  $ scripts/ftrace_decode.py /tmp/ftrace-<ta_uuid>.out | \
+        scripts/symbolize.py -d <ta_uuid>.elf
   <paste function graph here>
   ^D
+
+Finally, the call stacks sampled by the PMU profiler, once decoded by
+pmu_prof_decode.py, are converted into folded stacks ('caller;callee count')
+which can be fed to flame graph tools. TA samples are not symbolized.
+
+Sample usage:
+
+  $ scripts/pmu_prof_decode.py samples.bin | \
+        scripts/symbolize.py -d out/arm-plat-vexpress/core | \
+        flamegraph.pl > tee.svg
 '''
 
 
@@ -379,7 +392,24 @@ class Symbolizer(object):
             return re.sub(re.escape(self._strip_path) + '/*', '', path)
         return path
 
+    # Convert a sampled call stack (innermost frame first) into a folded
+    # stack (outermost frame first)
+    def process_pmu_stack(self, match):
+        funcs = []
+        for addr in match.group('addrs').split():
+            if match.group('mode') == 'ta':
+                funcs.append('[ta] ' + addr)
+                continue
+            res = self.resolve(addr)
+            funcs.append(addr if res in ('???', '!!!') else res.split()[0])
+        funcs.reverse()
+        return ';'.join(funcs) + ' ' + match.group('count') + '\n'
+
     def write(self, line):
+        match = re.search(PMU_STACK_RE, line)
+        if match:
+            self._out.write(self.process_pmu_stack(match))
+            return
         if self._call_stack_found:
             match = re.search(STACK_ADDR_RE, line)
             if match:
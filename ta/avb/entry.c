@@ -175,6 +175,135 @@ out:
 	return res;
 }
 
+/*
+ * Read the @num_slots first rollback indexes into @idx. Indexes of slots
+ * not yet written are reported as 0.
+ */
+static TEE_Result read_rb_idxs_from(TEE_ObjectHandle h, uint64_t *idx,
+				    size_t num_slots)
+{
+	size_t size = num_slots * sizeof(uint64_t);
+	size_t slot_offset = 0;
+	uint64_t zero = 0;
+	uint32_t count = 0;
+	size_t n = 0;
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	res = get_slot_offset(0, &slot_offset);
+	if (res)
+		return res;
+
+	res = TEE_SeekObjectData(h, slot_offset, TEE_DATA_SEEK_SET);
+	if (res)
+		return res;
+
+	res = TEE_ReadObjectData(h, idx, size, &count);
+	if (res)
+		return res;
+
+	n = count / sizeof(uint64_t);
+	memset(idx + n, 0, size - n * sizeof(uint64_t));
+
+	if (count % sizeof(uint64_t)) {
+		/*
+		 * Somehow the file didn't even hold a complete
+		 * slot index entry.  Write it as 0.
+		 */
+		res = TEE_SeekObjectData(h, slot_offset + n * sizeof(uint64_t),
+					 TEE_DATA_SEEK_SET);
+		if (res)
+			return res;
+		res = TEE_WriteObjectData(h, &zero, sizeof(zero));
+	}
+
+	return res;
+}
+
+static TEE_Result read_rb_idxs(uint32_t pt, TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_OUTPUT,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE);
+	uint64_t idx[TA_AVB_MAX_ROLLBACK_LOCATIONS] = { };
+	TEE_ObjectHandle h = TEE_HANDLE_NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	size_t num_slots = 0;
+
+	if (pt != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	num_slots = MIN(params[0].memref.size / sizeof(uint64_t),
+			(size_t)TA_AVB_MAX_ROLLBACK_LOCATIONS);
+
+	res = open_rb_state(DEFAULT_LOCK_STATE, &h);
+	if (res)
+		return res;
+
+	res = read_rb_idxs_from(h, idx, num_slots);
+	if (res)
+		goto out;
+
+	TEE_MemMove(params[0].memref.buffer, idx, num_slots * sizeof(*idx));
+	params[0].memref.size = num_slots * sizeof(*idx);
+out:
+	TEE_CloseObject(h);
+	return res;
+}
+
+static TEE_Result write_rb_idxs(uint32_t pt, TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_INPUT,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE);
+	uint64_t widx[TA_AVB_MAX_ROLLBACK_LOCATIONS] = { };
+	uint64_t idx[TA_AVB_MAX_ROLLBACK_LOCATIONS] = { };
+	TEE_ObjectHandle h = TEE_HANDLE_NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	size_t slot_offset = 0;
+	size_t num_slots = 0;
+	size_t n = 0;
+
+	if (pt != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (params[0].memref.size % sizeof(uint64_t) ||
+	    params[0].memref.size > sizeof(widx))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	num_slots = params[0].memref.size / sizeof(uint64_t);
+	TEE_MemMove(widx, params[0].memref.buffer, params[0].memref.size);
+
+	res = get_slot_offset(0, &slot_offset);
+	if (res)
+		return res;
+
+	res = open_rb_state(DEFAULT_LOCK_STATE, &h);
+	if (res)
+		return res;
+
+	res = read_rb_idxs_from(h, idx, num_slots);
+	if (res)
+		goto out;
+
+	for (n = 0; n < num_slots; n++) {
+		if (widx[n] < idx[n]) {
+			res = TEE_ERROR_SECURITY;
+			goto out;
+		}
+	}
+
+	res = TEE_SeekObjectData(h, slot_offset, TEE_DATA_SEEK_SET);
+	if (res)
+		goto out;
+
+	res = TEE_WriteObjectData(h, widx, num_slots * sizeof(*widx));
+out:
+	TEE_CloseObject(h);
+	return res;
+}
+
 static TEE_Result read_lock_state(uint32_t pt, TEE_Param params[TEE_NUM_PARAMS])
 {
 	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
@@ -337,6 +466,187 @@ out:
 	return res;
 }
 
+/*
+ * Get a 32-bit value at offset @*pos of the @size bytes buffer @buf and
+ * advance @*pos
+ */
+static TEE_Result get_u32(const uint8_t *buf, size_t size, size_t *pos,
+			  uint32_t *val)
+{
+	if (*pos > size || size - *pos < sizeof(*val))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	TEE_MemMove(val, buf + *pos, sizeof(*val));
+	*pos += sizeof(*val);
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Store @val at offset @*pos of the @size bytes buffer @buf if it fits
+ * and advance @*pos in any case
+ */
+static void put_u32(uint8_t *buf, size_t size, size_t *pos, uint32_t val)
+{
+	if (*pos <= size && size - *pos >= sizeof(val))
+		TEE_MemMove(buf + *pos, &val, sizeof(val));
+	*pos += sizeof(val);
+}
+
+static TEE_Result write_persist_values(uint32_t pt,
+				       TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_INPUT,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE);
+	const uint32_t flags = TEE_DATA_FLAG_ACCESS_READ |
+			       TEE_DATA_FLAG_ACCESS_WRITE |
+			       TEE_DATA_FLAG_OVERWRITE;
+	uint8_t *buf = params[0].memref.buffer;
+	size_t size = params[0].memref.size;
+	char name_full[TEE_OBJECT_ID_MAX_LEN] = { };
+	TEE_ObjectHandle h = TEE_HANDLE_NULL;
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t name_full_sz = 0;
+	uint32_t value_sz = 0;
+	uint32_t name_sz = 0;
+	size_t pos = 0;
+	char *name = NULL;
+
+	if (pt != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	while (pos < size) {
+		res = get_u32(buf, size, &pos, &name_sz);
+		if (!res)
+			res = get_u32(buf, size, &pos, &value_sz);
+		if (res)
+			return res;
+
+		if (name_sz > size - pos || value_sz > size - pos - name_sz)
+			return TEE_ERROR_BAD_PARAMETERS;
+
+		name = (char *)buf + pos;
+		pos += ROUNDUP((size_t)name_sz + value_sz, sizeof(uint32_t));
+
+		res = get_named_object_name(name, name_sz,
+					    name_full, &name_full_sz);
+		if (res)
+			return res;
+
+		res = TEE_CreatePersistentObject(storageid, name_full,
+						 name_full_sz, flags, NULL,
+						 name + name_sz, value_sz, &h);
+		if (res) {
+			EMSG("Can't create named object value, res = 0x%x",
+			     res);
+			return res;
+		}
+
+		TEE_CloseObject(h);
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result read_persist_values(uint32_t pt,
+				      TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_INPUT,
+						TEE_PARAM_TYPE_MEMREF_OUTPUT,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE);
+	uint32_t flags = TEE_DATA_FLAG_ACCESS_READ |
+			 TEE_DATA_FLAG_ACCESS_WRITE;
+	uint8_t *in = params[0].memref.buffer;
+	size_t in_size = params[0].memref.size;
+	uint8_t *out = params[1].memref.buffer;
+	size_t out_size = params[1].memref.size;
+	char name_full[TEE_OBJECT_ID_MAX_LEN] = { };
+	TEE_ObjectHandle h = TEE_HANDLE_NULL;
+	TEE_ObjectInfo info = { };
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t name_full_sz = 0;
+	uint32_t value_sz = 0;
+	uint32_t name_sz = 0;
+	uint32_t count = 0;
+	size_t in_pos = 0;
+	size_t out_pos = 0;
+	size_t next_pos = 0;
+	uint8_t *value = NULL;
+	char *name = NULL;
+
+	if (pt != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	while (in_pos < in_size) {
+		res = get_u32(in, in_size, &in_pos, &name_sz);
+		if (res)
+			return res;
+
+		if (name_sz > in_size - in_pos)
+			return TEE_ERROR_BAD_PARAMETERS;
+
+		name = (char *)in + in_pos;
+		in_pos += ROUNDUP((size_t)name_sz, sizeof(uint32_t));
+
+		res = get_named_object_name(name, name_sz,
+					    name_full, &name_full_sz);
+		if (res)
+			return res;
+
+		res = TEE_OpenPersistentObject(storageid, name_full,
+					       name_full_sz, flags, &h);
+		if (res == TEE_ERROR_ITEM_NOT_FOUND) {
+			put_u32(out, out_size, &out_pos,
+				TA_AVB_PERSIST_VALUE_NOT_FOUND);
+			continue;
+		}
+		if (res) {
+			EMSG("Can't open named object value, res = 0x%x", res);
+			return res;
+		}
+
+		res = TEE_GetObjectInfo1(h, &info);
+		if (res)
+			goto err;
+		value_sz = info.dataSize;
+
+		if (ADD_OVERFLOW(out_pos, sizeof(uint32_t), &next_pos) ||
+		    ADD_OVERFLOW(next_pos, ROUNDUP(value_sz, sizeof(uint32_t)),
+				 &next_pos)) {
+			res = TEE_ERROR_OVERFLOW;
+			goto err;
+		}
+
+		if (next_pos <= out_size) {
+			value = out + out_pos + sizeof(uint32_t);
+			res = TEE_ReadObjectData(h, value, value_sz, &count);
+			if (res) {
+				EMSG("Can't read named value, res = 0x%x", res);
+				goto err;
+			}
+			value_sz = count;
+			memset(value + value_sz, 0,
+			       out + next_pos - (value + value_sz));
+		}
+
+		TEE_CloseObject(h);
+		put_u32(out, out_size, &out_pos, value_sz);
+		out_pos = next_pos;
+	}
+
+	params[1].memref.size = out_pos;
+	if (out_pos > out_size)
+		return TEE_ERROR_SHORT_BUFFER;
+
+	return TEE_SUCCESS;
+err:
+	TEE_CloseObject(h);
+	return res;
+}
+
 TEE_Result TA_CreateEntryPoint(void)
 {
 	return TEE_SUCCESS;
@@ -374,6 +684,14 @@ TEE_Result TA_InvokeCommandEntryPoint(void *sess __unused, uint32_t cmd,
 		return read_persist_value(pt, params);
 	case TA_AVB_CMD_WRITE_PERSIST_VALUE:
 		return write_persist_value(pt, params);
+	case TA_AVB_CMD_READ_ROLLBACK_INDEXES:
+		return read_rb_idxs(pt, params);
+	case TA_AVB_CMD_WRITE_ROLLBACK_INDEXES:
+		return write_rb_idxs(pt, params);
+	case TA_AVB_CMD_READ_PERSIST_VALUES:
+		return read_persist_values(pt, params);
+	case TA_AVB_CMD_WRITE_PERSIST_VALUES:
+		return write_persist_values(pt, params);
 	default:
 		EMSG("Command ID 0x%x is not supported", cmd);
 		return TEE_ERROR_NOT_SUPPORTED;
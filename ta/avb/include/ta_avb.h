@@ -61,4 +61,57 @@
  */
 #define TA_AVB_CMD_WRITE_PERSIST_VALUE	5
 
+/*
+ * Gets the rollback indexes of the first rollback index slots.
+ *
+ * The number of slots read is the buffer size divided by 8, at most
+ * TA_AVB_MAX_ROLLBACK_LOCATIONS.
+ *
+ * out	params[0].memref:	array of 64-bit rollback indexes, entry n
+ *				being the index of slot n
+ */
+#define TA_AVB_CMD_READ_ROLLBACK_INDEXES	6
+
+/*
+ * Updates the rollback indexes of the first rollback index slots.
+ *
+ * Will refuse to update any slot with a lower value, in which case no
+ * slot is updated. The number of slots written is the buffer size
+ * divided by 8, at most TA_AVB_MAX_ROLLBACK_LOCATIONS.
+ *
+ * in	params[0].memref:	array of 64-bit rollback indexes, entry n
+ *				being the index of slot n
+ */
+#define TA_AVB_CMD_WRITE_ROLLBACK_INDEXES	7
+
+/*
+ * Reads several persistent values.
+ *
+ * Each requested name is a 32-bit name size followed by the name, padded
+ * to a multiple of 4 bytes. Each returned value is a 32-bit value size
+ * followed by the value, padded to a multiple of 4 bytes, in the order of
+ * the names. A value size of TA_AVB_PERSIST_VALUE_NOT_FOUND, with no value
+ * following, reports a name with no persistent value.
+ *
+ * If the output buffer is too small TEE_ERROR_SHORT_BUFFER is returned
+ * with params[1].memref.size set to the needed size.
+ *
+ * in	params[0].memref:	persistent value names
+ * out	params[1].memref:	persistent values
+ */
+#define TA_AVB_CMD_READ_PERSIST_VALUES	8
+
+/*
+ * Writes several persistent values.
+ *
+ * Each value is a 32-bit name size, a 32-bit value size, the name and
+ * the value, padded to a multiple of 4 bytes. The values are written in
+ * order, the command stops at the first value that can't be written.
+ *
+ * in	params[0].memref:	persistent names and values to write
+ */
+#define TA_AVB_CMD_WRITE_PERSIST_VALUES	9
+
+#define TA_AVB_PERSIST_VALUE_NOT_FOUND	0xffffffff
+
 #endif /*__TA_AVB_H*/
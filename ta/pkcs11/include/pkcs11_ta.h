@@ -14,7 +14,7 @@
 
 /* PKCS11 trusted application version information */
 #define PKCS11_TA_VERSION_MAJOR			0
-#define PKCS11_TA_VERSION_MINOR			1
+#define PKCS11_TA_VERSION_MINOR			2
 #define PKCS11_TA_VERSION_PATCH			0
 
 /* Attribute specific values */
@@ -49,6 +49,12 @@
  * Param#3 is currently unused and reserved for evolution of the API.
  */
 
+/*
+ * The command IDs are the ones of the upstream PKCS#11 TA and client
+ * library, the IDs of the commands this TA doesn't implement are left
+ * unused. Command IDs from 0x80000000 are specific to this implementation.
+ */
+
 /*
  * PKCS11_CMD_PING		Acknowledge TA presence and return version info
  *
@@ -60,4 +66,501 @@
  *              ]
  */
 #define PKCS11_CMD_PING				0
+
+/*
+ * PKCS11_CMD_SLOT_LIST - Get the table of the valid slot IDs
+ *
+ * [out]        memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]        memref[2] = 32bit array slot_ids[slot counts]
+ *
+ * The TA instance may represent several PKCS#11 slots and
+ * associated tokens. This command reports the IDs of embedded tokens.
+ * This command relates the PKCS#11 API function C_GetSlotList().
+ */
+#define PKCS11_CMD_SLOT_LIST			1
+
+/*
+ * PKCS11_CMD_SLOT_INFO - Get cryptoki structured slot information
+ *
+ * [in]		memref[0] = 32bit slot ID
+ * [out]	memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]	memref[2] = (struct pkcs11_slot_info)info
+ *
+ * This command relates the PKCS#11 API function C_GetSlotInfo().
+ */
+#define PKCS11_CMD_SLOT_INFO			2
+
+/*
+ * PKCS11_CMD_TOKEN_INFO - Get cryptoki structured token information
+ *
+ * [in]		memref[0] = 32bit slot ID
+ * [out]	memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]	memref[2] = (struct pkcs11_token_info)info
+ *
+ * This command relates the PKCS#11 API function C_GetTokenInfo().
+ */
+#define PKCS11_CMD_TOKEN_INFO			3
+
+/*
+ * PKCS11_CMD_MECHANISM_IDS - Get list of the supported mechanisms
+ *
+ * [in]		memref[0] = 32bit slot ID
+ * [out]	memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]	memref[2] = 32bit array mechanism IDs
+ *
+ * This command relates to the PKCS#11 API function
+ * C_GetMechanismList().
+ */
+#define PKCS11_CMD_MECHANISM_IDS		4
+
+/*
+ * PKCS11_CMD_OPEN_SESSION - Open a session
+ *
+ * [in]     memref[0] = [
+ *              32bit slot ID,
+ *              32bit session flags, PKCS11_CKFSS_*
+ *          ]
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]    memref[2] = 32bit session handle
+ *
+ * This command relates to the PKCS#11 API function C_OpenSession().
+ */
+#define PKCS11_CMD_OPEN_SESSION			11
+
+/*
+ * PKCS11_CMD_CLOSE_SESSION - Close an opened session
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ *
+ * This command relates to the PKCS#11 API function C_CloseSession().
+ */
+#define PKCS11_CMD_CLOSE_SESSION		12
+
+/*
+ * PKCS11_CMD_CLOSE_ALL_SESSIONS - Close all client sessions on token
+ *
+ * [in]	    memref[0] = 32bit slot ID
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ *
+ * This command relates to the PKCS#11 API function C_CloseAllSessions().
+ */
+#define PKCS11_CMD_CLOSE_ALL_SESSIONS		14
+
+/*
+ * PKCS11_CMD_CREATE_OBJECT - Create a raw client assembled object in
+ * the session or token
+ *
+ * [in]     memref[0] = [
+ *              32bit session handle,
+ *              (struct pkcs11_object_head)attribs + attributes data
+ *          ]
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]    memref[2] = 32bit object handle
+ *
+ * This command relates to the PKCS#11 API function C_CreateObject().
+ */
+#define PKCS11_CMD_CREATE_OBJECT		15
+
+/*
+ * PKCS11_CMD_DESTROY_OBJECT - Destroy an object
+ *
+ * [in]     memref[0] = [
+ *              32bit session handle,
+ *              32bit object handle
+ *          ]
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ *
+ * This command relates to the PKCS#11 API function C_DestroyObject().
+ */
+#define PKCS11_CMD_DESTROY_OBJECT		16
+
+/*
+ * PKCS11_CMD_FIND_OBJECTS_INIT - Initialize an object search
+ *
+ * [in]     memref[0] = [
+ *              32bit session handle,
+ *              (struct pkcs11_object_head)attribs + attributes data
+ *          ]
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ *
+ * This command relates to the PKCS#11 API function C_FindObjectsInit().
+ */
+#define PKCS11_CMD_FIND_OBJECTS_INIT		34
+
+/*
+ * PKCS11_CMD_FIND_OBJECTS - Get handles of matching objects
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]    memref[2] = 32bit array object_handle_array[N]
+ *
+ * The number of handles returned is limited by the size of memref[2].
+ *
+ * This command relates to the PKCS#11 API function C_FindObjects().
+ */
+#define PKCS11_CMD_FIND_OBJECTS			35
+
+/*
+ * PKCS11_CMD_FIND_OBJECTS_FINAL - Finalize current objects search
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ *
+ * This command relates to the PKCS#11 API function C_FindObjectsFinal().
+ */
+#define PKCS11_CMD_FIND_OBJECTS_FINAL		36
+
+/*
+ * PKCS11_CMD_ENCRYPT_INIT - Initialize encryption processing
+ * PKCS11_CMD_DECRYPT_INIT - Initialize decryption processing
+ * PKCS11_CMD_SIGN_INIT - Initialize signing processing
+ * PKCS11_CMD_VERIFY_INIT - Initialize verification processing
+ *
+ * [in]     memref[0] = [
+ *              32bit session handle,
+ *              32bit key handle,
+ *              (struct pkcs11_attribute_head)mechanism + mecha params
+ *          ]
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ *
+ * PKCS11_CMD_DIGEST_INIT - Initialize digest processing
+ *
+ * [in]     memref[0] = [
+ *              32bit session handle,
+ *              (struct pkcs11_attribute_head)mechanism + mecha params
+ *          ]
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ *
+ * These commands relate to the PKCS#11 API functions C_EncryptInit(),
+ * C_DecryptInit(), C_SignInit(), C_VerifyInit() and C_DigestInit().
+ *
+ * The TEE operation set up for a key and a mechanism is kept by the
+ * session when the processing completes and reused by a later
+ * initialization with the same key and mechanism.
+ */
+#define PKCS11_CMD_ENCRYPT_INIT			17
+#define PKCS11_CMD_DECRYPT_INIT			18
+#define PKCS11_CMD_DIGEST_INIT			45
+#define PKCS11_CMD_SIGN_INIT			25
+#define PKCS11_CMD_VERIFY_INIT			26
+
+/*
+ * PKCS11_CMD_ENCRYPT_UPDATE - Update encryption processing
+ * PKCS11_CMD_DECRYPT_UPDATE - Update decryption processing
+ * PKCS11_CMD_DIGEST_UPDATE - Update digest processing
+ * PKCS11_CMD_SIGN_UPDATE - Update signing processing
+ * PKCS11_CMD_VERIFY_UPDATE - Update verification processing
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [in]     memref[1] = input data to be processed
+ * [out]    memref[2] = output processed data (encrypt/decrypt only)
+ *
+ * These commands relate to the PKCS#11 API functions C_EncryptUpdate(),
+ * C_DecryptUpdate(), C_DigestUpdate(), C_SignUpdate() and
+ * C_VerifyUpdate().
+ */
+#define PKCS11_CMD_ENCRYPT_UPDATE		19
+#define PKCS11_CMD_DECRYPT_UPDATE		20
+#define PKCS11_CMD_DIGEST_UPDATE		47
+#define PKCS11_CMD_SIGN_UPDATE			27
+#define PKCS11_CMD_VERIFY_UPDATE		28
+
+/*
+ * PKCS11_CMD_ENCRYPT_FINAL - Finalize encryption processing
+ * PKCS11_CMD_DECRYPT_FINAL - Finalize decryption processing
+ * PKCS11_CMD_DIGEST_FINAL - Finalize digest processing
+ * PKCS11_CMD_SIGN_FINAL - Finalize signing processing
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [out]    memref[2] = output processed data
+ *
+ * PKCS11_CMD_VERIFY_FINAL - Finalize verification processing
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [in]     memref[2] = signature to verify
+ *
+ * These commands relate to the PKCS#11 API functions C_EncryptFinal(),
+ * C_DecryptFinal(), C_DigestFinal(), C_SignFinal() and C_VerifyFinal().
+ */
+#define PKCS11_CMD_ENCRYPT_FINAL		21
+#define PKCS11_CMD_DECRYPT_FINAL		22
+#define PKCS11_CMD_DIGEST_FINAL			48
+#define PKCS11_CMD_SIGN_FINAL			29
+#define PKCS11_CMD_VERIFY_FINAL			30
+
+/*
+ * PKCS11_CMD_ENCRYPT_ONESHOT - Update and finalize encryption processing
+ * PKCS11_CMD_DECRYPT_ONESHOT - Update and finalize decryption processing
+ * PKCS11_CMD_DIGEST_ONESHOT - Update and finalize digest processing
+ * PKCS11_CMD_SIGN_ONESHOT - Update and finalize signing processing
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [in]     memref[1] = input data to be processed
+ * [out]    memref[2] = output processed data
+ *
+ * PKCS11_CMD_VERIFY_ONESHOT - Update and finalize verification processing
+ *
+ * [in]     memref[0] = 32bit session handle
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [in]     memref[1] = input data to be processed
+ * [in]     memref[2] = signature to verify
+ *
+ * These commands relate to the PKCS#11 API functions C_Encrypt(),
+ * C_Decrypt(), C_Digest(), C_Sign() and C_Verify().
+ */
+#define PKCS11_CMD_ENCRYPT_ONESHOT		23
+#define PKCS11_CMD_DECRYPT_ONESHOT		24
+#define PKCS11_CMD_DIGEST_ONESHOT		49
+#define PKCS11_CMD_SIGN_ONESHOT			31
+#define PKCS11_CMD_VERIFY_ONESHOT		32
+
+/*
+ * PKCS11_CMD_SIGN_DIGESTS - Sign several precomputed digests
+ *
+ * [in]     memref[0] = [
+ *              32bit session handle,
+ *              32bit key handle,
+ *              32bit number of digests,
+ *              (struct pkcs11_attribute_head)mechanism + mecha params
+ *          ]
+ * [out]    memref[0] = 32bit return code, enum pkcs11_rc
+ * [in]     memref[1] = the digests, back to back, all of the same size
+ * [out]    memref[2] = the signatures, back to back, each of the size of
+ *			a signature with the key
+ *
+ * Only for mechanisms signing a digest: PKCS11_CKM_ECDSA and
+ * PKCS11_CKM_SHA*_RSA_PKCS where each digest is the hash of the data to
+ * sign. The signing operation is set up once for all digests and kept
+ * by the session as for PKCS11_CMD_SIGN_INIT. The session must not have
+ * an active signing processing.
+ */
+#define PKCS11_CMD_SIGN_DIGESTS			0x80000000
+
+/*
+ * Command return codes
+ * PKCS11_<x> relates CryptoKi client API CKR_<x>
+ */
+enum pkcs11_rc {
+	PKCS11_CKR_OK				= 0,
+	PKCS11_CKR_SLOT_ID_INVALID		= 0x0003,
+	PKCS11_CKR_GENERAL_ERROR		= 0x0005,
+	PKCS11_CKR_ARGUMENTS_BAD		= 0x0007,
+	PKCS11_CKR_ATTRIBUTE_TYPE_INVALID	= 0x0012,
+	PKCS11_CKR_ATTRIBUTE_VALUE_INVALID	= 0x0013,
+	PKCS11_CKR_DATA_INVALID			= 0x0020,
+	PKCS11_CKR_DATA_LEN_RANGE		= 0x0021,
+	PKCS11_CKR_DEVICE_MEMORY		= 0x0031,
+	PKCS11_CKR_ENCRYPTED_DATA_INVALID	= 0x0040,
+	PKCS11_CKR_ENCRYPTED_DATA_LEN_RANGE	= 0x0041,
+	PKCS11_CKR_FUNCTION_NOT_SUPPORTED	= 0x0054,
+	PKCS11_CKR_KEY_HANDLE_INVALID		= 0x0060,
+	PKCS11_CKR_KEY_SIZE_RANGE		= 0x0062,
+	PKCS11_CKR_KEY_TYPE_INCONSISTENT	= 0x0063,
+	PKCS11_CKR_KEY_FUNCTION_NOT_PERMITTED	= 0x0068,
+	PKCS11_CKR_MECHANISM_INVALID		= 0x0070,
+	PKCS11_CKR_MECHANISM_PARAM_INVALID	= 0x0071,
+	PKCS11_CKR_OBJECT_HANDLE_INVALID	= 0x0082,
+	PKCS11_CKR_OPERATION_ACTIVE		= 0x0090,
+	PKCS11_CKR_OPERATION_NOT_INITIALIZED	= 0x0091,
+	PKCS11_CKR_SESSION_COUNT		= 0x00b1,
+	PKCS11_CKR_SESSION_HANDLE_INVALID	= 0x00b3,
+	PKCS11_CKR_SESSION_PARALLEL_NOT_SUPPORTED = 0x00b4,
+	PKCS11_CKR_SESSION_READ_ONLY		= 0x00b5,
+	PKCS11_CKR_SIGNATURE_INVALID		= 0x00c0,
+	PKCS11_CKR_SIGNATURE_LEN_RANGE		= 0x00c1,
+	PKCS11_CKR_TEMPLATE_INCOMPLETE		= 0x00d0,
+	PKCS11_CKR_TEMPLATE_INCONSISTENT	= 0x00d1,
+	PKCS11_CKR_BUFFER_TOO_SMALL		= 0x0150,
+	/* Status without strict equivalence in Cryptoki API */
+	PKCS11_RV_NOT_FOUND			= 0xfffffffe,
+	PKCS11_RV_NOT_IMPLEMENTED		= 0xffffffff,
+};
+
+/*
+ * Arguments for PKCS11_CMD_SLOT_INFO
+ */
+#define PKCS11_SLOT_DESC_SIZE			64
+#define PKCS11_SLOT_MANUFACTURER_SIZE		32
+#define PKCS11_SLOT_VERSION_SIZE		2
+
+struct pkcs11_slot_info {
+	uint8_t slot_description[PKCS11_SLOT_DESC_SIZE];
+	uint8_t manufacturer_id[PKCS11_SLOT_MANUFACTURER_SIZE];
+	uint32_t flags;
+	uint8_t hardware_version[PKCS11_SLOT_VERSION_SIZE];
+	uint8_t firmware_version[PKCS11_SLOT_VERSION_SIZE];
+};
+
+/*
+ * Values for pkcs11_slot_info::flags.
+ * PKCS11_CKFS_<x> reflects CryptoKi client API slot flags CKF_<x>.
+ */
+#define PKCS11_CKFS_TOKEN_PRESENT		(1U << 0)
+#define PKCS11_CKFS_REMOVABLE_DEVICE		(1U << 1)
+#define PKCS11_CKFS_HW_SLOT			(1U << 2)
+
+/*
+ * Arguments for PKCS11_CMD_TOKEN_INFO
+ */
+#define PKCS11_TOKEN_LABEL_SIZE			32
+#define PKCS11_TOKEN_MANUFACTURER_SIZE		32
+#define PKCS11_TOKEN_MODEL_SIZE			16
+#define PKCS11_TOKEN_SERIALNUM_SIZE		16
+
+struct pkcs11_token_info {
+	uint8_t label[PKCS11_TOKEN_LABEL_SIZE];
+	uint8_t manufacturer_id[PKCS11_TOKEN_MANUFACTURER_SIZE];
+	uint8_t model[PKCS11_TOKEN_MODEL_SIZE];
+	uint8_t serial_number[PKCS11_TOKEN_SERIALNUM_SIZE];
+	uint32_t flags;
+	uint32_t max_session_count;
+	uint32_t session_count;
+	uint32_t max_rw_session_count;
+	uint32_t rw_session_count;
+	uint32_t max_pin_len;
+	uint32_t min_pin_len;
+	uint32_t total_public_memory;
+	uint32_t free_public_memory;
+	uint32_t total_private_memory;
+	uint32_t free_private_memory;
+	uint8_t hardware_version[2];
+	uint8_t firmware_version[2];
+	uint8_t utc_time[16];
+};
+
+/*
+ * Values for pkcs11_token_info::flags.
+ * PKCS11_CKFT_<x> reflects CryptoKi client API token flags CKF_<x>.
+ */
+#define PKCS11_CKFT_RNG					(1U << 0)
+#define PKCS11_CKFT_WRITE_PROTECTED			(1U << 1)
+#define PKCS11_CKFT_LOGIN_REQUIRED			(1U << 2)
+#define PKCS11_CKFT_USER_PIN_INITIALIZED		(1U << 3)
+#define PKCS11_CKFT_TOKEN_INITIALIZED			(1U << 10)
+
+/*
+ * Values for 32bit session flags argument to PKCS11_CMD_OPEN_SESSION
+ * and pkcs11_session_info::flags.
+ * PKCS11_CKFSS_<x> reflects CryptoKi client API session flags CKF_<x>.
+ */
+#define PKCS11_CKFSS_RW_SESSION				(1U << 1)
+#define PKCS11_CKFSS_SERIAL_SESSION			(1U << 2)
+
+/*
+ * TEE PKCS11 objects attributes are formatted in memory as a header
+ * followed by the attributes, each being a struct pkcs11_attribute_head
+ * immediately followed by its data.
+ *
+ * @attrs_size:		byte size of the serialized attributes
+ * @attrs_count:	number of serialized attributes
+ * @attrs:		serialized attributes
+ */
+struct pkcs11_object_head {
+	uint32_t attrs_size;
+	uint32_t attrs_count;
+	uint8_t attrs[];
+};
+
+/*
+ * Attribute reference in the TA ABI. Each attribute starts with a header
+ * structure followed by the attribute value. The attribute byte size is
+ * defined in the attribute header.
+ *
+ * @id:		the 32bit identifier of the attribute, see PKCS11_CKA_<x>
+ * @size:	the 32bit value attribute byte size
+ * @data:	the effective attribute value
+ *
+ * Mechanisms are serialized in the same way with @id set to the
+ * mechanism ID, see PKCS11_CKM_<x>, and @data holding the mechanism
+ * parameters.
+ */
+struct pkcs11_attribute_head {
+	uint32_t id;
+	uint32_t size;
+	uint8_t data[];
+};
+
+/*
+ * Attribute identification IDs
+ * Valid values for struct pkcs11_attribute_head::id
+ * PKCS11_CKA_<x> reflects CryptoKi client API attribute IDs CKA_<x>.
+ * Boolean attributes have a 1 byte value, 0 or 1.
+ */
+enum pkcs11_attr_id {
+	PKCS11_CKA_CLASS			= 0x0000,
+	PKCS11_CKA_TOKEN			= 0x0001,
+	PKCS11_CKA_PRIVATE			= 0x0002,
+	PKCS11_CKA_LABEL			= 0x0003,
+	PKCS11_CKA_VALUE			= 0x0011,
+	PKCS11_CKA_KEY_TYPE			= 0x0100,
+	PKCS11_CKA_ID				= 0x0102,
+	PKCS11_CKA_SENSITIVE			= 0x0103,
+	PKCS11_CKA_ENCRYPT			= 0x0104,
+	PKCS11_CKA_DECRYPT			= 0x0105,
+	PKCS11_CKA_SIGN				= 0x0108,
+	PKCS11_CKA_VERIFY			= 0x010a,
+	PKCS11_CKA_MODULUS			= 0x0120,
+	PKCS11_CKA_MODULUS_BITS			= 0x0121,
+	PKCS11_CKA_PUBLIC_EXPONENT		= 0x0122,
+	PKCS11_CKA_PRIVATE_EXPONENT		= 0x0123,
+	PKCS11_CKA_VALUE_LEN			= 0x0161,
+	PKCS11_CKA_EXTRACTABLE			= 0x0162,
+	PKCS11_CKA_EC_PARAMS			= 0x0180,
+	PKCS11_CKA_EC_POINT			= 0x0181,
+	PKCS11_CKA_UNDEFINED_ID			= PKCS11_UNDEFINED_ID,
+};
+
+/*
+ * Valid values for attribute PKCS11_CKA_CLASS
+ * PKCS11_CKO_<x> reflects CryptoKi client API object class IDs CKO_<x>.
+ */
+enum pkcs11_class_id {
+	PKCS11_CKO_DATA				= 0x000,
+	PKCS11_CKO_PUBLIC_KEY			= 0x002,
+	PKCS11_CKO_PRIVATE_KEY			= 0x003,
+	PKCS11_CKO_SECRET_KEY			= 0x004,
+	PKCS11_CKO_UNDEFINED_ID			= PKCS11_UNDEFINED_ID,
+};
+
+/*
+ * Valid values for attribute PKCS11_CKA_KEY_TYPE
+ * PKCS11_CKK_<x> reflects CryptoKi client API key type IDs CKK_<x>.
+ */
+enum pkcs11_key_type {
+	PKCS11_CKK_RSA				= 0x000,
+	PKCS11_CKK_EC				= 0x003,
+	PKCS11_CKK_GENERIC_SECRET		= 0x010,
+	PKCS11_CKK_AES				= 0x01f,
+	PKCS11_CKK_UNDEFINED_ID			= PKCS11_UNDEFINED_ID,
+};
+
+/*
+ * Valid values for mechanism IDs
+ * PKCS11_CKM_<x> reflects CryptoKi client API mechanism IDs CKM_<x>.
+ *
+ * PKCS11_CKM_AES_CBC takes the 16 byte IV as parameter, the other
+ * mechanisms take no parameter. PKCS11_CKM_ECDSA signs the data as a
+ * digest, the EC key is identified by its PKCS11_CKA_EC_PARAMS being the
+ * DER encoded OID of a NIST P-192, P-224, P-256, P-384 or P-521 curve.
+ */
+enum pkcs11_mechanism_id {
+	PKCS11_CKM_SHA256_RSA_PKCS		= 0x00040,
+	PKCS11_CKM_SHA384_RSA_PKCS		= 0x00041,
+	PKCS11_CKM_SHA512_RSA_PKCS		= 0x00042,
+	PKCS11_CKM_SHA_1			= 0x00220,
+	PKCS11_CKM_SHA256			= 0x00250,
+	PKCS11_CKM_SHA256_HMAC			= 0x00251,
+	PKCS11_CKM_SHA384			= 0x00260,
+	PKCS11_CKM_SHA512			= 0x00270,
+	PKCS11_CKM_ECDSA			= 0x01041,
+	PKCS11_CKM_AES_ECB			= 0x01081,
+	PKCS11_CKM_AES_CBC			= 0x01082,
+	PKCS11_CKM_UNDEFINED_ID			= PKCS11_UNDEFINED_ID,
+};
+
 #endif /*PKCS11_TA_H*/
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#include <pkcs11_ta.h>
+#include <string.h>
+#include <tee_internal_api.h>
+#include <trace.h>
+#include <util.h>
+
+#include "attributes.h"
+
+/*
+ * Find attribute @id in the @size bytes of serialized attributes at
+ * @start. Attributes aren't aligned in the serialized list, the header
+ * of each attribute is copied out before it's used.
+ */
+static enum pkcs11_rc find_attr(uint8_t *start, size_t size, uint32_t id,
+				void **data, uint32_t *data_size)
+{
+	struct pkcs11_attribute_head ah = { };
+	uint8_t *cur = start;
+
+	while (cur < start + size) {
+		TEE_MemMove(&ah, cur, sizeof(ah));
+		if (ah.id == id) {
+			if (data)
+				*data = cur + sizeof(ah);
+			if (data_size)
+				*data_size = ah.size;
+			return PKCS11_CKR_OK;
+		}
+		cur += sizeof(ah) + ah.size;
+	}
+
+	return PKCS11_RV_NOT_FOUND;
+}
+
+enum pkcs11_rc check_attrs_format(struct obj_attrs *head)
+{
+	uint8_t *end = head->attrs + head->attrs_size;
+	struct pkcs11_attribute_head ah = { };
+	uint8_t *cur = head->attrs;
+	uint32_t count = 0;
+	size_t len = 0;
+
+	while (cur < end) {
+		if ((size_t)(end - cur) < sizeof(ah))
+			return PKCS11_CKR_TEMPLATE_INCONSISTENT;
+
+		TEE_MemMove(&ah, cur, sizeof(ah));
+		if (ADD_OVERFLOW(sizeof(ah), ah.size, &len) ||
+		    len > (size_t)(end - cur))
+			return PKCS11_CKR_TEMPLATE_INCONSISTENT;
+
+		/* An attribute ID appears only once in a list */
+		if (!find_attr(head->attrs, cur - head->attrs, ah.id, NULL,
+			       NULL))
+			return PKCS11_CKR_TEMPLATE_INCONSISTENT;
+
+		cur += len;
+		count++;
+	}
+
+	if (count != head->attrs_count)
+		return PKCS11_CKR_TEMPLATE_INCONSISTENT;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc get_attribute_ptr(struct obj_attrs *head, uint32_t attribute,
+				 void **attr, uint32_t *attr_size)
+{
+	return find_attr(head->attrs, head->attrs_size, attribute, attr,
+			 attr_size);
+}
+
+enum pkcs11_rc get_u32_attribute(struct obj_attrs *head, uint32_t attribute,
+				 uint32_t *val)
+{
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t size = 0;
+	void *data = NULL;
+
+	rc = get_attribute_ptr(head, attribute, &data, &size);
+	if (rc)
+		return rc;
+
+	if (size != sizeof(uint32_t))
+		return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+
+	TEE_MemMove(val, data, sizeof(uint32_t));
+
+	return PKCS11_CKR_OK;
+}
+
+bool get_bool(struct obj_attrs *head, uint32_t attribute)
+{
+	uint8_t *data = NULL;
+	uint32_t size = 0;
+
+	if (get_attribute_ptr(head, attribute, (void **)&data, &size) ||
+	    size != 1)
+		return false;
+
+	return *data;
+}
+
+bool attributes_match_reference(struct obj_attrs *candidate,
+				struct obj_attrs *ref)
+{
+	uint8_t *end = ref->attrs + ref->attrs_size;
+	struct pkcs11_attribute_head ah = { };
+	uint8_t *cur = ref->attrs;
+	uint32_t size = 0;
+	void *data = NULL;
+
+	while (cur < end) {
+		TEE_MemMove(&ah, cur, sizeof(ah));
+
+		if (get_attribute_ptr(candidate, ah.id, &data, &size) ||
+		    size != ah.size ||
+		    TEE_MemCompare(data, cur + sizeof(ah), size))
+			return false;
+
+		cur += sizeof(ah) + ah.size;
+	}
+
+	return true;
+}
+
+/* 32bit FNV-1a over the attribute ID and value */
+uint32_t attribute_hash(uint32_t attribute, const void *data, size_t size)
+{
+	const uint8_t *id = (const uint8_t *)&attribute;
+	const uint8_t *p = data;
+	uint32_t h = 0x811c9dc5;
+	size_t n = 0;
+
+	for (n = 0; n < sizeof(attribute); n++)
+		h = (h ^ id[n]) * 0x01000193;
+	for (n = 0; n < size; n++)
+		h = (h ^ p[n]) * 0x01000193;
+
+	return h;
+}
+
+void attributes_hash_each(struct obj_attrs *head, uint32_t *hashes)
+{
+	uint8_t *end = head->attrs + head->attrs_size;
+	struct pkcs11_attribute_head ah = { };
+	uint8_t *cur = head->attrs;
+	size_t n = 0;
+
+	while (cur < end) {
+		TEE_MemMove(&ah, cur, sizeof(ah));
+		hashes[n++] = attribute_hash(ah.id, cur + sizeof(ah), ah.size);
+		cur += sizeof(ah) + ah.size;
+	}
+}
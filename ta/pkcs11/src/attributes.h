@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#ifndef PKCS11_TA_ATTRIBUTES_H
+#define PKCS11_TA_ATTRIBUTES_H
+
+#include <pkcs11_ta.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Serialized object attributes are a struct pkcs11_object_head followed
+ * by the attributes, each being a struct pkcs11_attribute_head followed
+ * by its value.
+ */
+struct obj_attrs {
+	uint32_t attrs_size;
+	uint32_t attrs_count;
+	uint8_t attrs[];
+};
+
+/*
+ * check_attrs_format() - Check a serialized attribute list
+ * @head:	Pointer to serialized attributes
+ *
+ * Checks that each attribute is within the list, that the number of
+ * attributes matches the header and that no attribute ID is repeated.
+ */
+enum pkcs11_rc check_attrs_format(struct obj_attrs *head);
+
+/*
+ * get_attribute_ptr() - Get pointer to the attribute of an ID
+ * @head:	Pointer to serialized attributes
+ * @attribute:	Attribute ID
+ * @attr:	Output pointer to the attribute value or NULL if not needed
+ * @attr_size:	Output size of the attribute value or NULL if not needed
+ *
+ * Return PKCS11_CKR_OK if attribute is found, else PKCS11_RV_NOT_FOUND
+ */
+enum pkcs11_rc get_attribute_ptr(struct obj_attrs *head, uint32_t attribute,
+				 void **attr, uint32_t *attr_size);
+
+/*
+ * get_u32_attribute() - Get the 32bit value of an attribute
+ * @head:	Pointer to serialized attributes
+ * @attribute:	Attribute ID
+ * @val:	Output attribute value
+ *
+ * Return PKCS11_CKR_OK if found, PKCS11_RV_NOT_FOUND if not found or
+ * PKCS11_CKR_ATTRIBUTE_VALUE_INVALID if the value isn't 32bit
+ */
+enum pkcs11_rc get_u32_attribute(struct obj_attrs *head, uint32_t attribute,
+				 uint32_t *val);
+
+/*
+ * get_bool() - Get the value of a boolean attribute
+ * @head:	Pointer to serialized attributes
+ * @attribute:	Attribute ID
+ *
+ * Returns false if the attribute isn't found
+ */
+bool get_bool(struct obj_attrs *head, uint32_t attribute);
+
+/*
+ * attributes_match_reference() - Check attributes against a template
+ * @candidate:	Attributes of an object
+ * @ref:	Template attributes
+ *
+ * Returns true if each attribute of @ref is in @candidate with the same
+ * value
+ */
+bool attributes_match_reference(struct obj_attrs *candidate,
+				struct obj_attrs *ref);
+
+/*
+ * attribute_hash() - Hash an attribute ID and value
+ * @attribute:	Attribute ID
+ * @data:	Attribute value
+ * @size:	Size of the attribute value
+ */
+uint32_t attribute_hash(uint32_t attribute, const void *data, size_t size);
+
+/*
+ * attributes_hash_each() - Hash each attribute of a list
+ * @head:	Pointer to serialized attributes
+ * @hashes:	Output array of @head->attrs_count hashes
+ */
+void attributes_hash_each(struct obj_attrs *head, uint32_t *hashes);
+
+#endif /*PKCS11_TA_ATTRIBUTES_H*/
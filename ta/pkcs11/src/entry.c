@@ -7,26 +7,39 @@
 #include <pkcs11_ta.h>
 #include <tee_internal_api.h>
 
+#include "object.h"
+#include "pkcs11_token.h"
+#include "processing.h"
+
 TEE_Result TA_CreateEntryPoint(void)
 {
-	return TEE_SUCCESS;
+	return pkcs11_init();
 }
 
 void TA_DestroyEntryPoint(void)
 {
+	pkcs11_deinit();
 }
 
 TEE_Result TA_OpenSessionEntryPoint(uint32_t __unused param_types,
 				    TEE_Param __unused params[4],
-				    void **session)
+				    void **tee_session)
 {
-	*session = NULL;
+	struct pkcs11_client *client = register_client();
+
+	if (!client)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	*tee_session = client;
 
 	return TEE_SUCCESS;
 }
 
-void TA_CloseSessionEntryPoint(void *session __unused)
+void TA_CloseSessionEntryPoint(void *tee_session)
 {
+	struct pkcs11_client *client = tee_session2client(tee_session);
+
+	unregister_client(client);
 }
 
 /*
@@ -67,15 +80,16 @@ static TEE_Result entry_ping(TEE_Param *ctrl, TEE_Param *in, TEE_Param *out)
 /*
  * Entry point for PKCS11 TA commands
  */
-TEE_Result TA_InvokeCommandEntryPoint(void *tee_session __unused, uint32_t cmd,
+TEE_Result TA_InvokeCommandEntryPoint(void *tee_session, uint32_t cmd,
 				      uint32_t ptypes,
 				      TEE_Param params[TEE_NUM_PARAMS])
 {
+	struct pkcs11_client *client = tee_session2client(tee_session);
 	TEE_Param *ctrl = NULL;
 	TEE_Param *p1_in = NULL;
-	TEE_Param __maybe_unused *p2_in = NULL;
+	TEE_Param *p2_in = NULL;
 	TEE_Param *p2_out = NULL;
-	TEE_Result res = TEE_ERROR_GENERIC;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
 
 	/* Param#0: none or in-out buffer with serialized arguments */
 	switch (TEE_PARAM_TYPE_GET(ptypes, 0)) {
@@ -121,9 +135,167 @@ TEE_Result TA_InvokeCommandEntryPoint(void *tee_session __unused, uint32_t cmd,
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
 
+	if (!client)
+		return TEE_ERROR_BAD_STATE;
+
+	if (cmd == PKCS11_CMD_PING) {
+		/* No output data stored in output param#0 */
+		if (ctrl)
+			ctrl->memref.size = 0;
+
+		return entry_ping(ctrl, p1_in, p2_out);
+	}
+
+	/* Other commands return their pkcs11_rc status in param#0 */
+	if (!ctrl || ctrl->memref.size < sizeof(uint32_t))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/* Only verification takes a secondary input buffer in param#2 */
+	if (p2_in && cmd != PKCS11_CMD_VERIFY_FINAL &&
+	    cmd != PKCS11_CMD_VERIFY_ONESHOT)
+		return TEE_ERROR_BAD_PARAMETERS;
+
 	switch (cmd) {
-	case PKCS11_CMD_PING:
-		res = entry_ping(ctrl, p1_in, p2_out);
+	case PKCS11_CMD_SLOT_LIST:
+		rc = entry_ck_slot_list(ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_SLOT_INFO:
+		rc = entry_ck_slot_info(ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_TOKEN_INFO:
+		rc = entry_ck_token_info(ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_MECHANISM_IDS:
+		rc = entry_ck_token_mecha_ids(ctrl, p1_in, p2_out);
+		break;
+
+	case PKCS11_CMD_OPEN_SESSION:
+		rc = entry_ck_open_session(client, ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_CLOSE_SESSION:
+		rc = entry_ck_close_session(client, ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_CLOSE_ALL_SESSIONS:
+		rc = entry_ck_close_all_sessions(client, ctrl, p1_in, p2_out);
+		break;
+
+	case PKCS11_CMD_CREATE_OBJECT:
+		rc = entry_create_object(client, ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_DESTROY_OBJECT:
+		rc = entry_destroy_object(client, ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_FIND_OBJECTS_INIT:
+		rc = entry_find_objects_init(client, ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_FIND_OBJECTS:
+		rc = entry_find_objects(client, ctrl, p1_in, p2_out);
+		break;
+	case PKCS11_CMD_FIND_OBJECTS_FINAL:
+		rc = entry_find_objects_final(client, ctrl, p1_in, p2_out);
+		break;
+
+	case PKCS11_CMD_ENCRYPT_INIT:
+		rc = entry_processing_init(client, ctrl, p1_in, p2_out,
+					   PKCS11_FUNCTION_ENCRYPT);
+		break;
+	case PKCS11_CMD_DECRYPT_INIT:
+		rc = entry_processing_init(client, ctrl, p1_in, p2_out,
+					   PKCS11_FUNCTION_DECRYPT);
+		break;
+	case PKCS11_CMD_DIGEST_INIT:
+		rc = entry_processing_init(client, ctrl, p1_in, p2_out,
+					   PKCS11_FUNCTION_DIGEST);
+		break;
+	case PKCS11_CMD_SIGN_INIT:
+		rc = entry_processing_init(client, ctrl, p1_in, p2_out,
+					   PKCS11_FUNCTION_SIGN);
+		break;
+	case PKCS11_CMD_VERIFY_INIT:
+		rc = entry_processing_init(client, ctrl, p1_in, p2_out,
+					   PKCS11_FUNCTION_VERIFY);
+		break;
+
+	case PKCS11_CMD_ENCRYPT_UPDATE:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_ENCRYPT,
+					   PKCS11_FUNC_STEP_UPDATE);
+		break;
+	case PKCS11_CMD_DECRYPT_UPDATE:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_DECRYPT,
+					   PKCS11_FUNC_STEP_UPDATE);
+		break;
+	case PKCS11_CMD_DIGEST_UPDATE:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_DIGEST,
+					   PKCS11_FUNC_STEP_UPDATE);
+		break;
+	case PKCS11_CMD_SIGN_UPDATE:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_SIGN,
+					   PKCS11_FUNC_STEP_UPDATE);
+		break;
+	case PKCS11_CMD_VERIFY_UPDATE:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_VERIFY,
+					   PKCS11_FUNC_STEP_UPDATE);
+		break;
+
+	case PKCS11_CMD_ENCRYPT_FINAL:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_ENCRYPT,
+					   PKCS11_FUNC_STEP_FINAL);
+		break;
+	case PKCS11_CMD_DECRYPT_FINAL:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_DECRYPT,
+					   PKCS11_FUNC_STEP_FINAL);
+		break;
+	case PKCS11_CMD_DIGEST_FINAL:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_DIGEST,
+					   PKCS11_FUNC_STEP_FINAL);
+		break;
+	case PKCS11_CMD_SIGN_FINAL:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_SIGN,
+					   PKCS11_FUNC_STEP_FINAL);
+		break;
+	case PKCS11_CMD_VERIFY_FINAL:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_VERIFY,
+					   PKCS11_FUNC_STEP_FINAL);
+		break;
+
+	case PKCS11_CMD_ENCRYPT_ONESHOT:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_ENCRYPT,
+					   PKCS11_FUNC_STEP_ONESHOT);
+		break;
+	case PKCS11_CMD_DECRYPT_ONESHOT:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_DECRYPT,
+					   PKCS11_FUNC_STEP_ONESHOT);
+		break;
+	case PKCS11_CMD_DIGEST_ONESHOT:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_DIGEST,
+					   PKCS11_FUNC_STEP_ONESHOT);
+		break;
+	case PKCS11_CMD_SIGN_ONESHOT:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_SIGN,
+					   PKCS11_FUNC_STEP_ONESHOT);
+		break;
+	case PKCS11_CMD_VERIFY_ONESHOT:
+		rc = entry_processing_step(client, ctrl, p1_in, p2_in, p2_out,
+					   PKCS11_FUNCTION_VERIFY,
+					   PKCS11_FUNC_STEP_ONESHOT);
+		break;
+
+	case PKCS11_CMD_SIGN_DIGESTS:
+		rc = entry_sign_digests(client, ctrl, p1_in, p2_out);
 		break;
 
 	default:
@@ -131,9 +303,12 @@ TEE_Result TA_InvokeCommandEntryPoint(void *tee_session __unused, uint32_t cmd,
 		return TEE_ERROR_NOT_SUPPORTED;
 	}
 
-	/* Currently no output data stored in output param#0 */
-	if (TEE_PARAM_TYPE_GET(ptypes, 0) == TEE_PARAM_TYPE_MEMREF_INOUT)
-		ctrl->memref.size = 0;
+	TEE_MemMove(ctrl->memref.buffer, &rc, sizeof(uint32_t));
+	ctrl->memref.size = sizeof(uint32_t);
 
-	return res;
+	/* Let the client get the size of the output data it shall provide */
+	if (rc == PKCS11_CKR_BUFFER_TOO_SMALL)
+		return TEE_ERROR_SHORT_BUFFER;
+
+	return TEE_SUCCESS;
 }
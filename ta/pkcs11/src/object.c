@@ -0,0 +1,601 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#include <pkcs11_ta.h>
+#include <string.h>
+#include <sys/queue.h>
+#include <tee_internal_api.h>
+#include <tee_internal_api_extensions.h>
+#include <util.h>
+
+#include "attributes.h"
+#include "handle.h"
+#include "object.h"
+#include "pkcs11_token.h"
+#include "processing.h"
+#include "serializer.h"
+
+/*
+ * Objects are indexed by a hash of each of their attributes, ID and
+ * value. A search looks up the bucket of the template attribute with the
+ * fewest entries and only compares the objects of that bucket against
+ * the template.
+ */
+#define OBJ_INDEX_BUCKETS	64
+
+struct obj_index_entry {
+	SLIST_ENTRY(obj_index_entry) link;
+	struct pkcs11_object *obj;
+	uint32_t hash;
+};
+
+struct obj_index_bucket {
+	SLIST_HEAD(, obj_index_entry) entries;
+	size_t count;
+};
+
+static struct obj_index_bucket obj_index[OBJ_INDEX_BUCKETS];
+
+static struct obj_index_bucket *hash2bucket(uint32_t hash)
+{
+	return obj_index + hash % OBJ_INDEX_BUCKETS;
+}
+
+static enum pkcs11_rc index_object(struct pkcs11_object *obj)
+{
+	uint32_t count = obj->attributes->attrs_count;
+	struct obj_index_bucket *bucket = NULL;
+	uint32_t *hashes = NULL;
+	uint32_t n = 0;
+
+	if (!count)
+		return PKCS11_CKR_OK;
+
+	obj->index = TEE_Malloc(count * sizeof(*obj->index),
+				TEE_MALLOC_FILL_ZERO);
+	hashes = TEE_Malloc(count * sizeof(*hashes), TEE_MALLOC_FILL_ZERO);
+	if (!obj->index || !hashes) {
+		TEE_Free(obj->index);
+		obj->index = NULL;
+		TEE_Free(hashes);
+		return PKCS11_CKR_DEVICE_MEMORY;
+	}
+
+	attributes_hash_each(obj->attributes, hashes);
+
+	for (n = 0; n < count; n++) {
+		obj->index[n].obj = obj;
+		obj->index[n].hash = hashes[n];
+		bucket = hash2bucket(hashes[n]);
+		SLIST_INSERT_HEAD(&bucket->entries, obj->index + n, link);
+		bucket->count++;
+	}
+
+	TEE_Free(hashes);
+
+	return PKCS11_CKR_OK;
+}
+
+static void unindex_object(struct pkcs11_object *obj)
+{
+	struct obj_index_bucket *bucket = NULL;
+	uint32_t n = 0;
+
+	if (!obj->index)
+		return;
+
+	for (n = 0; n < obj->attributes->attrs_count; n++) {
+		bucket = hash2bucket(obj->index[n].hash);
+		SLIST_REMOVE(&bucket->entries, obj->index + n, obj_index_entry,
+			     link);
+		bucket->count--;
+	}
+
+	TEE_Free(obj->index);
+	obj->index = NULL;
+}
+
+static bool object_is_visible(struct pkcs11_object *obj,
+			      struct pkcs11_session *session)
+{
+	return obj->token == session->token &&
+	       (!obj->session || obj->session == session);
+}
+
+struct pkcs11_object *pkcs11_handle2object(uint32_t handle,
+					   struct pkcs11_session *session)
+{
+	struct pkcs11_object *obj = NULL;
+
+	obj = handle_lookup(&session->token->object_handle_db, handle);
+	if (!obj || !object_is_visible(obj, session))
+		return NULL;
+
+	return obj;
+}
+
+static void destroy_object(struct pkcs11_object *obj)
+{
+	struct ck_token *token = obj->token;
+
+	/* Drop the operations of the sessions using the key */
+	token_for_each_session(token, release_key_operations, obj);
+
+	unindex_object(obj);
+	LIST_REMOVE(obj, link);
+	handle_put(&token->object_handle_db, obj->handle);
+
+	release_tee_key(obj);
+
+	/* Attributes may hold secret key material */
+	TEE_MemFill(obj->attributes, 0,
+		    sizeof(*obj->attributes) + obj->attributes->attrs_size);
+	TEE_Free(obj->attributes);
+	TEE_Free(obj);
+}
+
+void destroy_session_objects(struct pkcs11_session *session)
+{
+	struct pkcs11_object *obj = NULL;
+	struct pkcs11_object *next = NULL;
+
+	for (obj = LIST_FIRST(&session->token->object_list); obj; obj = next) {
+		next = LIST_NEXT(obj, link);
+		if (obj->session == session)
+			destroy_object(obj);
+	}
+}
+
+static enum pkcs11_rc require_attrs(struct obj_attrs *head,
+				    const uint32_t *ids, size_t count)
+{
+	size_t n = 0;
+
+	for (n = 0; n < count; n++)
+		if (get_attribute_ptr(head, ids[n], NULL, NULL))
+			return PKCS11_CKR_TEMPLATE_INCOMPLETE;
+
+	return PKCS11_CKR_OK;
+}
+
+/* Check the class and key type of a new object have their attributes */
+static enum pkcs11_rc check_created_attrs(struct obj_attrs *head,
+					  uint32_t *class, uint32_t *key_type)
+{
+	static const uint32_t rsa_pub[] = {
+		PKCS11_CKA_MODULUS, PKCS11_CKA_PUBLIC_EXPONENT,
+	};
+	static const uint32_t rsa_priv[] = {
+		PKCS11_CKA_MODULUS, PKCS11_CKA_PUBLIC_EXPONENT,
+		PKCS11_CKA_PRIVATE_EXPONENT,
+	};
+	static const uint32_t ec_pub[] = {
+		PKCS11_CKA_EC_PARAMS, PKCS11_CKA_EC_POINT,
+	};
+	/* TEE ECC key pairs need the public point too */
+	static const uint32_t ec_priv[] = {
+		PKCS11_CKA_EC_PARAMS, PKCS11_CKA_EC_POINT, PKCS11_CKA_VALUE,
+	};
+	static const uint32_t secret[] = { PKCS11_CKA_VALUE };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	rc = get_u32_attribute(head, PKCS11_CKA_CLASS, class);
+	if (rc == PKCS11_RV_NOT_FOUND)
+		return PKCS11_CKR_TEMPLATE_INCOMPLETE;
+	if (rc)
+		return rc;
+
+	if (*class == PKCS11_CKO_DATA) {
+		*key_type = PKCS11_CKK_UNDEFINED_ID;
+		return PKCS11_CKR_OK;
+	}
+
+	rc = get_u32_attribute(head, PKCS11_CKA_KEY_TYPE, key_type);
+	if (rc == PKCS11_RV_NOT_FOUND)
+		return PKCS11_CKR_TEMPLATE_INCOMPLETE;
+	if (rc)
+		return rc;
+
+	switch (*class) {
+	case PKCS11_CKO_SECRET_KEY:
+		if (*key_type != PKCS11_CKK_AES &&
+		    *key_type != PKCS11_CKK_GENERIC_SECRET)
+			return PKCS11_CKR_TEMPLATE_INCONSISTENT;
+		return require_attrs(head, secret, ARRAY_SIZE(secret));
+	case PKCS11_CKO_PUBLIC_KEY:
+		if (*key_type == PKCS11_CKK_RSA)
+			return require_attrs(head, rsa_pub,
+					     ARRAY_SIZE(rsa_pub));
+		if (*key_type == PKCS11_CKK_EC)
+			return require_attrs(head, ec_pub, ARRAY_SIZE(ec_pub));
+		return PKCS11_CKR_TEMPLATE_INCONSISTENT;
+	case PKCS11_CKO_PRIVATE_KEY:
+		if (*key_type == PKCS11_CKK_RSA)
+			return require_attrs(head, rsa_priv,
+					     ARRAY_SIZE(rsa_priv));
+		if (*key_type == PKCS11_CKK_EC)
+			return require_attrs(head, ec_priv,
+					     ARRAY_SIZE(ec_priv));
+		return PKCS11_CKR_TEMPLATE_INCONSISTENT;
+	default:
+		return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+	}
+}
+
+static enum pkcs11_rc get_ctrl_session(struct pkcs11_client *client,
+				       struct serialargs *ctrlargs,
+				       struct pkcs11_session **session)
+{
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t session_handle = 0;
+
+	rc = serialargs_get_u32(ctrlargs, &session_handle);
+	if (rc)
+		return rc;
+
+	*session = pkcs11_handle2session(session_handle, client);
+	if (!*session)
+		return PKCS11_CKR_SESSION_HANDLE_INVALID;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc entry_create_object(struct pkcs11_client *client,
+				   TEE_Param *ctrl, TEE_Param *in,
+				   TEE_Param *out)
+{
+	struct pkcs11_session *session = NULL;
+	struct obj_attrs *head = NULL;
+	struct pkcs11_object *obj = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t key_type = 0;
+	uint32_t class = 0;
+
+	if (!client || !ctrl || in || !out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	if (out->memref.size < sizeof(uint32_t)) {
+		out->memref.size = sizeof(uint32_t);
+		return PKCS11_CKR_BUFFER_TOO_SMALL;
+	}
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	rc = serialargs_alloc_get_attributes(&ctrlargs,
+					     (struct pkcs11_object_head **)
+					     &head);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs)) {
+		rc = PKCS11_CKR_ARGUMENTS_BAD;
+		goto out;
+	}
+
+	rc = check_attrs_format(head);
+	if (rc)
+		goto out;
+
+	rc = check_created_attrs(head, &class, &key_type);
+	if (rc)
+		goto out;
+
+	if (get_bool(head, PKCS11_CKA_TOKEN) && !session->rw) {
+		rc = PKCS11_CKR_SESSION_READ_ONLY;
+		goto out;
+	}
+
+	obj = TEE_Malloc(sizeof(*obj), TEE_MALLOC_FILL_ZERO);
+	if (!obj) {
+		rc = PKCS11_CKR_DEVICE_MEMORY;
+		goto out;
+	}
+
+	obj->attributes = head;
+	obj->token = session->token;
+	if (!get_bool(head, PKCS11_CKA_TOKEN))
+		obj->session = session;
+	obj->class = class;
+	obj->key_type = key_type;
+	obj->key_handle = TEE_HANDLE_NULL;
+
+	if (class != PKCS11_CKO_DATA) {
+		rc = load_tee_key(obj);
+		if (rc)
+			goto out;
+	}
+
+	rc = index_object(obj);
+	if (rc)
+		goto out;
+
+	obj->handle = handle_get(&obj->token->object_handle_db, obj);
+	if (!obj->handle) {
+		unindex_object(obj);
+		rc = PKCS11_CKR_DEVICE_MEMORY;
+		goto out;
+	}
+
+	LIST_INSERT_HEAD(&obj->token->object_list, obj, link);
+
+	TEE_MemMove(out->memref.buffer, &obj->handle, sizeof(obj->handle));
+	out->memref.size = sizeof(obj->handle);
+
+	DMSG("PKCS11 session %"PRIu32": create object %#"PRIx32,
+	     session->handle, obj->handle);
+
+	return PKCS11_CKR_OK;
+
+out:
+	if (obj)
+		release_tee_key(obj);
+	TEE_Free(obj);
+	TEE_MemFill(head, 0, sizeof(*head) + head->attrs_size);
+	TEE_Free(head);
+
+	return rc;
+}
+
+enum pkcs11_rc entry_destroy_object(struct pkcs11_client *client,
+				    TEE_Param *ctrl, TEE_Param *in,
+				    TEE_Param *out)
+{
+	struct pkcs11_session *session = NULL;
+	struct pkcs11_object *obj = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t object_handle = 0;
+
+	if (!client || !ctrl || in || out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	rc = serialargs_get_u32(&ctrlargs, &object_handle);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	obj = pkcs11_handle2object(object_handle, session);
+	if (!obj)
+		return PKCS11_CKR_OBJECT_HANDLE_INVALID;
+
+	if (!obj->session && !session->rw)
+		return PKCS11_CKR_SESSION_READ_ONLY;
+
+	destroy_object(obj);
+
+	DMSG("PKCS11 session %"PRIu32": destroy object %#"PRIx32,
+	     session->handle, object_handle);
+
+	return PKCS11_CKR_OK;
+}
+
+void release_find_obj_context(struct pkcs11_session *session)
+{
+	struct pkcs11_find_objects *find_ctx = session->find_ctx;
+
+	if (!find_ctx)
+		return;
+
+	TEE_Free(find_ctx->handles);
+	TEE_Free(find_ctx);
+	session->find_ctx = NULL;
+}
+
+static enum pkcs11_rc find_ctx_add(struct pkcs11_find_objects *find_ctx,
+				   uint32_t handle)
+{
+	uint32_t *handles = NULL;
+	size_t max_count = 0;
+
+	if (find_ctx->count == find_ctx->max_count) {
+		max_count = MAX(find_ctx->max_count * 2, 4U);
+		handles = TEE_Realloc(find_ctx->handles,
+				      max_count * sizeof(*handles));
+		if (!handles)
+			return PKCS11_CKR_DEVICE_MEMORY;
+
+		find_ctx->handles = handles;
+		find_ctx->max_count = max_count;
+	}
+
+	find_ctx->handles[find_ctx->count++] = handle;
+
+	return PKCS11_CKR_OK;
+}
+
+/* Collect the handles of the objects matching @tmpl in @find_ctx */
+static enum pkcs11_rc
+find_matching_objects(struct pkcs11_session *session, struct obj_attrs *tmpl,
+		      struct pkcs11_find_objects *find_ctx)
+{
+	struct obj_index_bucket *bucket = NULL;
+	struct obj_index_bucket *best = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	struct obj_index_entry *e = NULL;
+	struct pkcs11_object *obj = NULL;
+	uint32_t *hashes = NULL;
+	uint32_t best_hash = 0;
+	uint32_t n = 0;
+
+	if (!tmpl->attrs_count) {
+		LIST_FOREACH(obj, &session->token->object_list, link) {
+			if (!object_is_visible(obj, session))
+				continue;
+			rc = find_ctx_add(find_ctx, obj->handle);
+			if (rc)
+				return rc;
+		}
+		return PKCS11_CKR_OK;
+	}
+
+	hashes = TEE_Malloc(tmpl->attrs_count * sizeof(*hashes),
+			    TEE_MALLOC_FILL_ZERO);
+	if (!hashes)
+		return PKCS11_CKR_DEVICE_MEMORY;
+
+	attributes_hash_each(tmpl, hashes);
+
+	/* The smallest bucket holds every match, pick it */
+	for (n = 0; n < tmpl->attrs_count; n++) {
+		bucket = hash2bucket(hashes[n]);
+		if (!best || bucket->count < best->count) {
+			best = bucket;
+			best_hash = hashes[n];
+		}
+	}
+
+	TEE_Free(hashes);
+
+	SLIST_FOREACH(e, &best->entries, link) {
+		if (e->hash != best_hash ||
+		    !object_is_visible(e->obj, session) ||
+		    !attributes_match_reference(e->obj->attributes, tmpl))
+			continue;
+
+		rc = find_ctx_add(find_ctx, e->obj->handle);
+		if (rc)
+			return rc;
+	}
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
+				       TEE_Param *ctrl, TEE_Param *in,
+				       TEE_Param *out)
+{
+	struct pkcs11_find_objects *find_ctx = NULL;
+	struct pkcs11_session *session = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	struct obj_attrs *tmpl = NULL;
+
+	if (!client || !ctrl || in || out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	rc = serialargs_alloc_get_attributes(&ctrlargs,
+					     (struct pkcs11_object_head **)
+					     &tmpl);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs)) {
+		rc = PKCS11_CKR_ARGUMENTS_BAD;
+		goto out;
+	}
+
+	if (session->find_ctx) {
+		rc = PKCS11_CKR_OPERATION_ACTIVE;
+		goto out;
+	}
+
+	rc = check_attrs_format(tmpl);
+	if (rc)
+		goto out;
+
+	find_ctx = TEE_Malloc(sizeof(*find_ctx), TEE_MALLOC_FILL_ZERO);
+	if (!find_ctx) {
+		rc = PKCS11_CKR_DEVICE_MEMORY;
+		goto out;
+	}
+
+	rc = find_matching_objects(session, tmpl, find_ctx);
+	if (rc) {
+		TEE_Free(find_ctx->handles);
+		TEE_Free(find_ctx);
+		goto out;
+	}
+
+	session->find_ctx = find_ctx;
+
+out:
+	TEE_Free(tmpl);
+
+	return rc;
+}
+
+enum pkcs11_rc entry_find_objects(struct pkcs11_client *client,
+				  TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out)
+{
+	struct pkcs11_find_objects *find_ctx = NULL;
+	struct pkcs11_session *session = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	size_t count = 0;
+
+	if (!client || !ctrl || in || !out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	find_ctx = session->find_ctx;
+	if (!find_ctx)
+		return PKCS11_CKR_OPERATION_NOT_INITIALIZED;
+
+	count = MIN(out->memref.size / sizeof(uint32_t),
+		    find_ctx->count - find_ctx->next);
+
+	TEE_MemMove(out->memref.buffer, find_ctx->handles + find_ctx->next,
+		    count * sizeof(uint32_t));
+	out->memref.size = count * sizeof(uint32_t);
+	find_ctx->next += count;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc entry_find_objects_final(struct pkcs11_client *client,
+					TEE_Param *ctrl, TEE_Param *in,
+					TEE_Param *out)
+{
+	struct pkcs11_session *session = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	if (!client || !ctrl || in || out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	if (!session->find_ctx)
+		return PKCS11_CKR_OPERATION_NOT_INITIALIZED;
+
+	release_find_obj_context(session);
+
+	return PKCS11_CKR_OK;
+}
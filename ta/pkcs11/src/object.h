@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#ifndef PKCS11_TA_OBJECT_H
+#define PKCS11_TA_OBJECT_H
+
+#include <pkcs11_ta.h>
+#include <sys/queue.h>
+#include <tee_internal_api.h>
+
+struct ck_token;
+struct obj_attrs;
+struct obj_index_entry;
+struct pkcs11_client;
+struct pkcs11_session;
+
+/*
+ * link: objects are referenced in a double-linked list
+ * attributes: serialized attributes of the object
+ * token: token the object belongs to
+ * session: session owning a session object or NULL for a token object
+ * handle: object handle published to the clients
+ * class: value of the PKCS11_CKA_CLASS attribute
+ * key_type: value of the PKCS11_CKA_KEY_TYPE attribute of a key
+ * key_handle: TEE object holding the key of a key object
+ * key_size: size in bits of the key in @key_handle
+ * index: entries of the object in the attribute index, one per attribute
+ */
+struct pkcs11_object {
+	LIST_ENTRY(pkcs11_object) link;
+	struct obj_attrs *attributes;
+	struct ck_token *token;
+	struct pkcs11_session *session;
+	uint32_t handle;
+	uint32_t class;
+	uint32_t key_type;
+	TEE_ObjectHandle key_handle;
+	uint32_t key_size;
+	struct obj_index_entry *index;
+};
+
+LIST_HEAD(object_list, pkcs11_object);
+
+struct pkcs11_object *pkcs11_handle2object(uint32_t handle,
+					   struct pkcs11_session *session);
+
+/* Destroy the session objects of @session */
+void destroy_session_objects(struct pkcs11_session *session);
+
+/* Release the search context of @session if any */
+void release_find_obj_context(struct pkcs11_session *session);
+
+/*
+ * Entry function called from the PKCS11 command parser
+ */
+enum pkcs11_rc entry_create_object(struct pkcs11_client *client,
+				   TEE_Param *ctrl, TEE_Param *in,
+				   TEE_Param *out);
+
+enum pkcs11_rc entry_destroy_object(struct pkcs11_client *client,
+				    TEE_Param *ctrl, TEE_Param *in,
+				    TEE_Param *out);
+
+enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
+				       TEE_Param *ctrl, TEE_Param *in,
+				       TEE_Param *out);
+
+enum pkcs11_rc entry_find_objects(struct pkcs11_client *client,
+				  TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out);
+
+enum pkcs11_rc entry_find_objects_final(struct pkcs11_client *client,
+					TEE_Param *ctrl, TEE_Param *in,
+					TEE_Param *out);
+
+#endif /*PKCS11_TA_OBJECT_H*/
@@ -0,0 +1,426 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#include <pkcs11_ta.h>
+#include <string.h>
+#include <sys/queue.h>
+#include <tee_internal_api.h>
+#include <tee_internal_api_extensions.h>
+#include <util.h>
+
+#include "handle.h"
+#include "object.h"
+#include "pkcs11_token.h"
+#include "processing.h"
+#include "serializer.h"
+
+/* Static allocation of tokens runtime instances (reset to 0 at load) */
+static struct ck_token ck_token[TOKEN_COUNT];
+
+static TAILQ_HEAD(client_list, pkcs11_client) pkcs11_client_list =
+	TAILQ_HEAD_INITIALIZER(pkcs11_client_list);
+
+struct ck_token *get_token(unsigned int token_id)
+{
+	if (token_id < TOKEN_COUNT)
+		return &ck_token[token_id];
+
+	return NULL;
+}
+
+struct pkcs11_client *tee_session2client(void *tee_session)
+{
+	struct pkcs11_client *client = NULL;
+
+	TAILQ_FOREACH(client, &pkcs11_client_list, link)
+		if (client == tee_session)
+			break;
+
+	return client;
+}
+
+struct pkcs11_session *pkcs11_handle2session(uint32_t handle,
+					     struct pkcs11_client *client)
+{
+	return handle_lookup(&client->session_handle_db, handle);
+}
+
+struct pkcs11_client *register_client(void)
+{
+	struct pkcs11_client *client = NULL;
+
+	client = TEE_Malloc(sizeof(*client), TEE_MALLOC_FILL_ZERO);
+	if (!client)
+		return NULL;
+
+	TAILQ_INSERT_HEAD(&pkcs11_client_list, client, link);
+	TAILQ_INIT(&client->session_list);
+	client->session_handle_db = (struct handle_db)HANDLE_DB_INITIALIZER;
+
+	return client;
+}
+
+static void close_ck_session(struct pkcs11_session *session)
+{
+	release_active_processing(session);
+	release_operation_cache(session);
+	release_find_obj_context(session);
+	destroy_session_objects(session);
+
+	TAILQ_REMOVE(&session->client->session_list, session, link);
+	handle_put(&session->client->session_handle_db, session->handle);
+
+	session->token->session_count--;
+	if (session->rw)
+		session->token->rw_session_count--;
+
+	TEE_Free(session);
+}
+
+void unregister_client(struct pkcs11_client *client)
+{
+	struct pkcs11_session *session = NULL;
+	struct pkcs11_session *next = NULL;
+
+	if (!client) {
+		EMSG("Invalid TEE session handle");
+		return;
+	}
+
+	TAILQ_FOREACH_SAFE(session, &client->session_list, link, next)
+		close_ck_session(session);
+
+	TAILQ_REMOVE(&pkcs11_client_list, client, link);
+	handle_db_destroy(&client->session_handle_db);
+	TEE_Free(client);
+}
+
+void token_for_each_session(struct ck_token *token,
+			    void (*cb)(struct pkcs11_session *session,
+				       void *arg),
+			    void *arg)
+{
+	struct pkcs11_session *session = NULL;
+	struct pkcs11_client *client = NULL;
+
+	TAILQ_FOREACH(client, &pkcs11_client_list, link)
+		TAILQ_FOREACH(session, &client->session_list, link)
+			if (session->token == token)
+				cb(session, arg);
+}
+
+TEE_Result pkcs11_init(void)
+{
+	unsigned int id = 0;
+
+	for (id = 0; id < TOKEN_COUNT; id++) {
+		LIST_INIT(&ck_token[id].object_list);
+		ck_token[id].object_handle_db =
+			(struct handle_db)HANDLE_DB_INITIALIZER;
+	}
+
+	return TEE_SUCCESS;
+}
+
+void pkcs11_deinit(void)
+{
+	unsigned int id = 0;
+
+	for (id = 0; id < TOKEN_COUNT; id++)
+		handle_db_destroy(&ck_token[id].object_handle_db);
+}
+
+/* Copy @src to the blank padded fixed size field @dst */
+static void pad_str(uint8_t *dst, size_t dst_size, const char *src)
+{
+	size_t len = MIN(strlen(src), dst_size);
+
+	TEE_MemFill(dst, ' ', dst_size);
+	TEE_MemMove(dst, src, len);
+}
+
+static enum pkcs11_rc get_ctrl_token(TEE_Param *ctrl,
+				     struct ck_token **token)
+{
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t token_id = 0;
+
+	if (!ctrl)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = serialargs_get_u32(&ctrlargs, &token_id);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	*token = get_token(token_id);
+	if (!*token)
+		return PKCS11_CKR_SLOT_ID_INVALID;
+
+	return PKCS11_CKR_OK;
+}
+
+/* Copy @size bytes of @data to @out, updating the size of @out */
+static enum pkcs11_rc put_out(TEE_Param *out, const void *data, size_t size)
+{
+	size_t out_size = 0;
+
+	if (!out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	out_size = out->memref.size;
+	out->memref.size = size;
+	if (out_size < size)
+		return PKCS11_CKR_BUFFER_TOO_SMALL;
+
+	TEE_MemMove(out->memref.buffer, data, size);
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc entry_ck_slot_list(TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out)
+{
+	struct serialargs ctrlargs = { };
+	uint32_t ids[TOKEN_COUNT] = { };
+	unsigned int n = 0;
+
+	if (!ctrl || in || ctrl->memref.size < sizeof(uint32_t))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	/* No arguments, @ctrl only has room for the returned status */
+	serialargs_init(&ctrlargs, ctrl->memref.buffer,
+			ctrl->memref.size - sizeof(uint32_t));
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	for (n = 0; n < TOKEN_COUNT; n++)
+		ids[n] = n;
+
+	return put_out(out, ids, sizeof(ids));
+}
+
+enum pkcs11_rc entry_ck_slot_info(TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out)
+{
+	struct pkcs11_slot_info info = {
+		.flags = PKCS11_CKFS_TOKEN_PRESENT,
+		.hardware_version = PKCS11_SLOT_HW_VERSION,
+		.firmware_version = PKCS11_SLOT_FW_VERSION,
+	};
+	struct ck_token *token = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	if (in)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	rc = get_ctrl_token(ctrl, &token);
+	if (rc)
+		return rc;
+
+	pad_str(info.slot_description, sizeof(info.slot_description),
+		PKCS11_SLOT_DESCRIPTION);
+	pad_str(info.manufacturer_id, sizeof(info.manufacturer_id),
+		PKCS11_SLOT_MANUFACTURER);
+
+	return put_out(out, &info, sizeof(info));
+}
+
+enum pkcs11_rc entry_ck_token_info(TEE_Param *ctrl, TEE_Param *in,
+				   TEE_Param *out)
+{
+	struct pkcs11_token_info info = {
+		.flags = PKCS11_CKFT_RNG | PKCS11_CKFT_TOKEN_INITIALIZED,
+		.max_session_count = UINT32_MAX,
+		.max_rw_session_count = UINT32_MAX,
+		.total_public_memory = PKCS11_UNAVAILABLE_INFORMATION,
+		.free_public_memory = PKCS11_UNAVAILABLE_INFORMATION,
+		.total_private_memory = PKCS11_UNAVAILABLE_INFORMATION,
+		.free_private_memory = PKCS11_UNAVAILABLE_INFORMATION,
+		.hardware_version = PKCS11_TOKEN_HW_VERSION,
+		.firmware_version = PKCS11_TOKEN_FW_VERSION,
+	};
+	struct ck_token *token = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	if (in)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	rc = get_ctrl_token(ctrl, &token);
+	if (rc)
+		return rc;
+
+	pad_str(info.label, sizeof(info.label), PKCS11_TOKEN_LABEL);
+	pad_str(info.manufacturer_id, sizeof(info.manufacturer_id),
+		PKCS11_TOKEN_MANUFACTURER);
+	pad_str(info.model, sizeof(info.model), PKCS11_TOKEN_MODEL);
+	pad_str(info.serial_number, sizeof(info.serial_number),
+		PKCS11_TOKEN_SERIAL_NUMBER);
+
+	info.session_count = token->session_count;
+	info.rw_session_count = token->rw_session_count;
+
+	return put_out(out, &info, sizeof(info));
+}
+
+enum pkcs11_rc entry_ck_token_mecha_ids(TEE_Param *ctrl, TEE_Param *in,
+					TEE_Param *out)
+{
+	struct ck_token *token = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t *ids = NULL;
+	size_t count = 0;
+
+	if (in)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	rc = get_ctrl_token(ctrl, &token);
+	if (rc)
+		return rc;
+
+	count = get_supported_mechanisms(NULL, 0);
+	ids = TEE_Malloc(count * sizeof(*ids), TEE_MALLOC_FILL_ZERO);
+	if (!ids)
+		return PKCS11_CKR_DEVICE_MEMORY;
+
+	get_supported_mechanisms(ids, count);
+	rc = put_out(out, ids, count * sizeof(*ids));
+
+	TEE_Free(ids);
+
+	return rc;
+}
+
+enum pkcs11_rc entry_ck_open_session(struct pkcs11_client *client,
+				     TEE_Param *ctrl, TEE_Param *in,
+				     TEE_Param *out)
+{
+	struct pkcs11_session *session = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	struct ck_token *token = NULL;
+	uint32_t token_id = 0;
+	uint32_t flags = 0;
+
+	if (!client || !ctrl || in || !out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	if (out->memref.size < sizeof(uint32_t)) {
+		out->memref.size = sizeof(uint32_t);
+		return PKCS11_CKR_BUFFER_TOO_SMALL;
+	}
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = serialargs_get_u32(&ctrlargs, &token_id);
+	if (rc)
+		return rc;
+
+	rc = serialargs_get_u32(&ctrlargs, &flags);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	token = get_token(token_id);
+	if (!token)
+		return PKCS11_CKR_SLOT_ID_INVALID;
+
+	/* Sessions are always serial */
+	if (!(flags & PKCS11_CKFSS_SERIAL_SESSION))
+		return PKCS11_CKR_SESSION_PARALLEL_NOT_SUPPORTED;
+
+	if (flags & ~(PKCS11_CKFSS_RW_SESSION | PKCS11_CKFSS_SERIAL_SESSION))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	session = TEE_Malloc(sizeof(*session), TEE_MALLOC_FILL_ZERO);
+	if (!session)
+		return PKCS11_CKR_DEVICE_MEMORY;
+
+	session->handle = handle_get(&client->session_handle_db, session);
+	if (!session->handle) {
+		TEE_Free(session);
+		return PKCS11_CKR_DEVICE_MEMORY;
+	}
+
+	session->token = token;
+	session->client = client;
+	session->rw = flags & PKCS11_CKFSS_RW_SESSION;
+
+	token->session_count++;
+	if (session->rw)
+		token->rw_session_count++;
+
+	TAILQ_INSERT_HEAD(&client->session_list, session, link);
+
+	TEE_MemMove(out->memref.buffer, &session->handle,
+		    sizeof(session->handle));
+	out->memref.size = sizeof(session->handle);
+
+	DMSG("Open PKCS11 session %"PRIu32, session->handle);
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc entry_ck_close_session(struct pkcs11_client *client,
+				      TEE_Param *ctrl, TEE_Param *in,
+				      TEE_Param *out)
+{
+	struct pkcs11_session *session = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t session_handle = 0;
+
+	if (!client || !ctrl || in || out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = serialargs_get_u32(&ctrlargs, &session_handle);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	session = pkcs11_handle2session(session_handle, client);
+	if (!session)
+		return PKCS11_CKR_SESSION_HANDLE_INVALID;
+
+	close_ck_session(session);
+
+	DMSG("Close PKCS11 session %"PRIu32, session_handle);
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc entry_ck_close_all_sessions(struct pkcs11_client *client,
+					   TEE_Param *ctrl, TEE_Param *in,
+					   TEE_Param *out)
+{
+	struct pkcs11_session *session = NULL;
+	struct pkcs11_session *next = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	struct ck_token *token = NULL;
+
+	if (!client || in || out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	rc = get_ctrl_token(ctrl, &token);
+	if (rc)
+		return rc;
+
+	TAILQ_FOREACH_SAFE(session, &client->session_list, link, next)
+		if (session->token == token)
+			close_ck_session(session);
+
+	return PKCS11_CKR_OK;
+}
@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+#ifndef PKCS11_TA_PKCS11_TOKEN_H
+#define PKCS11_TA_PKCS11_TOKEN_H
+
+#include <sys/queue.h>
+#include <tee_internal_api.h>
+
+#include "handle.h"
+#include "object.h"
+
+/* Hard coded description */
+#define PKCS11_SLOT_DESCRIPTION		"OP-TEE PKCS11 TA"
+#define PKCS11_SLOT_MANUFACTURER	"Linaro"
+#define PKCS11_SLOT_HW_VERSION		{ 0, 0 }
+#define PKCS11_SLOT_FW_VERSION		{ PKCS11_TA_VERSION_MAJOR, \
+					  PKCS11_TA_VERSION_MINOR }
+
+#define PKCS11_TOKEN_LABEL		"OP-TEE PKCS#11 TA token"
+#define PKCS11_TOKEN_MANUFACTURER	PKCS11_SLOT_MANUFACTURER
+#define PKCS11_TOKEN_MODEL		"OP-TEE TA"
+#define PKCS11_TOKEN_SERIAL_NUMBER	"0000000000000000"
+#define PKCS11_TOKEN_HW_VERSION		PKCS11_SLOT_HW_VERSION
+#define PKCS11_TOKEN_FW_VERSION		PKCS11_SLOT_FW_VERSION
+
+/* Number of token (and slot) instances */
+#define TOKEN_COUNT			1
+
+/* Number of TEE operations a session keeps for reuse */
+#define PKCS11_SESSION_OP_CACHE_SIZE	4
+
+enum processing_func {
+	PKCS11_FUNCTION_ENCRYPT,
+	PKCS11_FUNCTION_DECRYPT,
+	PKCS11_FUNCTION_DIGEST,
+	PKCS11_FUNCTION_SIGN,
+	PKCS11_FUNCTION_VERIFY,
+};
+
+enum processing_step {
+	PKCS11_FUNC_STEP_INIT,
+	PKCS11_FUNC_STEP_ONESHOT,
+	PKCS11_FUNC_STEP_UPDATE,
+	PKCS11_FUNC_STEP_FINAL,
+};
+
+/*
+ * Structure tracking the PKCS#11 token
+ *
+ * @object_list - Objects of the token and of its sessions
+ * @object_handle_db - Database for object handles of the token
+ * @session_count - Counter for opened sessions
+ * @rw_session_count - Count for opened read/write sessions
+ */
+struct ck_token {
+	struct object_list object_list;
+	struct handle_db object_handle_db;
+	uint32_t session_count;
+	uint32_t rw_session_count;
+};
+
+/*
+ * Structure tracking client applications
+ *
+ * @link - chained list of registered client applications
+ * @sessions - list of the PKCS11 sessions opened by the client application
+ * @session_handle_db - Database for session handles used by the client
+ */
+struct pkcs11_client {
+	TAILQ_ENTRY(pkcs11_client) link;
+	TAILQ_HEAD(session_list, pkcs11_session) session_list;
+	struct handle_db session_handle_db;
+};
+
+/*
+ * A TEE operation set up for a key and a mechanism
+ *
+ * @key - The key object or NULL for a digest
+ * @mecha_type - Mechanism the operation is set up for
+ * @function - Processing function the operation is set up for
+ * @tee_op_handle - TEE operation handle
+ * @tee_hash_op_handle - TEE digest operation for mechanisms hashing the
+ *			 data before signing
+ */
+struct pkcs11_operation {
+	struct pkcs11_object *key;
+	uint32_t mecha_type;
+	enum processing_func function;
+	TEE_OperationHandle tee_op_handle;
+	TEE_OperationHandle tee_hash_op_handle;
+};
+
+/*
+ * Processing state of an active operation of a session
+ *
+ * @op - The TEE operation in use
+ * @updated - True once data has been processed
+ * @in_size - Byte size of the data processed so far
+ */
+struct active_processing {
+	struct pkcs11_operation op;
+	bool updated;
+	size_t in_size;
+};
+
+/*
+ * Pkcs11 objects search context
+ *
+ * @handles - Handles of the matching objects
+ * @count - Number of handles in @handles
+ * @max_count - Number of handles @handles can hold
+ * @next - Index of the next handle to return
+ */
+struct pkcs11_find_objects {
+	uint32_t *handles;
+	size_t count;
+	size_t max_count;
+	size_t next;
+};
+
+/*
+ * Structure tracking the PKCS#11 sessions
+ *
+ * @link - List of the session belonging to a client
+ * @client - Client registering the session
+ * @token - Token this session belongs to
+ * @handle - Identifier of the session published to the client
+ * @rw - True for a read/write session
+ * @find_ctx - Active object search or NULL
+ * @processing - Active processing or NULL
+ * @op_cache - Operations kept for reuse, most recently used first
+ * @op_cache_count - Number of operations in @op_cache
+ */
+struct pkcs11_session {
+	TAILQ_ENTRY(pkcs11_session) link;
+	struct pkcs11_client *client;
+	struct ck_token *token;
+	uint32_t handle;
+	bool rw;
+	struct pkcs11_find_objects *find_ctx;
+	struct active_processing *processing;
+	struct pkcs11_operation op_cache[PKCS11_SESSION_OP_CACHE_SIZE];
+	unsigned int op_cache_count;
+};
+
+/* Initialize static token instance(s) */
+TEE_Result pkcs11_init(void);
+void pkcs11_deinit(void);
+
+/* Lookup of token instance from token identifier */
+struct ck_token *get_token(unsigned int token_id);
+
+/* Client registration */
+struct pkcs11_client *register_client(void);
+void unregister_client(struct pkcs11_client *client);
+
+/* Return client instance from its TEE session context */
+struct pkcs11_client *tee_session2client(void *tee_session);
+
+/* Return a session from its handle and client */
+struct pkcs11_session *pkcs11_handle2session(uint32_t handle,
+					     struct pkcs11_client *client);
+
+/* Call each session of the token, used when an object is destroyed */
+void token_for_each_session(struct ck_token *token,
+			    void (*cb)(struct pkcs11_session *session,
+				       void *arg),
+			    void *arg);
+
+/* Entry point for the TA commands */
+enum pkcs11_rc entry_ck_slot_list(TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out);
+enum pkcs11_rc entry_ck_slot_info(TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out);
+enum pkcs11_rc entry_ck_token_info(TEE_Param *ctrl, TEE_Param *in,
+				   TEE_Param *out);
+enum pkcs11_rc entry_ck_token_mecha_ids(TEE_Param *ctrl, TEE_Param *in,
+					TEE_Param *out);
+
+enum pkcs11_rc entry_ck_open_session(struct pkcs11_client *client,
+				     TEE_Param *ctrl, TEE_Param *in,
+				     TEE_Param *out);
+enum pkcs11_rc entry_ck_close_session(struct pkcs11_client *client,
+				      TEE_Param *ctrl, TEE_Param *in,
+				      TEE_Param *out);
+enum pkcs11_rc entry_ck_close_all_sessions(struct pkcs11_client *client,
+					   TEE_Param *ctrl, TEE_Param *in,
+					   TEE_Param *out);
+
+#endif /*PKCS11_TA_PKCS11_TOKEN_H*/
@@ -0,0 +1,1106 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#include <assert.h>
+#include <pkcs11_ta.h>
+#include <string.h>
+#include <tee_internal_api.h>
+#include <tee_internal_api_extensions.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "attributes.h"
+#include "object.h"
+#include "pkcs11_token.h"
+#include "processing.h"
+#include "serializer.h"
+
+/* Largest digest accepted by PKCS11_CKM_ECDSA */
+#define ECDSA_MAX_DIGEST_SIZE	TEE_MAX_HASH_SIZE
+
+/*
+ * struct pkcs11_mechanism - a supported mechanism
+ * @id:			PKCS11_CKM_* mechanism ID
+ * @funcs:		Bit mask of the supported enum processing_func
+ * @key_type:		Type of the key used, PKCS11_CKK_*
+ * @tee_algo:		TEE algorithm, 0 if it depends on the key (ECDSA)
+ * @tee_hash_algo:	TEE digest of the data signed or 0
+ * @digest_size:	Byte size of the digest signed or 0
+ */
+struct pkcs11_mechanism {
+	uint32_t id;
+	uint32_t funcs;
+	uint32_t key_type;
+	uint32_t tee_algo;
+	uint32_t tee_hash_algo;
+	size_t digest_size;
+};
+
+#define FUNC_BIT(func)		BIT(PKCS11_FUNCTION_ ## func)
+#define CIPHER_FUNCS		(FUNC_BIT(ENCRYPT) | FUNC_BIT(DECRYPT))
+#define SIGN_FUNCS		(FUNC_BIT(SIGN) | FUNC_BIT(VERIFY))
+
+static const struct pkcs11_mechanism mechanisms[] = {
+	{
+		.id = PKCS11_CKM_AES_ECB, .funcs = CIPHER_FUNCS,
+		.key_type = PKCS11_CKK_AES, .tee_algo = TEE_ALG_AES_ECB_NOPAD,
+	},
+	{
+		.id = PKCS11_CKM_AES_CBC, .funcs = CIPHER_FUNCS,
+		.key_type = PKCS11_CKK_AES, .tee_algo = TEE_ALG_AES_CBC_NOPAD,
+	},
+	{
+		.id = PKCS11_CKM_SHA_1, .funcs = FUNC_BIT(DIGEST),
+		.key_type = PKCS11_CKK_UNDEFINED_ID, .tee_algo = TEE_ALG_SHA1,
+	},
+	{
+		.id = PKCS11_CKM_SHA256, .funcs = FUNC_BIT(DIGEST),
+		.key_type = PKCS11_CKK_UNDEFINED_ID,
+		.tee_algo = TEE_ALG_SHA256,
+	},
+	{
+		.id = PKCS11_CKM_SHA384, .funcs = FUNC_BIT(DIGEST),
+		.key_type = PKCS11_CKK_UNDEFINED_ID,
+		.tee_algo = TEE_ALG_SHA384,
+	},
+	{
+		.id = PKCS11_CKM_SHA512, .funcs = FUNC_BIT(DIGEST),
+		.key_type = PKCS11_CKK_UNDEFINED_ID,
+		.tee_algo = TEE_ALG_SHA512,
+	},
+	{
+		.id = PKCS11_CKM_SHA256_HMAC, .funcs = SIGN_FUNCS,
+		.key_type = PKCS11_CKK_GENERIC_SECRET,
+		.tee_algo = TEE_ALG_HMAC_SHA256,
+	},
+	{
+		.id = PKCS11_CKM_SHA256_RSA_PKCS, .funcs = SIGN_FUNCS,
+		.key_type = PKCS11_CKK_RSA,
+		.tee_algo = TEE_ALG_RSASSA_PKCS1_V1_5_SHA256,
+		.tee_hash_algo = TEE_ALG_SHA256,
+		.digest_size = TEE_SHA256_HASH_SIZE,
+	},
+	{
+		.id = PKCS11_CKM_SHA384_RSA_PKCS, .funcs = SIGN_FUNCS,
+		.key_type = PKCS11_CKK_RSA,
+		.tee_algo = TEE_ALG_RSASSA_PKCS1_V1_5_SHA384,
+		.tee_hash_algo = TEE_ALG_SHA384,
+		.digest_size = TEE_SHA384_HASH_SIZE,
+	},
+	{
+		.id = PKCS11_CKM_SHA512_RSA_PKCS, .funcs = SIGN_FUNCS,
+		.key_type = PKCS11_CKK_RSA,
+		.tee_algo = TEE_ALG_RSASSA_PKCS1_V1_5_SHA512,
+		.tee_hash_algo = TEE_ALG_SHA512,
+		.digest_size = TEE_SHA512_HASH_SIZE,
+	},
+	{
+		.id = PKCS11_CKM_ECDSA, .funcs = SIGN_FUNCS,
+		.key_type = PKCS11_CKK_EC,
+	},
+};
+
+/*
+ * Supported EC curves, identified by the DER encoded OID in
+ * PKCS11_CKA_EC_PARAMS
+ */
+struct ec_curve {
+	const uint8_t *oid;
+	size_t oid_size;
+	uint32_t tee_curve;
+	uint32_t tee_algo;
+	uint32_t bits;
+};
+
+static const uint8_t oid_P192[] = {
+	0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x01,
+};
+static const uint8_t oid_P224[] = { 0x06, 0x05, 0x2b, 0x81, 0x04, 0x00, 0x21 };
+static const uint8_t oid_P256[] = {
+	0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07,
+};
+static const uint8_t oid_P384[] = { 0x06, 0x05, 0x2b, 0x81, 0x04, 0x00, 0x22 };
+static const uint8_t oid_P521[] = { 0x06, 0x05, 0x2b, 0x81, 0x04, 0x00, 0x23 };
+
+#define EC_CURVE(name, bits) { \
+		oid_ ## name, sizeof(oid_ ## name), \
+		TEE_ECC_CURVE_NIST_ ## name, TEE_ALG_ECDSA_ ## name, bits, \
+	}
+
+static const struct ec_curve ec_curves[] = {
+	EC_CURVE(P192, 192),
+	EC_CURVE(P224, 224),
+	EC_CURVE(P256, 256),
+	EC_CURVE(P384, 384),
+	EC_CURVE(P521, 521),
+};
+
+size_t get_supported_mechanisms(uint32_t *ids, size_t count)
+{
+	size_t n = 0;
+
+	for (n = 0; ids && n < MIN(count, ARRAY_SIZE(mechanisms)); n++)
+		ids[n] = mechanisms[n].id;
+
+	return ARRAY_SIZE(mechanisms);
+}
+
+static const struct pkcs11_mechanism *get_mechanism(uint32_t id)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(mechanisms); n++)
+		if (mechanisms[n].id == id)
+			return mechanisms + n;
+
+	return NULL;
+}
+
+static const struct ec_curve *get_ec_curve(struct obj_attrs *head)
+{
+	uint32_t size = 0;
+	void *oid = NULL;
+	size_t n = 0;
+
+	if (get_attribute_ptr(head, PKCS11_CKA_EC_PARAMS, &oid, &size))
+		return NULL;
+
+	for (n = 0; n < ARRAY_SIZE(ec_curves); n++)
+		if (size == ec_curves[n].oid_size &&
+		    !TEE_MemCompare(oid, ec_curves[n].oid, size))
+			return ec_curves + n;
+
+	return NULL;
+}
+
+static size_t ec_coord_size(const struct ec_curve *curve)
+{
+	return ROUNDUP(curve->bits, 8) / 8;
+}
+
+/*
+ * Get the coordinates from PKCS11_CKA_EC_POINT, an uncompressed point
+ * 0x04 || X || Y, either as is or DER encoded in an OCTET STRING.
+ */
+static enum pkcs11_rc get_ec_point(struct obj_attrs *head,
+				   const struct ec_curve *curve,
+				   uint8_t **x, uint8_t **y)
+{
+	size_t point_size = 1 + 2 * ec_coord_size(curve);
+	uint8_t *data = NULL;
+	uint32_t size = 0;
+	size_t hdr = 0;
+
+	if (get_attribute_ptr(head, PKCS11_CKA_EC_POINT, (void **)&data,
+			      &size))
+		return PKCS11_CKR_TEMPLATE_INCOMPLETE;
+
+	if (size != point_size) {
+		if (size < 2 || data[0] != 0x04)
+			return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+
+		if (data[1] < 0x80)
+			hdr = 2;
+		else if (data[1] == 0x81 && size > 2)
+			hdr = 3;
+		else
+			return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+
+		if (data[hdr - 1] != point_size || size != hdr + point_size)
+			return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+	}
+
+	data += hdr;
+	if (data[0] != 0x04)
+		return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+
+	*x = data + 1;
+	*y = data + 1 + ec_coord_size(curve);
+
+	return PKCS11_CKR_OK;
+}
+
+static uint32_t rsa_modulus_bits(const uint8_t *modulus, uint32_t size)
+{
+	while (size && !*modulus) {
+		modulus++;
+		size--;
+	}
+
+	if (!size)
+		return 0;
+
+	return size * 8 - (__builtin_clz(*modulus) - (32 - 8));
+}
+
+static enum pkcs11_rc add_ref_attr(TEE_Attribute *attrs, uint32_t *count,
+				   uint32_t tee_id, struct obj_attrs *head,
+				   uint32_t pkcs11_id)
+{
+	uint32_t size = 0;
+	void *data = NULL;
+
+	if (get_attribute_ptr(head, pkcs11_id, &data, &size))
+		return PKCS11_CKR_TEMPLATE_INCOMPLETE;
+
+	TEE_InitRefAttribute(attrs + *count, tee_id, data, size);
+	(*count)++;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc load_tee_key(struct pkcs11_object *obj)
+{
+	bool private = obj->class == PKCS11_CKO_PRIVATE_KEY;
+	struct obj_attrs *head = obj->attributes;
+	const struct ec_curve *curve = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	TEE_Attribute attrs[4] = { };
+	uint32_t tee_type = 0;
+	uint32_t count = 0;
+	uint32_t bits = 0;
+	uint8_t *x = NULL;
+	uint8_t *y = NULL;
+	void *data = NULL;
+	uint32_t size = 0;
+
+	switch (obj->key_type) {
+	case PKCS11_CKK_AES:
+		rc = add_ref_attr(attrs, &count, TEE_ATTR_SECRET_VALUE, head,
+				  PKCS11_CKA_VALUE);
+		if (rc)
+			return rc;
+		bits = attrs[0].content.ref.length * 8;
+		if (bits != 128 && bits != 192 && bits != 256)
+			return PKCS11_CKR_KEY_SIZE_RANGE;
+		tee_type = TEE_TYPE_AES;
+		break;
+	case PKCS11_CKK_GENERIC_SECRET:
+		/* Generic secrets are used for PKCS11_CKM_SHA256_HMAC */
+		rc = add_ref_attr(attrs, &count, TEE_ATTR_SECRET_VALUE, head,
+				  PKCS11_CKA_VALUE);
+		if (rc)
+			return rc;
+		bits = attrs[0].content.ref.length * 8;
+		if (bits < 192 || bits > 1024)
+			return PKCS11_CKR_KEY_SIZE_RANGE;
+		tee_type = TEE_TYPE_HMAC_SHA256;
+		break;
+	case PKCS11_CKK_RSA:
+		rc = add_ref_attr(attrs, &count, TEE_ATTR_RSA_MODULUS, head,
+				  PKCS11_CKA_MODULUS);
+		if (!rc)
+			rc = add_ref_attr(attrs, &count,
+					  TEE_ATTR_RSA_PUBLIC_EXPONENT, head,
+					  PKCS11_CKA_PUBLIC_EXPONENT);
+		if (!rc && private)
+			rc = add_ref_attr(attrs, &count,
+					  TEE_ATTR_RSA_PRIVATE_EXPONENT, head,
+					  PKCS11_CKA_PRIVATE_EXPONENT);
+		if (rc)
+			return rc;
+		bits = rsa_modulus_bits(attrs[0].content.ref.buffer,
+					attrs[0].content.ref.length);
+		tee_type = private ? TEE_TYPE_RSA_KEYPAIR :
+				     TEE_TYPE_RSA_PUBLIC_KEY;
+		break;
+	case PKCS11_CKK_EC:
+		curve = get_ec_curve(head);
+		if (!curve)
+			return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+		rc = get_ec_point(head, curve, &x, &y);
+		if (rc)
+			return rc;
+		TEE_InitRefAttribute(attrs + count++,
+				     TEE_ATTR_ECC_PUBLIC_VALUE_X, x,
+				     ec_coord_size(curve));
+		TEE_InitRefAttribute(attrs + count++,
+				     TEE_ATTR_ECC_PUBLIC_VALUE_Y, y,
+				     ec_coord_size(curve));
+		TEE_InitValueAttribute(attrs + count++, TEE_ATTR_ECC_CURVE,
+				       curve->tee_curve, 0);
+		if (private) {
+			if (get_attribute_ptr(head, PKCS11_CKA_VALUE, &data,
+					      &size))
+				return PKCS11_CKR_TEMPLATE_INCOMPLETE;
+			TEE_InitRefAttribute(attrs + count++,
+					     TEE_ATTR_ECC_PRIVATE_VALUE, data,
+					     size);
+		}
+		bits = curve->bits;
+		tee_type = private ? TEE_TYPE_ECDSA_KEYPAIR :
+				     TEE_TYPE_ECDSA_PUBLIC_KEY;
+		break;
+	default:
+		return PKCS11_CKR_KEY_TYPE_INCONSISTENT;
+	}
+
+	res = TEE_AllocateTransientObject(tee_type, bits, &obj->key_handle);
+	if (res == TEE_ERROR_OUT_OF_MEMORY)
+		return PKCS11_CKR_DEVICE_MEMORY;
+	if (res)
+		return PKCS11_CKR_KEY_SIZE_RANGE;
+
+	res = TEE_PopulateTransientObject(obj->key_handle, attrs, count);
+	if (res) {
+		release_tee_key(obj);
+		return PKCS11_CKR_ATTRIBUTE_VALUE_INVALID;
+	}
+
+	obj->key_size = bits;
+
+	return PKCS11_CKR_OK;
+}
+
+void release_tee_key(struct pkcs11_object *obj)
+{
+	TEE_FreeTransientObject(obj->key_handle);
+	obj->key_handle = TEE_HANDLE_NULL;
+}
+
+static bool is_mac(const struct pkcs11_mechanism *mech)
+{
+	return mech->key_type == PKCS11_CKK_GENERIC_SECRET;
+}
+
+static uint32_t tee_algo(const struct pkcs11_mechanism *mech,
+			 struct pkcs11_object *key)
+{
+	const struct ec_curve *curve = NULL;
+
+	if (mech->tee_algo)
+		return mech->tee_algo;
+
+	/* ECDSA, the key has been checked when created */
+	curve = get_ec_curve(key->attributes);
+	assert(curve);
+
+	return curve->tee_algo;
+}
+
+static uint32_t tee_mode(const struct pkcs11_mechanism *mech,
+			 enum processing_func function)
+{
+	switch (function) {
+	case PKCS11_FUNCTION_ENCRYPT:
+		return TEE_MODE_ENCRYPT;
+	case PKCS11_FUNCTION_DECRYPT:
+		return TEE_MODE_DECRYPT;
+	case PKCS11_FUNCTION_DIGEST:
+		return TEE_MODE_DIGEST;
+	case PKCS11_FUNCTION_SIGN:
+		return is_mac(mech) ? TEE_MODE_MAC : TEE_MODE_SIGN;
+	case PKCS11_FUNCTION_VERIFY:
+		return is_mac(mech) ? TEE_MODE_MAC : TEE_MODE_VERIFY;
+	default:
+		TEE_Panic(function);
+		return 0;
+	}
+}
+
+/* Byte size of a signature of @mech with @key */
+static size_t signature_size(const struct pkcs11_mechanism *mech,
+			     struct pkcs11_object *key)
+{
+	switch (mech->key_type) {
+	case PKCS11_CKK_GENERIC_SECRET:
+		return TEE_SHA256_HASH_SIZE;
+	case PKCS11_CKK_RSA:
+		return ROUNDUP(key->key_size, 8) / 8;
+	case PKCS11_CKK_EC:
+		return 2 * (ROUNDUP(key->key_size, 8) / 8);
+	default:
+		return 0;
+	}
+}
+
+static enum pkcs11_rc check_key_function(struct pkcs11_object *key,
+					 const struct pkcs11_mechanism *mech,
+					 enum processing_func function)
+{
+	uint32_t usage = 0;
+
+	if (key->key_type != mech->key_type)
+		return PKCS11_CKR_KEY_TYPE_INCONSISTENT;
+
+	switch (function) {
+	case PKCS11_FUNCTION_ENCRYPT:
+		usage = PKCS11_CKA_ENCRYPT;
+		break;
+	case PKCS11_FUNCTION_DECRYPT:
+		usage = PKCS11_CKA_DECRYPT;
+		break;
+	case PKCS11_FUNCTION_SIGN:
+		if (key->class == PKCS11_CKO_PUBLIC_KEY)
+			return PKCS11_CKR_KEY_FUNCTION_NOT_PERMITTED;
+		usage = PKCS11_CKA_SIGN;
+		break;
+	case PKCS11_FUNCTION_VERIFY:
+		if (key->class == PKCS11_CKO_PRIVATE_KEY)
+			return PKCS11_CKR_KEY_FUNCTION_NOT_PERMITTED;
+		usage = PKCS11_CKA_VERIFY;
+		break;
+	default:
+		return PKCS11_CKR_GENERAL_ERROR;
+	}
+
+	if (!get_bool(key->attributes, usage))
+		return PKCS11_CKR_KEY_FUNCTION_NOT_PERMITTED;
+
+	return PKCS11_CKR_OK;
+}
+
+static void free_operation(struct pkcs11_operation *op)
+{
+	if (op->tee_op_handle != TEE_HANDLE_NULL)
+		TEE_FreeOperation(op->tee_op_handle);
+	if (op->tee_hash_op_handle != TEE_HANDLE_NULL)
+		TEE_FreeOperation(op->tee_hash_op_handle);
+
+	TEE_MemFill(op, 0, sizeof(*op));
+}
+
+/*
+ * Get an operation for @key, @mech and @function in @op. An operation
+ * kept by the session from a previous processing with the same key,
+ * mechanism and function is reused, it has its key already set.
+ */
+static enum pkcs11_rc get_operation(struct pkcs11_session *session,
+				    struct pkcs11_object *key,
+				    const struct pkcs11_mechanism *mech,
+				    enum processing_func function,
+				    struct pkcs11_operation *op)
+{
+	struct pkcs11_operation *cached = NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	unsigned int n = 0;
+
+	for (n = 0; n < session->op_cache_count; n++) {
+		cached = session->op_cache + n;
+		if (cached->key == key && cached->mecha_type == mech->id &&
+		    cached->function == function) {
+			*op = *cached;
+			session->op_cache_count--;
+			memmove(cached, cached + 1,
+				(session->op_cache_count - n) *
+				sizeof(*cached));
+			return PKCS11_CKR_OK;
+		}
+	}
+
+	TEE_MemFill(op, 0, sizeof(*op));
+	op->key = key;
+	op->mecha_type = mech->id;
+	op->function = function;
+
+	res = TEE_AllocateOperation(&op->tee_op_handle, tee_algo(mech, key),
+				    tee_mode(mech, function),
+				    key ? key->key_size : 0);
+	if (res)
+		goto err;
+
+	if (key) {
+		res = TEE_SetOperationKey(op->tee_op_handle, key->key_handle);
+		if (res)
+			goto err;
+	}
+
+	if (mech->tee_hash_algo) {
+		res = TEE_AllocateOperation(&op->tee_hash_op_handle,
+					    mech->tee_hash_algo,
+					    TEE_MODE_DIGEST, 0);
+		if (res)
+			goto err;
+	}
+
+	return PKCS11_CKR_OK;
+
+err:
+	free_operation(op);
+	if (res == TEE_ERROR_OUT_OF_MEMORY)
+		return PKCS11_CKR_DEVICE_MEMORY;
+	return PKCS11_CKR_MECHANISM_INVALID;
+}
+
+/* Keep @op in the session for reuse, dropping the least recently used */
+static void put_operation(struct pkcs11_session *session,
+			  struct pkcs11_operation *op)
+{
+	if (session->op_cache_count == PKCS11_SESSION_OP_CACHE_SIZE)
+		free_operation(session->op_cache + --session->op_cache_count);
+
+	memmove(session->op_cache + 1, session->op_cache,
+		session->op_cache_count * sizeof(*op));
+	session->op_cache[0] = *op;
+	session->op_cache_count++;
+
+	TEE_MemFill(op, 0, sizeof(*op));
+}
+
+void release_active_processing(struct pkcs11_session *session)
+{
+	if (!session->processing)
+		return;
+
+	put_operation(session, &session->processing->op);
+	TEE_Free(session->processing);
+	session->processing = NULL;
+}
+
+void release_operation_cache(struct pkcs11_session *session)
+{
+	while (session->op_cache_count)
+		free_operation(session->op_cache + --session->op_cache_count);
+}
+
+void release_key_operations(struct pkcs11_session *session, void *key)
+{
+	unsigned int n = 0;
+
+	if (session->processing && session->processing->op.key == key) {
+		free_operation(&session->processing->op);
+		TEE_Free(session->processing);
+		session->processing = NULL;
+	}
+
+	while (n < session->op_cache_count) {
+		if (session->op_cache[n].key == key) {
+			free_operation(session->op_cache + n);
+			session->op_cache_count--;
+			memmove(session->op_cache + n,
+				session->op_cache + n + 1,
+				(session->op_cache_count - n) *
+				sizeof(*session->op_cache));
+		} else {
+			n++;
+		}
+	}
+}
+
+/* (Re)start the TEE operation of a processing */
+static enum pkcs11_rc init_operation(struct pkcs11_operation *op,
+				     const struct pkcs11_mechanism *mech,
+				     void *params, uint32_t params_size)
+{
+	switch (op->function) {
+	case PKCS11_FUNCTION_ENCRYPT:
+	case PKCS11_FUNCTION_DECRYPT:
+		TEE_CipherInit(op->tee_op_handle, params, params_size);
+		break;
+	case PKCS11_FUNCTION_DIGEST:
+		TEE_ResetOperation(op->tee_op_handle);
+		break;
+	case PKCS11_FUNCTION_SIGN:
+	case PKCS11_FUNCTION_VERIFY:
+		if (is_mac(mech))
+			TEE_MACInit(op->tee_op_handle, NULL, 0);
+		if (op->tee_hash_op_handle != TEE_HANDLE_NULL)
+			TEE_ResetOperation(op->tee_hash_op_handle);
+		break;
+	default:
+		return PKCS11_CKR_GENERAL_ERROR;
+	}
+
+	return PKCS11_CKR_OK;
+}
+
+static enum pkcs11_rc check_mechanism_params(uint32_t mecha_id,
+					     uint32_t params_size)
+{
+	if (mecha_id == PKCS11_CKM_AES_CBC) {
+		if (params_size != TEE_AES_BLOCK_SIZE)
+			return PKCS11_CKR_MECHANISM_PARAM_INVALID;
+	} else if (params_size) {
+		return PKCS11_CKR_MECHANISM_PARAM_INVALID;
+	}
+
+	return PKCS11_CKR_OK;
+}
+
+static enum pkcs11_rc get_ctrl_session(struct pkcs11_client *client,
+				       struct serialargs *ctrlargs,
+				       struct pkcs11_session **session)
+{
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t session_handle = 0;
+
+	rc = serialargs_get_u32(ctrlargs, &session_handle);
+	if (rc)
+		return rc;
+
+	*session = pkcs11_handle2session(session_handle, client);
+	if (!*session)
+		return PKCS11_CKR_SESSION_HANDLE_INVALID;
+
+	return PKCS11_CKR_OK;
+}
+
+/* Get the key of a processing and check it can be used for @function */
+static enum pkcs11_rc get_ctrl_key(struct serialargs *ctrlargs,
+				   struct pkcs11_session *session,
+				   struct pkcs11_object **key)
+{
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t key_handle = 0;
+
+	rc = serialargs_get_u32(ctrlargs, &key_handle);
+	if (rc)
+		return rc;
+
+	*key = pkcs11_handle2object(key_handle, session);
+	if (!*key || (*key)->class == PKCS11_CKO_DATA)
+		return PKCS11_CKR_KEY_HANDLE_INVALID;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc entry_processing_init(struct pkcs11_client *client,
+				     TEE_Param *ctrl, TEE_Param *in,
+				     TEE_Param *out,
+				     enum processing_func function)
+{
+	const struct pkcs11_mechanism *mech = NULL;
+	struct active_processing *proc = NULL;
+	struct pkcs11_session *session = NULL;
+	struct pkcs11_object *key = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t params_size = 0;
+	uint32_t mecha_id = 0;
+	void *params = NULL;
+
+	if (!client || !ctrl || in || out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	if (function != PKCS11_FUNCTION_DIGEST) {
+		rc = get_ctrl_key(&ctrlargs, session, &key);
+		if (rc)
+			return rc;
+	}
+
+	rc = serialargs_get_mechanism(&ctrlargs, &mecha_id, &params,
+				      &params_size);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	if (session->processing)
+		return PKCS11_CKR_OPERATION_ACTIVE;
+
+	mech = get_mechanism(mecha_id);
+	if (!mech || !(mech->funcs & BIT(function)))
+		return PKCS11_CKR_MECHANISM_INVALID;
+
+	rc = check_mechanism_params(mecha_id, params_size);
+	if (rc)
+		return rc;
+
+	if (key) {
+		rc = check_key_function(key, mech, function);
+		if (rc)
+			return rc;
+	}
+
+	proc = TEE_Malloc(sizeof(*proc), TEE_MALLOC_FILL_ZERO);
+	if (!proc)
+		return PKCS11_CKR_DEVICE_MEMORY;
+
+	rc = get_operation(session, key, mech, function, &proc->op);
+	if (rc) {
+		TEE_Free(proc);
+		return rc;
+	}
+
+	rc = init_operation(&proc->op, mech, params, params_size);
+	if (rc) {
+		put_operation(session, &proc->op);
+		TEE_Free(proc);
+		return rc;
+	}
+
+	session->processing = proc;
+
+	return PKCS11_CKR_OK;
+}
+
+static enum pkcs11_rc tee2pkcs_short_buffer(TEE_Result res)
+{
+	if (res == TEE_ERROR_SHORT_BUFFER)
+		return PKCS11_CKR_BUFFER_TOO_SMALL;
+	if (res)
+		return PKCS11_CKR_GENERAL_ERROR;
+	return PKCS11_CKR_OK;
+}
+
+static enum pkcs11_rc step_update(struct active_processing *proc,
+				  const struct pkcs11_mechanism *mech,
+				  void *in_buf, uint32_t in_size,
+				  TEE_Param *out)
+{
+	TEE_OperationHandle op = proc->op.tee_op_handle;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	uint32_t out_size = 0;
+
+	switch (proc->op.function) {
+	case PKCS11_FUNCTION_ENCRYPT:
+	case PKCS11_FUNCTION_DECRYPT:
+		if (!out)
+			return PKCS11_CKR_ARGUMENTS_BAD;
+		out_size = out->memref.size;
+		res = TEE_CipherUpdate(op, in_buf, in_size, out->memref.buffer,
+				       &out_size);
+		out->memref.size = out_size;
+		return tee2pkcs_short_buffer(res);
+	case PKCS11_FUNCTION_DIGEST:
+		TEE_DigestUpdate(op, in_buf, in_size);
+		return PKCS11_CKR_OK;
+	case PKCS11_FUNCTION_SIGN:
+	case PKCS11_FUNCTION_VERIFY:
+		if (is_mac(mech)) {
+			TEE_MACUpdate(op, in_buf, in_size);
+			return PKCS11_CKR_OK;
+		}
+		/* PKCS11_CKM_ECDSA is a single part mechanism */
+		if (proc->op.tee_hash_op_handle == TEE_HANDLE_NULL)
+			return PKCS11_CKR_FUNCTION_NOT_SUPPORTED;
+		TEE_DigestUpdate(proc->op.tee_hash_op_handle, in_buf, in_size);
+		return PKCS11_CKR_OK;
+	default:
+		return PKCS11_CKR_GENERAL_ERROR;
+	}
+}
+
+/*
+ * Get the digest to sign or verify, from the data hashed so far and
+ * @in_buf or from @in_buf being the digest for ECDSA
+ */
+static enum pkcs11_rc get_digest(struct active_processing *proc,
+				 const struct pkcs11_mechanism *mech,
+				 void *in_buf, uint32_t in_size,
+				 uint8_t *digest, uint32_t *digest_size)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	if (proc->op.tee_hash_op_handle == TEE_HANDLE_NULL) {
+		if (proc->updated || !in_size ||
+		    in_size > ECDSA_MAX_DIGEST_SIZE)
+			return PKCS11_CKR_DATA_LEN_RANGE;
+		TEE_MemMove(digest, in_buf, in_size);
+		*digest_size = in_size;
+		return PKCS11_CKR_OK;
+	}
+
+	*digest_size = mech->digest_size;
+	res = TEE_DigestDoFinal(proc->op.tee_hash_op_handle, in_buf, in_size,
+				digest, digest_size);
+	if (res)
+		return PKCS11_CKR_GENERAL_ERROR;
+
+	return PKCS11_CKR_OK;
+}
+
+static enum pkcs11_rc step_sign(struct active_processing *proc,
+				const struct pkcs11_mechanism *mech,
+				void *in_buf, uint32_t in_size,
+				TEE_Param *out)
+{
+	size_t sig_size = signature_size(mech, proc->op.key);
+	TEE_OperationHandle op = proc->op.tee_op_handle;
+	uint8_t digest[TEE_MAX_HASH_SIZE] = { };
+	TEE_Result res = TEE_ERROR_GENERIC;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t digest_size = 0;
+	uint32_t out_size = 0;
+
+	if (!out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	/* Check the size first, the operation can't be resumed after */
+	out_size = out->memref.size;
+	out->memref.size = sig_size;
+	if (out_size < sig_size)
+		return PKCS11_CKR_BUFFER_TOO_SMALL;
+
+	if (is_mac(mech)) {
+		res = TEE_MACComputeFinal(op, in_buf, in_size,
+					  out->memref.buffer, &out_size);
+	} else {
+		rc = get_digest(proc, mech, in_buf, in_size, digest,
+				&digest_size);
+		if (rc)
+			return rc;
+		res = TEE_AsymmetricSignDigest(op, NULL, 0, digest,
+					       digest_size, out->memref.buffer,
+					       &out_size);
+	}
+	if (res)
+		return PKCS11_CKR_GENERAL_ERROR;
+
+	out->memref.size = out_size;
+
+	return PKCS11_CKR_OK;
+}
+
+static enum pkcs11_rc step_verify(struct active_processing *proc,
+				  const struct pkcs11_mechanism *mech,
+				  void *in_buf, uint32_t in_size,
+				  TEE_Param *sig)
+{
+	TEE_OperationHandle op = proc->op.tee_op_handle;
+	uint8_t digest[TEE_MAX_HASH_SIZE] = { };
+	TEE_Result res = TEE_ERROR_GENERIC;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t digest_size = 0;
+
+	if (!sig)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	if (sig->memref.size != signature_size(mech, proc->op.key))
+		return PKCS11_CKR_SIGNATURE_LEN_RANGE;
+
+	if (is_mac(mech)) {
+		res = TEE_MACCompareFinal(op, in_buf, in_size,
+					  sig->memref.buffer,
+					  sig->memref.size);
+	} else {
+		rc = get_digest(proc, mech, in_buf, in_size, digest,
+				&digest_size);
+		if (rc)
+			return rc;
+		res = TEE_AsymmetricVerifyDigest(op, NULL, 0, digest,
+						 digest_size,
+						 sig->memref.buffer,
+						 sig->memref.size);
+	}
+
+	if (res == TEE_ERROR_MAC_INVALID || res == TEE_ERROR_SIGNATURE_INVALID)
+		return PKCS11_CKR_SIGNATURE_INVALID;
+	if (res)
+		return PKCS11_CKR_GENERAL_ERROR;
+
+	return PKCS11_CKR_OK;
+}
+
+/* Final step, with the last input data for a one-shot processing */
+static enum pkcs11_rc step_final(struct active_processing *proc,
+				 const struct pkcs11_mechanism *mech,
+				 void *in_buf, uint32_t in_size,
+				 TEE_Param *in2, TEE_Param *out)
+{
+	TEE_OperationHandle op = proc->op.tee_op_handle;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	uint32_t out_size = 0;
+
+	switch (proc->op.function) {
+	case PKCS11_FUNCTION_ENCRYPT:
+	case PKCS11_FUNCTION_DECRYPT:
+		if (!out)
+			return PKCS11_CKR_ARGUMENTS_BAD;
+		/* No padding, the operation can't be given partial blocks */
+		if ((proc->in_size + in_size) % TEE_AES_BLOCK_SIZE) {
+			if (proc->op.function == PKCS11_FUNCTION_ENCRYPT)
+				return PKCS11_CKR_DATA_LEN_RANGE;
+			return PKCS11_CKR_ENCRYPTED_DATA_LEN_RANGE;
+		}
+		out_size = out->memref.size;
+		res = TEE_CipherDoFinal(op, in_buf, in_size,
+					out->memref.buffer, &out_size);
+		out->memref.size = out_size;
+		return tee2pkcs_short_buffer(res);
+	case PKCS11_FUNCTION_DIGEST:
+		if (!out)
+			return PKCS11_CKR_ARGUMENTS_BAD;
+		out_size = out->memref.size;
+		res = TEE_DigestDoFinal(op, in_buf, in_size,
+					out->memref.buffer, &out_size);
+		out->memref.size = out_size;
+		return tee2pkcs_short_buffer(res);
+	case PKCS11_FUNCTION_SIGN:
+		return step_sign(proc, mech, in_buf, in_size, out);
+	case PKCS11_FUNCTION_VERIFY:
+		return step_verify(proc, mech, in_buf, in_size, in2);
+	default:
+		return PKCS11_CKR_GENERAL_ERROR;
+	}
+}
+
+enum pkcs11_rc entry_processing_step(struct pkcs11_client *client,
+				     TEE_Param *ctrl, TEE_Param *in,
+				     TEE_Param *in2, TEE_Param *out,
+				     enum processing_func function,
+				     enum processing_step step)
+{
+	const struct pkcs11_mechanism *mech = NULL;
+	struct active_processing *proc = NULL;
+	struct pkcs11_session *session = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	uint32_t in_size = 0;
+	void *in_buf = NULL;
+
+	if (!client || !ctrl)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	/* Only verification takes its signature in param#2 */
+	if (in2 && function != PKCS11_FUNCTION_VERIFY)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	proc = session->processing;
+	if (!proc || proc->op.function != function)
+		return PKCS11_CKR_OPERATION_NOT_INITIALIZED;
+
+	if (step == PKCS11_FUNC_STEP_ONESHOT && proc->updated)
+		return PKCS11_CKR_OPERATION_ACTIVE;
+
+	if (in) {
+		in_buf = in->memref.buffer;
+		in_size = in->memref.size;
+	}
+
+	mech = get_mechanism(proc->op.mecha_type);
+	assert(mech);
+
+	if (step == PKCS11_FUNC_STEP_UPDATE) {
+		rc = step_update(proc, mech, in_buf, in_size, out);
+		if (rc == PKCS11_CKR_OK) {
+			proc->updated = true;
+			proc->in_size += in_size;
+		}
+	} else {
+		rc = step_final(proc, mech, in_buf, in_size, in2, out);
+	}
+
+	/* A too small output buffer doesn't terminate the processing */
+	if (rc == PKCS11_CKR_BUFFER_TOO_SMALL ||
+	    (rc == PKCS11_CKR_OK && step == PKCS11_FUNC_STEP_UPDATE))
+		return rc;
+
+	release_active_processing(session);
+
+	return rc;
+}
+
+enum pkcs11_rc entry_sign_digests(struct pkcs11_client *client,
+				  TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out)
+{
+	const struct pkcs11_mechanism *mech = NULL;
+	struct pkcs11_operation op = { };
+	struct pkcs11_session *session = NULL;
+	struct pkcs11_object *key = NULL;
+	struct serialargs ctrlargs = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	uint32_t params_size = 0;
+	size_t digest_size = 0;
+	uint32_t mecha_id = 0;
+	size_t sig_size = 0;
+	uint32_t count = 0;
+	uint32_t size = 0;
+	size_t out_size = 0;
+	void *params = NULL;
+	uint8_t *digest = NULL;
+	uint8_t *sig = NULL;
+	uint32_t n = 0;
+
+	if (!client || !ctrl || !in || !out)
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	serialargs_init(&ctrlargs, ctrl->memref.buffer, ctrl->memref.size);
+
+	rc = get_ctrl_session(client, &ctrlargs, &session);
+	if (rc)
+		return rc;
+
+	rc = get_ctrl_key(&ctrlargs, session, &key);
+	if (rc)
+		return rc;
+
+	rc = serialargs_get_u32(&ctrlargs, &count);
+	if (rc)
+		return rc;
+
+	rc = serialargs_get_mechanism(&ctrlargs, &mecha_id, &params,
+				      &params_size);
+	if (rc)
+		return rc;
+
+	if (serialargs_remaining_bytes(&ctrlargs))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	if (session->processing)
+		return PKCS11_CKR_OPERATION_ACTIVE;
+
+	mech = get_mechanism(mecha_id);
+	if (!mech || !(mech->funcs & FUNC_BIT(SIGN)) || is_mac(mech))
+		return PKCS11_CKR_MECHANISM_INVALID;
+
+	rc = check_mechanism_params(mecha_id, params_size);
+	if (rc)
+		return rc;
+
+	rc = check_key_function(key, mech, PKCS11_FUNCTION_SIGN);
+	if (rc)
+		return rc;
+
+	if (!count || in->memref.size % count)
+		return PKCS11_CKR_DATA_LEN_RANGE;
+
+	digest_size = in->memref.size / count;
+	if (mech->digest_size ? digest_size != mech->digest_size :
+				digest_size > ECDSA_MAX_DIGEST_SIZE)
+		return PKCS11_CKR_DATA_LEN_RANGE;
+
+	sig_size = signature_size(mech, key);
+	if (MUL_OVERFLOW(sig_size, count, &out_size))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+	if (out->memref.size < out_size) {
+		out->memref.size = out_size;
+		return PKCS11_CKR_BUFFER_TOO_SMALL;
+	}
+
+	rc = get_operation(session, key, mech, PKCS11_FUNCTION_SIGN, &op);
+	if (rc)
+		return rc;
+
+	digest = in->memref.buffer;
+	sig = out->memref.buffer;
+	for (n = 0; n < count; n++) {
+		size = sig_size;
+		res = TEE_AsymmetricSignDigest(op.tee_op_handle, NULL, 0,
+					       digest, digest_size, sig, &size);
+		if (res || size != sig_size) {
+			rc = PKCS11_CKR_GENERAL_ERROR;
+			break;
+		}
+		digest += digest_size;
+		sig += sig_size;
+	}
+
+	put_operation(session, &op);
+
+	if (!rc)
+		out->memref.size = out_size;
+
+	return rc;
+}
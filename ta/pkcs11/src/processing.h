@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#ifndef PKCS11_TA_PROCESSING_H
+#define PKCS11_TA_PROCESSING_H
+
+#include <pkcs11_ta.h>
+#include <tee_internal_api.h>
+
+#include "pkcs11_token.h"
+
+struct pkcs11_client;
+struct pkcs11_object;
+struct pkcs11_session;
+
+/*
+ * get_supported_mechanisms() - Get the supported mechanism IDs
+ * @ids:	Output array of mechanism IDs or NULL
+ * @count:	Number of IDs @ids can hold
+ *
+ * Returns the number of supported mechanisms
+ */
+size_t get_supported_mechanisms(uint32_t *ids, size_t count);
+
+/* Set up and release the TEE object holding the key of a key object */
+enum pkcs11_rc load_tee_key(struct pkcs11_object *obj);
+void release_tee_key(struct pkcs11_object *obj);
+
+/* Release the active processing of a session if any */
+void release_active_processing(struct pkcs11_session *session);
+
+/* Free the operations a session keeps for reuse */
+void release_operation_cache(struct pkcs11_session *session);
+
+/*
+ * Release the operations of @session using key object @key, including
+ * the active processing. Called for each session when a key is destroyed.
+ */
+void release_key_operations(struct pkcs11_session *session, void *key);
+
+/*
+ * Entry points from PKCS11 TA invocation commands
+ */
+enum pkcs11_rc entry_processing_init(struct pkcs11_client *client,
+				     TEE_Param *ctrl, TEE_Param *in,
+				     TEE_Param *out,
+				     enum processing_func function);
+
+enum pkcs11_rc entry_processing_step(struct pkcs11_client *client,
+				     TEE_Param *ctrl, TEE_Param *in,
+				     TEE_Param *in2, TEE_Param *out,
+				     enum processing_func function,
+				     enum processing_step step);
+
+enum pkcs11_rc entry_sign_digests(struct pkcs11_client *client,
+				  TEE_Param *ctrl, TEE_Param *in,
+				  TEE_Param *out);
+
+#endif /*PKCS11_TA_PROCESSING_H*/
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#include <pkcs11_ta.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tee_internal_api.h>
+#include <trace.h>
+#include <util.h>
+
+#include "serializer.h"
+
+/*
+ * Util routines for serializes unformated arguments in a client memref
+ */
+void serialargs_init(struct serialargs *args, void *in, size_t size)
+{
+	args->start = in;
+	args->next = in;
+	args->size = size;
+}
+
+enum pkcs11_rc serialargs_get(struct serialargs *args, void *out, size_t size)
+{
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	void *src = NULL;
+
+	rc = serialargs_get_ptr(args, &src, size);
+	if (!rc)
+		TEE_MemMove(out, src, size);
+
+	return rc;
+}
+
+enum pkcs11_rc serialargs_get_ptr(struct serialargs *args, void **out,
+				  size_t size)
+{
+	void *ptr = args->next;
+	vaddr_t next_end = 0;
+
+	if (ADD_OVERFLOW((vaddr_t)args->next, size, &next_end))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	if (!size) {
+		*out = NULL;
+		return PKCS11_CKR_OK;
+	}
+
+	if ((char *)next_end > args->start + args->size) {
+		EMSG("arg too short: full %zd, remain %zd, expect %zd",
+		     args->size, args->size - (args->next - args->start), size);
+		return PKCS11_CKR_ARGUMENTS_BAD;
+	}
+
+	args->next += size;
+	*out = ptr;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc
+serialargs_alloc_get_attributes(struct serialargs *args,
+				struct pkcs11_object_head **out)
+{
+	struct pkcs11_object_head attr = { };
+	struct pkcs11_object_head *pattr = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	size_t attr_size = 0;
+	void *data = NULL;
+
+	rc = serialargs_get(args, &attr, sizeof(attr));
+	if (rc)
+		return rc;
+
+	if (ADD_OVERFLOW(sizeof(attr), attr.attrs_size, &attr_size))
+		return PKCS11_CKR_ARGUMENTS_BAD;
+
+	rc = serialargs_get_ptr(args, &data, attr.attrs_size);
+	if (rc)
+		return rc;
+
+	pattr = TEE_Malloc(attr_size, TEE_MALLOC_FILL_ZERO);
+	if (!pattr)
+		return PKCS11_CKR_DEVICE_MEMORY;
+
+	TEE_MemMove(pattr, &attr, sizeof(attr));
+	if (attr.attrs_size)
+		TEE_MemMove(pattr->attrs, data, attr.attrs_size);
+
+	*out = pattr;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc serialargs_get_mechanism(struct serialargs *args,
+					uint32_t *mecha_id, void **params,
+					uint32_t *params_size)
+{
+	struct pkcs11_attribute_head head = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	rc = serialargs_get(args, &head, sizeof(head));
+	if (rc)
+		return rc;
+
+	rc = serialargs_get_ptr(args, params, head.size);
+	if (rc)
+		return rc;
+
+	*mecha_id = head.id;
+	*params_size = head.size;
+
+	return PKCS11_CKR_OK;
+}
+
+bool serialargs_remaining_bytes(struct serialargs *args)
+{
+	return args->next < args->start + args->size;
+}
@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2017-2020, Linaro Limited
+ */
+
+#ifndef PKCS11_TA_SERIALIZER_H
+#define PKCS11_TA_SERIALIZER_H
+
+#include <pkcs11_ta.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct pkcs11_object_head;
+
+/*
+ * Util routines for serializes unformated arguments in a client memref
+ */
+struct serialargs {
+	char *start;
+	char *next;
+	size_t size;
+};
+
+void serialargs_init(struct serialargs *args, void *in, size_t size);
+
+/*
+ * serialargs_get() - copy out a chunk of data and advance
+ * @args:	serialargs state
+ * @out:	output buffer
+ * @sz:		number of bytes to copy to @out
+ *
+ * Returns PKCS11_CKR_OK on success or a pkcs11_rc status.
+ */
+enum pkcs11_rc serialargs_get(struct serialargs *args, void *out, size_t sz);
+
+static inline enum pkcs11_rc serialargs_get_u32(struct serialargs *args,
+						uint32_t *out)
+{
+	return serialargs_get(args, out, sizeof(*out));
+}
+
+/*
+ * serialargs_get_ptr() - get a pointer to a chunk of data and advance
+ * @args:	serialargs state
+ * @out:	Pointer to the data retrieved in *@out
+ * @size:	Number of bytes to advance
+ *
+ * Returns PKCS11_CKR_OK on success or a pkcs11_rc status.
+ */
+enum pkcs11_rc serialargs_get_ptr(struct serialargs *args, void **out,
+				  size_t size);
+
+/*
+ * serialargs_alloc_get_attributes() - copy out a serialized object
+ * @args:	serialargs state
+ * @out:	Allocated copy of the object head and attributes in *@out
+ *
+ * Returns PKCS11_CKR_OK on success or a pkcs11_rc status.
+ */
+enum pkcs11_rc
+serialargs_alloc_get_attributes(struct serialargs *args,
+				struct pkcs11_object_head **out);
+
+/*
+ * serialargs_get_mechanism() - get a reference to a serialized mechanism
+ * @args:	serialargs state
+ * @mecha_id:	Mechanism ID in *@mecha_id
+ * @params:	Pointer to the mechanism parameters in *@params
+ * @params_size: Byte size of the mechanism parameters in *@params_size
+ *
+ * Returns PKCS11_CKR_OK on success or a pkcs11_rc status.
+ */
+enum pkcs11_rc serialargs_get_mechanism(struct serialargs *args,
+					uint32_t *mecha_id, void **params,
+					uint32_t *params_size);
+
+bool serialargs_remaining_bytes(struct serialargs *args);
+
+#endif /*PKCS11_TA_SERIALIZER_H*/
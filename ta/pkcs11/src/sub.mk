@@ -1 +1,7 @@
+srcs-y += attributes.c
 srcs-y += entry.c
+srcs-y += handle.c
+srcs-y += object.c
+srcs-y += pkcs11_token.c
+srcs-y += processing.c
+srcs-y += serializer.c
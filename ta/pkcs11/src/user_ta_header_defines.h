@@ -15,6 +15,6 @@
 					 TA_FLAG_INSTANCE_KEEP_ALIVE)
 
 #define TA_STACK_SIZE			(4 * 1024)
-#define TA_DATA_SIZE			(16 * 1024)
+#define TA_DATA_SIZE			(32 * 1024)
 
 #endif /*USER_TA_HEADER_DEFINES_H*/